@@ -8,6 +8,7 @@ package com.intel.qat.jmh;
 
 import java.io.File;
 import java.util.Collection;
+import org.openjdk.jmh.infra.BenchmarkParams;
 import org.openjdk.jmh.results.Result;
 import org.openjdk.jmh.results.RunResult;
 import org.openjdk.jmh.runner.Runner;
@@ -36,8 +37,13 @@ public class BenchmarkDriver {
       for (RunResult rr : results) {
         Result r = rr.getPrimaryResult();
         if (r.getScoreUnit().equals("ops/s")) {
-          double speed = r.getScore() * fileSize / (1024 * 1024);
-          System.out.printf("%-54s%.2f MB/sec%n", rr.getParams().getBenchmark(), speed);
+          BenchmarkParams params = rr.getParams();
+          // Benchmarks with a size parameter run on a payload of that size instead of the file.
+          String size = params.getParam("size");
+          long payloadSize =
+              size == null || Integer.parseInt(size) == 0 ? fileSize : Integer.parseInt(size);
+          double speed = r.getScore() * payloadSize / (1024 * 1024);
+          System.out.printf("%-54s%s%.2f MB/sec%n", params.getBenchmark(), describe(params), speed);
         }
       }
     } catch (RunnerException e) {
@@ -46,4 +52,14 @@ public class BenchmarkDriver {
       System.err.printf("%s: %s", "Error parsing command line", e.getMessage());
     }
   }
+
+  /** Returns the thread count and the parameters of a run other than the file. */
+  private static String describe(BenchmarkParams params) {
+    StringBuilder sb = new StringBuilder();
+    sb.append("threads=").append(params.getThreads()).append(' ');
+    for (String key : params.getParamsKeys()) {
+      if (!key.equals("file")) sb.append(key).append('=').append(params.getParam(key)).append(' ');
+    }
+    return sb.toString();
+  }
 }
@@ -6,8 +6,6 @@
 
 package com.intel.qat.jmh;
 
-import java.nio.file.Files;
-import java.nio.file.Paths;
 import java.util.concurrent.atomic.AtomicBoolean;
 import java.util.zip.Deflater;
 import java.util.zip.Inflater;
@@ -23,6 +21,9 @@ public class JavaUtilZipBench {
   @Param({""})
   static String file;
 
+  @Param({"0"})
+  static int size;
+
   @Param({"6"})
   static int level;
 
@@ -40,7 +41,7 @@ public class JavaUtilZipBench {
         Inflater inflater = new Inflater();
 
         // Read input
-        src = Files.readAllBytes(Paths.get(file));
+        src = Payload.read(file, size);
 
         decompressed = new byte[src.length];
         dst = new byte[src.length];
@@ -7,8 +7,6 @@
 package com.intel.qat.jmh;
 
 import java.io.IOException;
-import java.nio.file.Files;
-import java.nio.file.Paths;
 import java.util.concurrent.atomic.AtomicBoolean;
 import net.jpountz.lz4.LZ4Compressor;
 import net.jpountz.lz4.LZ4Decompressor;
@@ -25,6 +23,9 @@ public class Lz4JavaBench {
   @Param({""})
   static String file;
 
+  @Param({"0"})
+  static int size;
+
   @State(Scope.Thread)
   public static class ThreadState {
     byte[] src;
@@ -38,7 +39,7 @@ public class Lz4JavaBench {
         LZ4Compressor compressor = LZ4Factory.fastestInstance().fastCompressor();
 
         // Read input
-        src = Files.readAllBytes(Paths.get(file));
+        src = Payload.read(file, size);
 
         decompressed = new byte[src.length];
         dst = new byte[compressor.maxCompressedLength(src.length)];
@@ -0,0 +1,37 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat.jmh;
+
+import java.io.IOException;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+
+/** Builds the benchmark input from a file. */
+final class Payload {
+  private Payload() {}
+
+  /**
+   * Reads the file into an array of the given size, repeating the file contents if the file is
+   * smaller than that and truncating them if it is larger.
+   *
+   * @param file the path to the file
+   * @param size the size of the array, or 0 for the size of the file
+   * @return the payload
+   * @throws IOException if an I/O error occurs
+   */
+  static byte[] read(String file, int size) throws IOException {
+    byte[] contents = Files.readAllBytes(Paths.get(file));
+    if (size == 0) return contents;
+    if (size < 0) throw new IllegalArgumentException("Negative payload size.");
+    if (contents.length == 0) throw new IllegalArgumentException("Empty payload file.");
+
+    byte[] payload = new byte[size];
+    for (int pos = 0; pos < size; pos += contents.length)
+      System.arraycopy(contents, 0, payload, pos, Math.min(contents.length, size - pos));
+    return payload;
+  }
+}
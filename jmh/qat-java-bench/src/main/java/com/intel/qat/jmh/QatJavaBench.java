@@ -8,6 +8,7 @@ package com.intel.qat.jmh;
 
 import com.intel.qat.QatZipper;
 import com.intel.qat.QatZipper.Algorithm;
+import com.intel.qat.QatZipper.PollingMode;
 import java.io.IOException;
 import java.nio.file.Files;
 import java.nio.file.Paths;
@@ -79,4 +80,20 @@ public class QatJavaBench {
     qzip.decompress(state.compressed, state.decompressed);
     qzip.end();
   }
+
+  @Benchmark
+  public void compressWithDeflatePooled(ThreadState state) {
+    QatZipper qzip =
+        QatZipper.fromPool(Algorithm.DEFLATE, level, QatZipper.DEFAULT_MODE, PollingMode.BUSY);
+    qzip.compress(state.src, state.dst);
+    qzip.end();
+  }
+
+  @Benchmark
+  public void decompressWithDeflatePooled(ThreadState state) {
+    QatZipper qzip =
+        QatZipper.fromPool(Algorithm.DEFLATE, level, QatZipper.DEFAULT_MODE, PollingMode.BUSY);
+    qzip.decompress(state.compressed, state.decompressed);
+    qzip.end();
+  }
 }
@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat.jmh;
+
+import com.intel.qat.QatZipper;
+import com.intel.qat.QatZipper.Algorithm;
+import java.io.IOException;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+
+/**
+ * Compresses one input with an LZ4 and a DEFLATE zipper, either one after the other or with a
+ * single {@link QatZipper#compressAll} call that runs both sessions concurrently.
+ */
+@State(Scope.Benchmark)
+public class QatJavaCompressAllBench {
+  @Param({""})
+  static String file;
+
+  @Param({"6"})
+  static int level;
+
+  @State(Scope.Thread)
+  public static class ThreadState {
+    QatZipper[] zippers;
+    byte[] src;
+    byte[][] dsts;
+
+    @Setup(Level.Trial)
+    public void setup() throws IOException {
+      src = Files.readAllBytes(Paths.get(file));
+      zippers =
+          new QatZipper[] {new QatZipper(Algorithm.LZ4), new QatZipper(Algorithm.DEFLATE, level)};
+      dsts = new byte[zippers.length][];
+      for (int i = 0; i < zippers.length; i++)
+        dsts[i] = new byte[zippers[i].maxCompressedLength(src.length)];
+    }
+
+    @TearDown(Level.Trial)
+    public void teardown() {
+      for (QatZipper qzip : zippers) qzip.end();
+    }
+  }
+
+  @Benchmark
+  public int compressSequential(ThreadState state) {
+    int size = 0;
+    for (int i = 0; i < state.zippers.length; i++)
+      size += state.zippers[i].compress(state.src, state.dsts[i]);
+    return size;
+  }
+
+  @Benchmark
+  public int[] compressAll(ThreadState state) {
+    return QatZipper.compressAll(state.zippers, state.src, state.dsts);
+  }
+}
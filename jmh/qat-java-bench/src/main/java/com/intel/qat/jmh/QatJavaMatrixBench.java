@@ -0,0 +1,145 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat.jmh;
+
+import com.intel.qat.QatZipper;
+import com.intel.qat.QatZipper.Algorithm;
+import com.intel.qat.QatZipper.Mode;
+import com.intel.qat.QatZipper.PollingMode;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+
+/**
+ * Measures the data path of QatZipper over a matrix of payload sizes, buffer types, session reuse,
+ * modes and polling modes. Thread counts are set with the JMH -t option. The payload is built from
+ * the file by {@link Payload}, so that results line up with the JavaUtilZipBench, Lz4JavaBench and
+ * ZstdJniBench runs that use the same size.
+ */
+@State(Scope.Benchmark)
+public class QatJavaMatrixBench {
+  /** The source and destination buffer types; each selects a different native path. */
+  public enum Buffers {
+    /** Heap source and destination. */
+    HEAP,
+    /** Direct source and destination. */
+    DIRECT,
+    /** Direct source, heap destination. */
+    DIRECT_SRC,
+    /** Heap source, direct destination. */
+    DIRECT_DST
+  }
+
+  /** Whether a zipper is created once per thread or for every operation. */
+  public enum Session {
+    REUSED,
+    PER_CALL
+  }
+
+  @Param({""})
+  static String file;
+
+  @Param({"512", "4096", "65536", "1048576", "67108864"})
+  static int size;
+
+  @Param({"DEFLATE"})
+  static Algorithm algorithm;
+
+  @Param({"6"})
+  static int level;
+
+  @Param({"HEAP", "DIRECT", "DIRECT_SRC", "DIRECT_DST"})
+  static Buffers buffers;
+
+  @Param({"REUSED", "PER_CALL"})
+  static Session session;
+
+  @Param({"AUTO"})
+  static Mode mode;
+
+  @Param({"BUSY"})
+  static PollingMode pmode;
+
+  @State(Scope.Thread)
+  public static class ThreadState {
+    QatZipper qzip;
+    ByteBuffer src;
+    ByteBuffer dst;
+    ByteBuffer compressed;
+    ByteBuffer decompressed;
+
+    @Setup(Level.Trial)
+    public void setup() throws IOException {
+      byte[] payload = Payload.read(file, size);
+      qzip = newZipper();
+
+      boolean directSrc = buffers == Buffers.DIRECT || buffers == Buffers.DIRECT_SRC;
+      boolean directDst = buffers == Buffers.DIRECT || buffers == Buffers.DIRECT_DST;
+      int maxCompressed = qzip.maxCompressedLength(payload.length);
+      src = allocate(payload.length, directSrc);
+      src.put(payload).flip();
+      dst = allocate(maxCompressed, directDst);
+      decompressed = allocate(payload.length, directDst);
+
+      // Decompression reads the compressed data from a buffer of the source type.
+      qzip.compress(src, dst);
+      dst.flip();
+      compressed = allocate(dst.remaining(), directSrc);
+      compressed.put(dst).flip();
+      src.rewind();
+      dst.clear();
+    }
+
+    @TearDown(Level.Trial)
+    public void teardown() {
+      qzip.end();
+    }
+
+    private static ByteBuffer allocate(int capacity, boolean direct) {
+      return direct ? ByteBuffer.allocateDirect(capacity) : ByteBuffer.allocate(capacity);
+    }
+  }
+
+  private static QatZipper newZipper() {
+    return new QatZipper(algorithm, level, mode, pmode);
+  }
+
+  @Benchmark
+  public int compress(ThreadState state) {
+    state.src.rewind();
+    state.dst.clear();
+    if (session == Session.REUSED) return state.qzip.compress(state.src, state.dst);
+
+    QatZipper qzip = newZipper();
+    try {
+      return qzip.compress(state.src, state.dst);
+    } finally {
+      qzip.end();
+    }
+  }
+
+  @Benchmark
+  public int decompress(ThreadState state) {
+    state.compressed.rewind();
+    state.decompressed.clear();
+    if (session == Session.REUSED)
+      return state.qzip.decompress(state.compressed, state.decompressed);
+
+    QatZipper qzip = newZipper();
+    try {
+      return qzip.decompress(state.compressed, state.decompressed);
+    } finally {
+      qzip.end();
+    }
+  }
+}
@@ -0,0 +1,83 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat.jmh;
+
+import com.intel.qat.QatZipper;
+import com.intel.qat.QatZipper.Algorithm;
+import java.io.IOException;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.concurrent.atomic.AtomicBoolean;
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+
+/** Zstandard with QAT match finding, to compare with {@link ZstdJniBench}. */
+@State(Scope.Benchmark)
+public class QatJavaZstdBench {
+  private static AtomicBoolean flag = new AtomicBoolean(false);
+
+  @Param({""})
+  static String file;
+
+  @Param({"6"})
+  static int level;
+
+  @State(Scope.Thread)
+  public static class ThreadState {
+    QatZipper qzip;
+    byte[] src;
+    byte[] dst;
+    byte[] compressed;
+    byte[] decompressed;
+
+    public ThreadState() {
+      try {
+        // Each thread keeps its own session, as each zstd-jni call has its own context
+        qzip = new QatZipper(Algorithm.ZSTD, level);
+
+        // Read input
+        src = Files.readAllBytes(Paths.get(file));
+
+        decompressed = new byte[src.length];
+        dst = new byte[qzip.maxCompressedLength(src.length)];
+
+        // Compress input
+        int compressedLength = qzip.compress(src, dst);
+
+        // Prepare compressed array of size EXACTLY compressedLength
+        compressed = new byte[compressedLength];
+        System.arraycopy(dst, 0, compressed, 0, compressedLength);
+
+        if (flag.compareAndSet(false, true)) {
+          System.out.println("\n------------------------");
+          System.out.printf("Compression ratio: %.2f%n", (double) src.length / compressed.length);
+          System.out.println("------------------------");
+        }
+      } catch (IOException e) {
+        e.printStackTrace();
+      }
+    }
+
+    @TearDown
+    public void end() {
+      qzip.end();
+    }
+  }
+
+  @Benchmark
+  public void compress(ThreadState state) {
+    state.qzip.compress(state.src, state.dst);
+  }
+
+  @Benchmark
+  public void decompress(ThreadState state) {
+    state.qzip.decompress(state.compressed, state.decompressed);
+  }
+}
@@ -8,8 +8,6 @@ package com.intel.qat.jmh;
 
 import com.github.luben.zstd.Zstd;
 import java.io.IOException;
-import java.nio.file.Files;
-import java.nio.file.Paths;
 import java.util.concurrent.atomic.AtomicBoolean;
 import org.openjdk.jmh.annotations.Benchmark;
 import org.openjdk.jmh.annotations.Param;
@@ -23,6 +21,9 @@ public class ZstdJniBench {
   @Param({""})
   static String file;
 
+  @Param({"0"})
+  static int size;
+
   @Param({"6"})
   static int level;
 
@@ -35,7 +36,7 @@ public class ZstdJniBench {
     public ThreadState() {
       try {
         // Read input
-        src = Files.readAllBytes(Paths.get(file));
+        src = Payload.read(file, size);
 
         // Compress input
         compressed = Zstd.compress(src, level);
@@ -17,14 +17,28 @@ class InternalJNI {
     Native.loadLibrary();
   }
 
-  static native void initFieldIDs();
+  static native long setup(
+      int algo, int level, int mode, int pmode, int softwareThreshold, int format);
 
-  static native void setup(QatZipper qzip, int algo, int level, int mode, int pmode);
+  static native int currentNumaNode();
+
+  static native boolean isZstdAvailable();
 
   static native int maxCompressedSize(long session, long sourceSize);
 
-  static native int compressByteArray(
-      QatZipper qzip,
+  static native long setupDictionary(int algo, int level, byte[] dictionary);
+
+  static native void setChecksumEnabled(long session, boolean enabled);
+
+  static native void setSpinBudget(long session, long spinBudgetNanos);
+
+  static native long checksum(long session);
+
+  static native long crc32Combine(long crc1, long crc2, long len2);
+
+  // The compress and decompress calls return the number of bytes read in the upper 32 bits and the
+  // number of bytes written in the lower 32 bits; the caller advances buffer positions.
+  static native long compressByteArray(
       long session,
       byte[] src,
       int srcOff,
@@ -34,8 +48,7 @@ class InternalJNI {
       int dstLen,
       int retryCount);
 
-  static native int decompressByteArray(
-      QatZipper qzip,
+  static native long decompressByteArray(
       long session,
       byte[] src,
       int srcOff,
@@ -45,7 +58,7 @@ class InternalJNI {
       int dstLen,
       int retryCount);
 
-  static native int compressByteBuffer(
+  static native long compressByteBuffer(
       long session,
       ByteBuffer srcBuffer,
       byte[] src,
@@ -56,7 +69,7 @@ class InternalJNI {
       int dstLen,
       int retryCount);
 
-  static native int decompressByteBuffer(
+  static native long decompressByteBuffer(
       long session,
       ByteBuffer srcBuffer,
       byte[] src,
@@ -67,7 +80,7 @@ class InternalJNI {
       int dstLen,
       int retryCount);
 
-  static native int compressDirectByteBuffer(
+  static native long compressDirectByteBuffer(
       long session,
       ByteBuffer src,
       int srcOff,
@@ -77,7 +90,7 @@ class InternalJNI {
       int dstLen,
       int retryCount);
 
-  static native int decompressDirectByteBuffer(
+  static native long decompressDirectByteBuffer(
       long session,
       ByteBuffer src,
       int srcOff,
@@ -87,7 +100,7 @@ class InternalJNI {
       int dstLen,
       int retryCount);
 
-  static native int compressDirectByteBufferSrc(
+  static native long compressDirectByteBufferSrc(
       long session,
       ByteBuffer src,
       int srcOff,
@@ -97,7 +110,7 @@ class InternalJNI {
       int dstLen,
       int retryCount);
 
-  static native int decompressDirectByteBufferSrc(
+  static native long decompressDirectByteBufferSrc(
       long session,
       ByteBuffer src,
       int srcOff,
@@ -107,7 +120,7 @@ class InternalJNI {
       int dstLen,
       int retryCount);
 
-  static native int compressDirectByteBufferDst(
+  static native long compressDirectByteBufferDst(
       long session,
       ByteBuffer src,
       byte[] srcArr,
@@ -118,7 +131,7 @@ class InternalJNI {
       int dstLen,
       int retryCount);
 
-  static native int decompressDirectByteBufferDst(
+  static native long decompressDirectByteBufferDst(
       long session,
       ByteBuffer src,
       byte[] srcArr,
@@ -129,5 +142,56 @@ class InternalJNI {
       int dstLen,
       int retryCount);
 
+  static native int compressBatch(
+      long session, Object[] srcs, Object[] dsts, int[] params, int[] results, int retryCount);
+
+  static native int decompressBatch(
+      long session, Object[] srcs, Object[] dsts, int[] params, int[] results, int retryCount);
+
+  static native void compressMulti(
+      long[] sessions,
+      Object src,
+      int srcOff,
+      int srcLen,
+      Object[] dsts,
+      int[] params,
+      int[] results);
+
+  static native long createStream();
+
+  static native long decompressStream(
+      long session,
+      long stream,
+      byte[] src,
+      int srcOff,
+      int srcLen,
+      byte[] dst,
+      int dstOff,
+      int dstLen,
+      boolean last,
+      int retryCount);
+
+  static native int streamPending(long stream);
+
+  static native void endStream(long session, long stream);
+
+  static native long allocateNativeBuffer(long size, int numa, boolean forcePinned);
+
+  static native ByteBuffer wrapNativeBuffer(long address, int capacity);
+
+  static native long bufferAddress(ByteBuffer buffer);
+
+  static native void freeNativeBuffer(long address);
+
   static native int teardown(long session);
+
+  static native void setStatsEnabled(boolean enabled);
+
+  static native boolean isStatsEnabled();
+
+  static native void readStats(long session, long[] counters);
+
+  static native void resetStats(long session);
+
+  static native int[] statsErrorCodes();
 }
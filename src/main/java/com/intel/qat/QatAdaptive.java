@@ -0,0 +1,210 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Format;
+
+import java.nio.ByteBuffer;
+import java.util.zip.Adler32;
+import java.util.zip.CRC32;
+
+/**
+ * The entropy estimate and the stored DEFLATE output of adaptive compression; see {@link
+ * QatZipper#setAdaptive(boolean)}.
+ */
+final class QatAdaptive {
+  /** The number of bytes at the start of a source whose histogram estimates its entropy. */
+  static final int SAMPLE_SIZE = 4096;
+
+  /** The entropy, in bits per byte, from which a source is stored without compressing it. */
+  static final double STORE_ENTROPY = 7.6;
+
+  /** The entropy, in bits per byte, from which a source is compressed at {@link #FAST_LEVEL}. */
+  static final double FAST_ENTROPY = 6.5;
+
+  /** The level of poorly compressible sources. */
+  static final int FAST_LEVEL = 1;
+
+  /**
+   * The number of requests in a row that saved less than 1/32 of their source, after which most
+   * requests are stored without compressing them.
+   */
+  static final int INCOMPRESSIBLE_RUN = 4;
+
+  /** While requests are stored without compressing them, every so many is compressed anyway. */
+  static final int PROBE_INTERVAL = 8;
+
+  /** A request saves too little if it saves less than its source size shifted by this. */
+  static final int MIN_SAVING_SHIFT = 5;
+
+  /** The largest stored block, which is also the data of a stored gzip-ext member. */
+  private static final int MAX_STORED_BLOCK = 65535;
+
+  private static final int STORED_BLOCK_HEADER_SIZE = 5;
+  private static final int GZIP_HEADER_SIZE = 10;
+  private static final int GZIP_EXT_HEADER_SIZE = 24;
+  private static final int GZIP_TRAILER_SIZE = 8;
+  private static final int ZLIB_HEADER_SIZE = 2;
+  private static final int ZLIB_TRAILER_SIZE = 4;
+
+  private QatAdaptive() {}
+
+  /**
+   * Estimates the entropy of the remaining bytes of the buffer from the byte histogram of their
+   * first {@link #SAMPLE_SIZE} bytes. The histogram is counted in four interleaved lanes, so that
+   * consecutive equal bytes do not wait on each other's counter. The position of the buffer does
+   * not change.
+   *
+   * @param src the source buffer
+   * @return the entropy in bits per byte, from 0 to 8.
+   */
+  static double entropy(ByteBuffer src) {
+    int n = Math.min(src.remaining(), SAMPLE_SIZE);
+    if (n == 0) return 0;
+    int[] counts = new int[4 * 256];
+    int pos = src.position();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+      counts[src.get(pos + i) & 0xff]++;
+      counts[256 + (src.get(pos + i + 1) & 0xff)]++;
+      counts[512 + (src.get(pos + i + 2) & 0xff)]++;
+      counts[768 + (src.get(pos + i + 3) & 0xff)]++;
+    }
+    for (; i < n; i++) counts[src.get(pos + i) & 0xff]++;
+
+    double sum = 0;
+    for (int b = 0; b < 256; b++) {
+      int c = counts[b] + counts[256 + b] + counts[512 + b] + counts[768 + b];
+      if (c > 0) sum += c * Math.log(c);
+    }
+    return (Math.log(n) - sum / n) / Math.log(2);
+  }
+
+  /**
+   * Returns the size of the given number of bytes written as stored blocks in the given format.
+   *
+   * @param format the format
+   * @param len the number of bytes, more than 0
+   * @return the size of the stored output.
+   */
+  static long storedLength(Format format, int len) {
+    long blocks = (len + (long) MAX_STORED_BLOCK - 1) / MAX_STORED_BLOCK;
+    long data = len + blocks * STORED_BLOCK_HEADER_SIZE;
+    switch (format) {
+      case GZIP_EXT:
+        return data + blocks * (GZIP_EXT_HEADER_SIZE + GZIP_TRAILER_SIZE);
+      case GZIP:
+        return data + GZIP_HEADER_SIZE + GZIP_TRAILER_SIZE;
+      case ZLIB:
+        return data + ZLIB_HEADER_SIZE + ZLIB_TRAILER_SIZE;
+      default:
+        return data;
+    }
+  }
+
+  /**
+   * Writes the remaining bytes of the source buffer as stored DEFLATE blocks in the given format.
+   * Gzip-ext output is a member per block, with the QZ extra field QATzip writes; gzip and zlib
+   * output is a single member or stream. Both buffers are advanced; the destination must have
+   * {@link #storedLength} bytes remaining.
+   *
+   * @param format the format
+   * @param level the compression level, for the zlib header
+   * @param src the source buffer
+   * @param dst the destination buffer
+   * @return the number of bytes written.
+   */
+  static int writeStored(Format format, int level, ByteBuffer src, ByteBuffer dst) {
+    int start = dst.position();
+    if (format == Format.GZIP_EXT) {
+      while (src.hasRemaining()) {
+        int len = Math.min(src.remaining(), MAX_STORED_BLOCK);
+        ByteBuffer block = src.duplicate();
+        block.limit(block.position() + len);
+        gzipHeader(dst, true);
+        putLe32(dst, len);
+        putLe32(dst, len + STORED_BLOCK_HEADER_SIZE);
+        writeBlocks(block.duplicate(), dst);
+        gzipTrailer(dst, block, len);
+        src.position(src.position() + len);
+      }
+      return dst.position() - start;
+    }
+
+    ByteBuffer data = src.duplicate();
+    if (format == Format.GZIP) gzipHeader(dst, false);
+    else if (format == Format.ZLIB) zlibHeader(dst, level);
+    int len = writeBlocks(src, dst);
+    if (format == Format.GZIP) {
+      gzipTrailer(dst, data, len);
+    } else if (format == Format.ZLIB) {
+      Adler32 adler = new Adler32();
+      adler.update(data);
+      int value = (int) adler.getValue();
+      dst.put((byte) (value >>> 24));
+      dst.put((byte) (value >>> 16));
+      dst.put((byte) (value >>> 8));
+      dst.put((byte) value);
+    }
+    return dst.position() - start;
+  }
+
+  /** Writes the remaining bytes of the source as stored blocks, and returns their number. */
+  private static int writeBlocks(ByteBuffer src, ByteBuffer dst) {
+    int total = src.remaining();
+    do {
+      int len = Math.min(src.remaining(), MAX_STORED_BLOCK);
+      ByteBuffer block = src.duplicate();
+      block.limit(block.position() + len);
+      // BFINAL on the last block, BTYPE 00, and the length and its complement.
+      dst.put((byte) (len == src.remaining() ? 1 : 0));
+      dst.put((byte) len);
+      dst.put((byte) (len >>> 8));
+      dst.put((byte) ~len);
+      dst.put((byte) (~len >>> 8));
+      dst.put(block);
+      src.position(src.position() + len);
+    } while (src.hasRemaining());
+    return total;
+  }
+
+  /** Writes a gzip header, with an empty QZ extra field for gzip-ext members. */
+  private static void gzipHeader(ByteBuffer dst, boolean ext) {
+    dst.put((byte) 0x1f).put((byte) 0x8b).put((byte) 8).put((byte) (ext ? 0x04 : 0));
+    putLe32(dst, 0); // MTIME
+    dst.put((byte) 0).put((byte) 0xff); // XFL, OS unknown
+    if (ext) {
+      // XLEN, and the QZ subfield of 8 bytes, whose sizes the caller writes.
+      dst.put((byte) 12).put((byte) 0);
+      dst.put((byte) 'Q').put((byte) 'Z').put((byte) 8).put((byte) 0);
+    }
+  }
+
+  /** Writes the CRC-32 and the size of the given data. */
+  private static void gzipTrailer(ByteBuffer dst, ByteBuffer data, int len) {
+    CRC32 crc = new CRC32();
+    crc.update(data);
+    putLe32(dst, (int) crc.getValue());
+    putLe32(dst, len);
+  }
+
+  /** Writes the zlib header QAT-Java writes for the given level. */
+  private static void zlibHeader(ByteBuffer dst, int level) {
+    int cmf = 0x78;
+    int flevel = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+    int flg = flevel << 6;
+    flg |= 31 - ((cmf << 8 | flg) % 31);
+    dst.put((byte) cmf).put((byte) flg);
+  }
+
+  private static void putLe32(ByteBuffer dst, int value) {
+    dst.put((byte) value);
+    dst.put((byte) (value >>> 8));
+    dst.put((byte) (value >>> 16));
+    dst.put((byte) (value >>> 24));
+  }
+}
@@ -0,0 +1,246 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import java.lang.ref.Cleaner;
+import java.nio.ByteBuffer;
+import java.util.Objects;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.concurrent.atomic.AtomicLong;
+
+/**
+ * An allocator of direct byte buffers backed by memory from QATzip's <code>qzMalloc</code>. QAT
+ * performs best on pinned, physically contiguous memory; when a buffer passed to {@link
+ * QatZipper#compress(ByteBuffer, ByteBuffer)} or {@link QatZipper#decompress(ByteBuffer,
+ * ByteBuffer)} lives in such memory, QATzip uses it directly instead of copying it into internal
+ * pinned buffers. {@link #allocate(int)} falls back to ordinary memory when no pinned memory is
+ * available; {@link #allocate(int, boolean)} can require pinned memory instead.
+ *
+ * <p>Memory is allocated on the NUMA node of the calling thread, unless the <code>
+ * qat.buffer.numa.node</code> system property names a node for all allocations.
+ *
+ * <p>Allocating pinned memory is expensive, so memory is pooled by NUMA node and size class.
+ * Requests are served from chunks whose sizes are powers of two between {@link #MIN_SIZE_CLASS}
+ * and {@link #MAX_SIZE_CLASS}; larger requests are not pooled. Memory returned with {@link
+ * #release(ByteBuffer)} is reused by a later allocation on the same node, as long as the free
+ * chunks of all pools add up to at most {@link #getMaxPooledBytes()}; memory of a buffer that is
+ * never released is reclaimed when the buffer becomes unreachable.
+ */
+public final class QatBufferAllocator {
+  /** The smallest size class in bytes (4KB). */
+  public static final int MIN_SIZE_CLASS = 1 << 12;
+
+  /** The largest size class in bytes (4MB). */
+  public static final int MAX_SIZE_CLASS = 1 << 22;
+
+  /** The default maximum number of bytes retained in free chunks (64MB). */
+  public static final long DEFAULT_MAX_POOLED_BYTES = 64L << 20;
+
+  /** The NUMA node memory is allocated on, or -1 for the node of the calling thread. */
+  static final int NUMA_NODE = Integer.getInteger("qat.buffer.numa.node", -1);
+
+  private static final int MIN_SHIFT = Integer.numberOfTrailingZeros(MIN_SIZE_CLASS);
+  private static final int MAX_SHIFT = Integer.numberOfTrailingZeros(MAX_SIZE_CLASS);
+
+  private static final Cleaner cleaner = Cleaner.create();
+  private static final ConcurrentHashMap<Long, Cleaner.Cleanable> leases =
+      new ConcurrentHashMap<>();
+
+  // The pools of each NUMA node and kind of memory, keyed by partition().
+  private static final ConcurrentHashMap<Integer, Pool[]> partitions = new ConcurrentHashMap<>();
+  private static final AtomicLong pooledBytes = new AtomicLong();
+
+  private static volatile long maxPooledBytes = DEFAULT_MAX_POOLED_BYTES;
+
+  private QatBufferAllocator() {}
+
+  /**
+   * Returns a direct buffer of the given capacity backed by QATzip-allocated memory, which is
+   * pinned if pinned memory is available.
+   *
+   * @param capacity the capacity of the buffer in bytes
+   * @return a direct byte buffer
+   * @throws QatException if the memory cannot be allocated
+   */
+  public static ByteBuffer allocate(int capacity) {
+    return allocate(capacity, false);
+  }
+
+  /**
+   * Returns a direct buffer of the given capacity backed by QATzip-allocated memory.
+   *
+   * @param capacity the capacity of the buffer in bytes
+   * @param pinned true to fail rather than fall back to ordinary memory when no pinned memory is
+   *     available
+   * @return a direct byte buffer
+   * @throws QatException if the memory cannot be allocated
+   */
+  public static ByteBuffer allocate(int capacity, boolean pinned) {
+    if (capacity < 0) throw new IllegalArgumentException("Invalid buffer capacity.");
+
+    int node = NUMA_NODE >= 0 ? NUMA_NODE : Math.max(InternalJNI.currentNumaNode(), 0);
+    int partition = partition(node, pinned);
+    int sizeClass = sizeClass(capacity);
+    Chunk chunk = null;
+    if (sizeClass >= 0) {
+      Pool pool = pools(partition)[sizeClass];
+      chunk = pool.free.poll();
+      if (chunk != null) {
+        pool.count.decrementAndGet();
+        pooledBytes.addAndGet(-chunk.size);
+      }
+    }
+    if (chunk == null) {
+      int size = sizeClass >= 0 ? 1 << (sizeClass + MIN_SHIFT) : Math.max(capacity, 1);
+      long address = InternalJNI.allocateNativeBuffer(size, node, pinned);
+      chunk = new Chunk(address, size, partition, sizeClass);
+    }
+
+    ByteBuffer buffer = InternalJNI.wrapNativeBuffer(chunk.address, capacity);
+    leases.put(chunk.address, cleaner.register(buffer, new Reclaim(chunk)));
+    return buffer;
+  }
+
+  /**
+   * Returns the memory of a buffer obtained from {@link #allocate(int)} to the pool. The buffer,
+   * and any view of it, must not be used afterwards.
+   *
+   * @param buffer the buffer to release
+   * @throws IllegalArgumentException if the buffer was not allocated by this class or has already
+   *     been released
+   */
+  public static void release(ByteBuffer buffer) {
+    Objects.requireNonNull(buffer);
+    Cleaner.Cleanable lease =
+        buffer.isDirect() ? leases.get(InternalJNI.bufferAddress(buffer)) : null;
+    if (lease == null)
+      throw new IllegalArgumentException(
+          "Buffer was not allocated by QatBufferAllocator or has already been released.");
+    lease.clean();
+  }
+
+  /**
+   * Sets the maximum number of bytes retained in free chunks, over all pools. Memory released
+   * beyond that is freed.
+   *
+   * @param max the maximum number of pooled bytes
+   */
+  public static void setMaxPooledBytes(long max) {
+    if (max < 0) throw new IllegalArgumentException();
+    maxPooledBytes = max;
+  }
+
+  /**
+   * Returns the maximum number of bytes retained in free chunks, over all pools.
+   *
+   * @return the maximum number of pooled bytes.
+   */
+  public static long getMaxPooledBytes() {
+    return maxPooledBytes;
+  }
+
+  /** Frees all pooled memory. Buffers currently in use are not affected. */
+  public static void clear() {
+    for (Pool[] pools : partitions.values()) {
+      for (Pool pool : pools) {
+        Chunk chunk;
+        while ((chunk = pool.free.poll()) != null) {
+          pool.count.decrementAndGet();
+          pooledBytes.addAndGet(-chunk.size);
+          InternalJNI.freeNativeBuffer(chunk.address);
+        }
+      }
+    }
+  }
+
+  /** Returns the number of free chunks pooled for the given capacity, over all NUMA nodes. */
+  static int pooledCount(int capacity) {
+    int sizeClass = sizeClass(capacity);
+    if (sizeClass < 0) return 0;
+    int count = 0;
+    for (Pool[] pools : partitions.values()) count += pools[sizeClass].count.get();
+    return count;
+  }
+
+  /** Returns the number of bytes in free chunks, over all pools. */
+  static long pooledBytes() {
+    return pooledBytes.get();
+  }
+
+  /** Returns the key of the pools of the given NUMA node and kind of memory. */
+  private static int partition(int node, boolean pinned) {
+    return node << 1 | (pinned ? 1 : 0);
+  }
+
+  /** Returns the pools of the given partition. */
+  private static Pool[] pools(int partition) {
+    return partitions.computeIfAbsent(
+        partition,
+        k -> {
+          Pool[] pools = new Pool[MAX_SHIFT - MIN_SHIFT + 1];
+          for (int i = 0; i < pools.length; i++) pools[i] = new Pool();
+          return pools;
+        });
+  }
+
+  /** Returns the size class index for the given capacity, or -1 if it is too large to pool. */
+  private static int sizeClass(int capacity) {
+    if (capacity > MAX_SIZE_CLASS) return -1;
+    int size = Math.max(capacity, MIN_SIZE_CLASS);
+    return (32 - Integer.numberOfLeadingZeros(size - 1)) - MIN_SHIFT;
+  }
+
+  /** The free chunks of one size class. */
+  private static final class Pool {
+    final ConcurrentLinkedQueue<Chunk> free = new ConcurrentLinkedQueue<>();
+    final AtomicInteger count = new AtomicInteger();
+  }
+
+  /** A block of native memory. It must not refer to the buffers that wrap it. */
+  private static final class Chunk {
+    final long address;
+    final int size;
+    final int partition;
+    final int sizeClass;
+
+    Chunk(long address, int size, int partition, int sizeClass) {
+      this.address = address;
+      this.size = size;
+      this.partition = partition;
+      this.sizeClass = sizeClass;
+    }
+  }
+
+  /**
+   * A cleaner action that returns the memory of a buffer to the pool, or frees it if the pool is
+   * full. It runs when the buffer is released or becomes unreachable, whichever comes first.
+   */
+  private static final class Reclaim implements Runnable {
+    private final Chunk chunk;
+
+    Reclaim(Chunk chunk) {
+      this.chunk = chunk;
+    }
+
+    @Override
+    public void run() {
+      leases.remove(chunk.address);
+      if (chunk.sizeClass >= 0) {
+        if (pooledBytes.addAndGet(chunk.size) <= maxPooledBytes) {
+          Pool pool = pools(chunk.partition)[chunk.sizeClass];
+          pool.count.incrementAndGet();
+          pool.free.offer(chunk);
+          return;
+        }
+        pooledBytes.addAndGet(-chunk.size);
+      }
+      InternalJNI.freeNativeBuffer(chunk.address);
+    }
+  }
+}
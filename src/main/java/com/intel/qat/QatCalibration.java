@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import com.intel.qat.QatZipper.Algorithm;
+import com.intel.qat.QatZipper.Mode;
+import com.intel.qat.QatZipper.PollingMode;
+import java.nio.charset.StandardCharsets;
+import java.util.Arrays;
+import java.util.Map;
+import java.util.Random;
+import java.util.concurrent.ConcurrentHashMap;
+
+/**
+ * Measures the source size from which compressing on QAT hardware is faster than compressing in
+ * software. This is the threshold that {@link QatZipper#AUTO_SOFTWARE_THRESHOLD} resolves to.
+ */
+final class QatCalibration {
+  // The source sizes measured, in increasing order.
+  private static final int[] SIZES = {256, 512, 1024, 2048, 4096, 8192, 16384, 32768};
+
+  // The number of timed calls per size and path; the median is compared.
+  private static final int ROUNDS = 31;
+
+  // The hardware has to be this much faster than software, so that timing noise on a host
+  // without hardware, where both paths run in software, does not produce a threshold.
+  private static final double MARGIN = 0.9;
+
+  // Calibrated thresholds by algorithm, polling mode and level.
+  private static final Map<Integer, Integer> thresholds = new ConcurrentHashMap<>();
+
+  private QatCalibration() {}
+
+  /**
+   * Returns the software threshold for the given algorithm, level and polling mode, measuring it on
+   * first use. The polling mode is part of what is measured, since it changes the hardware latency.
+   *
+   * @param algorithm the compression {@link Algorithm}
+   * @param level the compression level.
+   * @param pmode the {@link PollingMode} of the measured sessions
+   * @return the smallest measured size for which hardware is faster, or {@link
+   *     QatZipper#MAX_SOFTWARE_THRESHOLD} if it is never faster.
+   */
+  static int softwareThreshold(Algorithm algorithm, int level, PollingMode pmode) {
+    return thresholds.computeIfAbsent(
+        (algorithm.ordinal() << 16) | (pmode.ordinal() << 8) | level,
+        k -> measure(algorithm, level, pmode));
+  }
+
+  private static int measure(Algorithm algorithm, int level, PollingMode pmode) {
+    byte[] src = sample(SIZES[SIZES.length - 1]);
+    long hw = 0;
+    long sw = 0;
+    try {
+      // Only sources smaller than the threshold are compressed in software, so one session sends
+      // every measured size to the hardware and the other none.
+      hw = setup(algorithm, level, pmode, QatZipper.MIN_SOFTWARE_THRESHOLD);
+      sw = setup(algorithm, level, pmode, QatZipper.MAX_SOFTWARE_THRESHOLD);
+      byte[] dst = new byte[InternalJNI.maxCompressedSize(hw, src.length)];
+
+      for (int size : SIZES) {
+        long hwTime = time(hw, src, size, dst);
+        long swTime = time(sw, src, size, dst);
+        if (hwTime < swTime * MARGIN) return Math.max(size, QatZipper.MIN_SOFTWARE_THRESHOLD);
+      }
+      return QatZipper.MAX_SOFTWARE_THRESHOLD;
+    } finally {
+      if (hw != 0) InternalJNI.teardown(hw);
+      if (sw != 0) InternalJNI.teardown(sw);
+    }
+  }
+
+  private static long setup(Algorithm algorithm, int level, PollingMode pmode, int threshold) {
+    return InternalJNI.setup(
+        algorithm.ordinal(),
+        level,
+        Mode.AUTO.ordinal(),
+        pmode.ordinal(),
+        threshold,
+        QatZipper.DEFAULT_FORMAT.ordinal());
+  }
+
+  /** Returns the median time in nanoseconds to compress the first <code>size</code> bytes. */
+  private static long time(long session, byte[] src, int size, byte[] dst) {
+    // Warm up the session and the code paths before timing.
+    for (int i = 0; i < ROUNDS / 4; i++)
+      InternalJNI.compressByteArray(session, src, 0, size, dst, 0, dst.length, 0);
+
+    long[] times = new long[ROUNDS];
+    for (int i = 0; i < ROUNDS; i++) {
+      long start = System.nanoTime();
+      InternalJNI.compressByteArray(session, src, 0, size, dst, 0, dst.length, 0);
+      times[i] = System.nanoTime() - start;
+    }
+    Arrays.sort(times);
+    return times[ROUNDS / 2];
+  }
+
+  /** Returns moderately compressible text made of words from a small vocabulary. */
+  private static byte[] sample(int size) {
+    String[] words = {
+      "the ", "quick ", "brown ", "fox ", "jumps ", "over ", "lazy ", "dog ", "and ", "runs ",
+      "away ", "from ", "a ", "large ", "red ", "barn ", "\n", "1024 ", "status=ok ", "id="
+    };
+    Random rnd = new Random(size);
+    byte[] b = new byte[size];
+    int pos = 0;
+    while (pos < size) {
+      byte[] w = words[rnd.nextInt(words.length)].getBytes(StandardCharsets.US_ASCII);
+      int n = Math.min(w.length, size - pos);
+      System.arraycopy(w, 0, b, pos, n);
+      pos += n;
+    }
+    return b;
+  }
+}
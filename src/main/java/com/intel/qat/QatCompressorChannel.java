@@ -0,0 +1,196 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
+
+import java.io.Flushable;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.channels.ClosedChannelException;
+import java.nio.channels.WritableByteChannel;
+import java.util.Objects;
+
+/**
+ * This class implements a WritableByteChannel that compresses data using Intel &reg; QuickAssist
+ * Technology (QAT) and writes it to another channel, such as a <code>FileChannel</code> or a
+ * <code>SocketChannel</code>.
+ *
+ * <p>Unlike {@link QatCompressorOutputStream}, this class buffers data in direct byte buffers from
+ * {@link QatBufferAllocator}, so compressed data never passes through the Java heap. Direct source
+ * buffers of at least the buffer size are compressed in place without being copied. The target
+ * channel is expected to be in blocking mode.
+ */
+public class QatCompressorChannel implements WritableByteChannel, Flushable {
+  private final WritableByteChannel out;
+  private final QatZipper qzip;
+  private final ByteBuffer inputBuffer;
+  private final ByteBuffer outputBuffer;
+  private boolean open;
+
+  /** The default size in bytes of the input buffer (64KB). */
+  public static final int DEFAULT_BUFFER_SIZE = 1 << 16;
+
+  /**
+   * Creates a new channel with the given parameters.
+   *
+   * @param out the target channel
+   * @param bufferSize the input buffer size
+   * @param algorithm the compression algorithm (deflate or LZ4).
+   * @param level the compression level.
+   * @param mode the mode of operation (HARDWARE - only hardware, AUTO - hardware with a software
+   *     failover.)
+   * @param pmode the polling mode
+   */
+  public QatCompressorChannel(
+      WritableByteChannel out,
+      int bufferSize,
+      Algorithm algorithm,
+      int level,
+      Mode mode,
+      PollingMode pmode) {
+    if (bufferSize <= 0) throw new IllegalArgumentException();
+    this.out = Objects.requireNonNull(out);
+    qzip = new QatZipper(algorithm, level, mode, pmode);
+    inputBuffer = QatBufferAllocator.allocate(bufferSize);
+    outputBuffer = QatBufferAllocator.allocate(qzip.maxCompressedLength(bufferSize));
+    open = true;
+  }
+
+  /**
+   * Creates a new channel with the given parameters, {@link QatZipper#DEFAULT_COMPRESS_LEVEL},
+   * {@link QatZipper#DEFAULT_MODE}, and {@link PollingMode#BUSY}.
+   *
+   * @param out the target channel
+   * @param bufferSize the input buffer size
+   * @param algorithm the compression algorithm (deflate or LZ4).
+   */
+  public QatCompressorChannel(WritableByteChannel out, int bufferSize, Algorithm algorithm) {
+    this(
+        out,
+        bufferSize,
+        algorithm,
+        QatZipper.DEFAULT_COMPRESS_LEVEL,
+        QatZipper.DEFAULT_MODE,
+        PollingMode.BUSY);
+  }
+
+  /**
+   * Creates a new channel with {@link Algorithm#DEFLATE}, {@link
+   * QatZipper#DEFAULT_COMPRESS_LEVEL}, {@link QatZipper#DEFAULT_MODE}, and {@link
+   * PollingMode#BUSY}.
+   *
+   * @param out the target channel
+   * @param bufferSize the input buffer size
+   */
+  public QatCompressorChannel(WritableByteChannel out, int bufferSize) {
+    this(out, bufferSize, Algorithm.DEFLATE);
+  }
+
+  /**
+   * Creates a new channel with {@link DEFAULT_BUFFER_SIZE}, {@link Algorithm#DEFLATE}, {@link
+   * QatZipper#DEFAULT_COMPRESS_LEVEL}, {@link QatZipper#DEFAULT_MODE}, and {@link
+   * PollingMode#BUSY}.
+   *
+   * @param out the target channel
+   */
+  public QatCompressorChannel(WritableByteChannel out) {
+    this(out, DEFAULT_BUFFER_SIZE, Algorithm.DEFLATE);
+  }
+
+  /**
+   * Compresses the remaining bytes of the given buffer. The data may be buffered until the input
+   * buffer is full, {@link #flush()} is called, or the channel is closed.
+   *
+   * @param src the buffer holding the data to be written
+   * @return the number of bytes consumed from <code>src</code>, which is always all of them
+   * @throws IOException if this channel is closed or an I/O error occurs
+   */
+  @Override
+  public int write(ByteBuffer src) throws IOException {
+    if (!open) throw new ClosedChannelException();
+    int written = src.remaining();
+    while (src.hasRemaining()) {
+      if (inputBuffer.position() == 0
+          && src.isDirect()
+          && src.remaining() >= inputBuffer.capacity()) {
+        // Compress a full block straight out of the caller's buffer.
+        ByteBuffer block = src.duplicate();
+        block.limit(block.position() + inputBuffer.capacity());
+        compressAndWrite(block);
+        src.position(block.position());
+        continue;
+      }
+      ByteBuffer chunk = src.duplicate();
+      chunk.limit(chunk.position() + Math.min(src.remaining(), inputBuffer.remaining()));
+      inputBuffer.put(chunk);
+      src.position(chunk.position());
+      if (!inputBuffer.hasRemaining()) flushBuffer();
+    }
+    return written;
+  }
+
+  /**
+   * Compresses all buffered data and writes it to the target channel.
+   *
+   * @throws IOException if this channel is closed or an I/O error occurs
+   */
+  @Override
+  public void flush() throws IOException {
+    if (!open) throw new ClosedChannelException();
+    flushBuffer();
+  }
+
+  /**
+   * Tells whether or not this channel is open.
+   *
+   * @return true if, and only if, this channel is open
+   */
+  @Override
+  public boolean isOpen() {
+    return open;
+  }
+
+  /**
+   * Writes any remaining data to the target channel and releases resources. This method will close
+   * the target channel.
+   *
+   * @throws IOException if an I/O error occurs
+   */
+  @Override
+  public void close() throws IOException {
+    if (!open) return;
+    try {
+      flushBuffer();
+    } finally {
+      open = false;
+      qzip.end();
+      QatBufferAllocator.release(inputBuffer);
+      QatBufferAllocator.release(outputBuffer);
+      out.close();
+    }
+  }
+
+  private void flushBuffer() throws IOException {
+    if (inputBuffer.position() == 0) return;
+    inputBuffer.flip();
+    try {
+      compressAndWrite(inputBuffer);
+    } finally {
+      inputBuffer.clear();
+    }
+  }
+
+  private void compressAndWrite(ByteBuffer src) throws IOException {
+    outputBuffer.clear();
+    qzip.compress(src, outputBuffer);
+    outputBuffer.flip();
+    while (outputBuffer.hasRemaining()) out.write(outputBuffer);
+  }
+}
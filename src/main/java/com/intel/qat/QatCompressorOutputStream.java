@@ -7,13 +7,19 @@
 package com.intel.qat;
 
 import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Format;
 import static com.intel.qat.QatZipper.Mode;
 import static com.intel.qat.QatZipper.PollingMode;
 
 import java.io.FilterOutputStream;
 import java.io.IOException;
 import java.io.OutputStream;
+import java.io.UncheckedIOException;
 import java.util.Objects;
+import java.util.concurrent.CompletableFuture;
+import java.util.concurrent.CompletionException;
+import java.util.zip.CRC32;
+import java.util.zip.Deflater;
 
 /**
  * This class implements an OutputStream filter that compresses data using Intel &reg; QuickAssist
@@ -27,18 +33,47 @@ public class QatCompressorOutputStream extends FilterOutputStream {
   private int outputPosition;
   private boolean closed;
 
+  // State of the pipelined mode; only used when pipelineDepth > 1.
+  private final int pipelineDepth;
+  private byte[][] inputBuffers;
+  private byte[][] outputBuffers;
+  private CompletableFuture<?>[] pending;
+  private int currentSlot;
+  private CompletableFuture<?> compressTail;
+  private CompletableFuture<?> writeTail;
+
+  // State of the sync-flush mode; only used when deflater != null.
+  private Deflater deflater;
+  private CRC32 crc;
+  private long totalIn;
+  private boolean headerWritten;
+
   /** The default size in bytes of the output buffer (64KB). */
   public static final int DEFAULT_BUFFER_SIZE = 1 << 16;
 
+  /**
+   * The default pipeline depth. A depth of 1 compresses and writes each buffer on the calling
+   * thread.
+   */
+  public static final int DEFAULT_PIPELINE_DEPTH = 1;
+
   /**
    * Creates a new output stream with the given paramters.
    *
+   * <p>If <code>pipelineDepth</code> is greater than 1, the stream keeps that many buffers. A full
+   * buffer is compressed and written to the underlying stream by background threads while the
+   * caller fills the next buffer, so that copying, compression and downstream I/O overlap. Errors
+   * from the background threads are reported by a later call to <code>write</code>, <code>flush
+   * </code> or <code>close</code>.
+   *
    * @param out the output stream
    * @param bufferSize the output buffer size
    * @param algorithm the compression algorithm (deflate or LZ4).
    * @param level the compression level.
    * @param mode the mode of operation (HARDWARE - only hardware, AUTO - hardware with a software
+   *     failover.)
    * @param pmode the polling mode
+   * @param pipelineDepth the number of buffers that may be in flight at once
    */
   public QatCompressorOutputStream(
       OutputStream out,
@@ -46,16 +81,152 @@ public class QatCompressorOutputStream extends FilterOutputStream {
       Algorithm algorithm,
       int level,
       Mode mode,
-      PollingMode pmode) {
+      PollingMode pmode,
+      int pipelineDepth) {
+    this(
+        out,
+        bufferSize,
+        algorithm,
+        QatZipper.DEFAULT_FORMAT,
+        level,
+        mode,
+        pmode,
+        pipelineDepth,
+        false);
+  }
+
+  /**
+   * Creates a new output stream with the given paramters that compresses with {@link
+   * Algorithm#DEFLATE} into the given {@link Format}, for example {@link Format#GZIP} to write
+   * standard gzip files. The output is a sequence of gzip members, one per buffer, which gzip
+   * decoders read as a single file. Complete zlib and raw DEFLATE streams cannot be concatenated,
+   * so {@link Format#ZLIB} and {@link Format#RAW} data is written with {@link QatZipper} instead.
+   *
+   * @param out the output stream
+   * @param bufferSize the output buffer size
+   * @param format the format of the compressed data ({@link Format#GZIP_EXT} or {@link
+   *     Format#GZIP}).
+   * @param level the compression level.
+   * @param mode the mode of operation (HARDWARE - only hardware, AUTO - hardware with a software
+   *     failover.)
+   * @param pmode the polling mode
+   * @throws IllegalArgumentException if <code>format</code> is not a gzip format.
+   */
+  public QatCompressorOutputStream(
+      OutputStream out, int bufferSize, Format format, int level, Mode mode, PollingMode pmode) {
+    this(
+        out,
+        bufferSize,
+        Algorithm.DEFLATE,
+        format,
+        level,
+        mode,
+        pmode,
+        DEFAULT_PIPELINE_DEPTH,
+        false);
+  }
+
+  /**
+   * Creates a new output stream with the given paramters that writes {@link Format#GZIP} data and,
+   * if <code>syncFlush</code> is true, keeps its compressor state across calls to {@link #flush()}.
+   *
+   * <p>QAT requests are stateless, so a stream that compresses on QAT ends a gzip member at every
+   * flush and the next member starts with an empty history. A sync-flush stream instead compresses
+   * in software with {@link Deflater}, not on QAT, and writes a single gzip member: each flush ends
+   * the data compressed so far with an empty stored block (<code>Z_SYNC_FLUSH</code>), so that a
+   * reader can decode everything written before the flush, at a cost of a few bytes instead of a
+   * new member. This suits streams that are flushed often, such as network protocols. The output
+   * is a standard gzip file that any gzip decoder reads. If <code>syncFlush</code> is false, this
+   * constructor is the same as the {@link Format} constructor with {@link QatZipper#DEFAULT_MODE}
+   * and {@link PollingMode#BUSY}.
+   *
+   * @param out the output stream
+   * @param bufferSize the output buffer size
+   * @param format the format of the compressed data; only {@link Format#GZIP} is supported.
+   * @param level the compression level (1 to 9).
+   * @param syncFlush true to compress in software and keep the compressor state across flushes
+   * @throws IllegalArgumentException if <code>syncFlush</code> is true and <code>format</code> is
+   *     not {@link Format#GZIP}, or <code>level</code> is not a DEFLATE level.
+   */
+  public QatCompressorOutputStream(
+      OutputStream out, int bufferSize, Format format, int level, boolean syncFlush) {
+    this(
+        out,
+        bufferSize,
+        Algorithm.DEFLATE,
+        format,
+        level,
+        QatZipper.DEFAULT_MODE,
+        PollingMode.BUSY,
+        DEFAULT_PIPELINE_DEPTH,
+        syncFlush);
+  }
+
+  private QatCompressorOutputStream(
+      OutputStream out,
+      int bufferSize,
+      Algorithm algorithm,
+      Format format,
+      int level,
+      Mode mode,
+      PollingMode pmode,
+      int pipelineDepth,
+      boolean syncFlush) {
     super(out);
-    if (bufferSize <= 0) throw new IllegalArgumentException();
+    if (bufferSize <= 0 || pipelineDepth <= 0) throw new IllegalArgumentException();
+    if (format == Format.ZLIB || format == Format.RAW)
+      throw new IllegalArgumentException("Streams only support the gzip formats.");
     Objects.requireNonNull(out);
-    qzip = new QatZipper(algorithm, level, mode, pmode);
-    inputBuffer = new byte[bufferSize];
-    outputBuffer = new byte[qzip.maxCompressedLength(bufferSize)];
+    this.pipelineDepth = pipelineDepth;
+    if (syncFlush) {
+      if (format != Format.GZIP)
+        throw new IllegalArgumentException("Sync flush only supports the gzip format.");
+      if (level < 1 || level > 9) throw new IllegalArgumentException("Invalid compression level.");
+      deflater = new Deflater(level, true);
+      crc = new CRC32();
+      inputBuffer = new byte[bufferSize];
+      outputBuffer = new byte[bufferSize];
+      closed = false;
+      return;
+    }
+    qzip =
+        format == QatZipper.DEFAULT_FORMAT
+            ? new QatZipper(algorithm, level, mode, pmode)
+            : new QatZipper(format, level, mode, pmode);
+    if (pipelineDepth > 1) {
+      int outputSize = qzip.maxCompressedLength(bufferSize);
+      inputBuffers = new byte[pipelineDepth][bufferSize];
+      outputBuffers = new byte[pipelineDepth][outputSize];
+      pending = new CompletableFuture<?>[pipelineDepth];
+      compressTail = writeTail = CompletableFuture.completedFuture(null);
+      inputBuffer = inputBuffers[0];
+    } else {
+      inputBuffer = new byte[bufferSize];
+      outputBuffer = new byte[qzip.maxCompressedLength(bufferSize)];
+    }
     closed = false;
   }
 
+  /**
+   * Creates a new output stream with the given paramters and {@link DEFAULT_PIPELINE_DEPTH}.
+   *
+   * @param out the output stream
+   * @param bufferSize the output buffer size
+   * @param algorithm the compression algorithm (deflate or LZ4).
+   * @param level the compression level.
+   * @param mode the mode of operation (HARDWARE - only hardware, AUTO - hardware with a software
+   * @param pmode the polling mode
+   */
+  public QatCompressorOutputStream(
+      OutputStream out,
+      int bufferSize,
+      Algorithm algorithm,
+      int level,
+      Mode mode,
+      PollingMode pmode) {
+    this(out, bufferSize, algorithm, level, mode, pmode, DEFAULT_PIPELINE_DEPTH);
+  }
+
   /**
    * Creates a new output stream with {@link DEFAULT_BUFFER_SIZE}, {@link Algorithm#DEFLATE}, {@link
    * QatZipper#DEFAULT_COMPRESS_LEVEL}, {@link QatZipper#DEFAULT_MODE}, and {@link
@@ -224,6 +395,32 @@ public class QatCompressorOutputStream extends FilterOutputStream {
     this(out, bufferSize, algorithm, level, QatZipper.DEFAULT_MODE, pmode);
   }
 
+  /**
+   * Enables or disables adaptive compression of the buffers of this stream, as {@link
+   * QatZipper#setAdaptive(boolean)} describes: buffers that look incompressible are written as
+   * stored blocks, poorly compressible ones are compressed at level 1, and after several buffers in
+   * a row that saved little, most buffers are stored without compressing them. It should be set
+   * before data is written.
+   *
+   * @param adaptive true to compress adaptively
+   * @throws IllegalStateException if this stream is closed, does not compress with DEFLATE, or is a
+   *     sync-flush stream.
+   */
+  public void setAdaptive(boolean adaptive) {
+    if (closed) throw new IllegalStateException("Stream is closed");
+    if (qzip == null) throw new IllegalStateException("Sync-flush streams are not adaptive");
+    qzip.setAdaptive(adaptive);
+  }
+
+  /**
+   * Returns true if adaptive compression is enabled.
+   *
+   * @return true if adaptive compression is enabled, false otherwise.
+   */
+  public boolean isAdaptive() {
+    return qzip != null && qzip.isAdaptive();
+  }
+
   /**
    * Writes a byte to the compressed output stream.
    *
@@ -234,7 +431,7 @@ public class QatCompressorOutputStream extends FilterOutputStream {
   public void write(int b) throws IOException {
     if (closed) throw new IOException("Stream is closed");
     if (inputPosition == inputBuffer.length) {
-      flush();
+      drain();
     }
     inputBuffer[inputPosition++] = (byte) b;
   }
@@ -270,7 +467,7 @@ public class QatCompressorOutputStream extends FilterOutputStream {
       inputPosition += bytesToWrite;
       len -= bytesToWrite;
       off += bytesToWrite;
-      flush();
+      drain();
     }
     System.arraycopy(b, off, inputBuffer, inputPosition, len);
     inputPosition += len;
@@ -278,13 +475,25 @@ public class QatCompressorOutputStream extends FilterOutputStream {
 
   /**
    * Flushes all buffered data to the compressed output stream. This method will compress and write
-   * all buffered data to the output stream.
+   * all buffered data to the output stream. A sync-flush stream keeps compressing the same member
+   * afterwards; any other stream starts a new one.
    *
    * @throws IOException if this stream is closed
    */
   @Override
   public void flush() throws IOException {
     if (closed) throw new IOException("Stream is closed");
+    if (deflater != null) {
+      deflate(Deflater.SYNC_FLUSH);
+      out.flush();
+      return;
+    }
+    if (pipelineDepth > 1) {
+      submit();
+      await(writeTail);
+      out.flush();
+      return;
+    }
     if (inputPosition == 0) return;
     int currentPosition = inputPosition;
     inputPosition = 0;
@@ -310,11 +519,121 @@ public class QatCompressorOutputStream extends FilterOutputStream {
   @Override
   public void close() throws IOException {
     if (closed) return;
-    flush();
-    qzip.end();
-    out.close();
-    inputBuffer = null;
-    outputBuffer = null;
-    closed = true;
+    try {
+      if (deflater != null) finish();
+      else flush();
+    } finally {
+      if (pipelineDepth > 1) {
+        // Never release the session while a background task may still be using it.
+        writeTail.handle((v, e) -> null).join();
+      }
+      if (qzip != null) qzip.end();
+      if (deflater != null) deflater.end();
+      out.close();
+      inputBuffer = null;
+      outputBuffer = null;
+      inputBuffers = null;
+      outputBuffers = null;
+      closed = true;
+    }
+  }
+
+  /** Makes room in a full input buffer. */
+  private void drain() throws IOException {
+    if (deflater != null) deflate(Deflater.NO_FLUSH);
+    else if (pipelineDepth > 1) submit();
+    else flush();
+  }
+
+  /**
+   * Feeds the input buffer to the deflater of a sync-flush stream and writes the data it produces,
+   * starting with the gzip header.
+   */
+  private void deflate(int flush) throws IOException {
+    if (!headerWritten) {
+      // ID1, ID2, CM = 8, FLG = 0, MTIME = 0, XFL = 0, OS = unknown.
+      out.write(new byte[] {0x1f, (byte) 0x8b, 8, 0, 0, 0, 0, 0, 0, (byte) 0xff});
+      headerWritten = true;
+    }
+    crc.update(inputBuffer, 0, inputPosition);
+    totalIn += inputPosition;
+    deflater.setInput(inputBuffer, 0, inputPosition);
+    inputPosition = 0;
+    int n;
+    do {
+      n = deflater.deflate(outputBuffer, 0, outputBuffer.length, flush);
+      out.write(outputBuffer, 0, n);
+    } while (n == outputBuffer.length || !deflater.needsInput());
+  }
+
+  /** Ends the member of a sync-flush stream and writes the gzip trailer. */
+  private void finish() throws IOException {
+    deflate(Deflater.NO_FLUSH);
+    deflater.finish();
+    while (!deflater.finished()) {
+      int n = deflater.deflate(outputBuffer);
+      out.write(outputBuffer, 0, n);
+    }
+    // CRC32 and ISIZE (the input size modulo 2^32), little-endian.
+    byte[] trailer = new byte[8];
+    long c = crc.getValue();
+    for (int i = 0; i < 4; i++) {
+      trailer[i] = (byte) (c >>> (8 * i));
+      trailer[4 + i] = (byte) (totalIn >>> (8 * i));
+    }
+    out.write(trailer);
+    out.flush();
+  }
+
+  /**
+   * Hands the current buffer to the pipeline and switches to the next one, waiting until that
+   * buffer has been written out. Compression tasks run one at a time because they share the
+   * session; each write runs after its compression and after the previous write.
+   */
+  private void submit() throws IOException {
+    if (inputPosition == 0) return;
+    final int slot = currentSlot;
+    final int len = inputPosition;
+    final byte[] src = inputBuffers[slot];
+    final byte[] dst = outputBuffers[slot];
+
+    CompletableFuture<Integer> compressed =
+        compressTail.thenApplyAsync(
+            v -> qzip.compress(src, 0, len, dst, 0, dst.length),
+            QatZipper.StreamExecutor.INSTANCE);
+    compressTail = compressed;
+    writeTail =
+        writeTail.thenCombineAsync(
+            compressed,
+            (v, n) -> {
+              try {
+                out.write(dst, 0, n);
+              } catch (IOException e) {
+                throw new UncheckedIOException(e);
+              }
+              return null;
+            },
+            QatZipper.StreamExecutor.INSTANCE);
+    pending[slot] = writeTail;
+
+    currentSlot = (slot + 1) % pipelineDepth;
+    CompletableFuture<?> next = pending[currentSlot];
+    pending[currentSlot] = null;
+    inputBuffer = inputBuffers[currentSlot];
+    inputPosition = 0;
+    await(next);
+  }
+
+  /** Waits for a pipeline stage and rethrows its failure, if any. */
+  private static void await(CompletableFuture<?> stage) throws IOException {
+    if (stage == null) return;
+    try {
+      stage.join();
+    } catch (CompletionException e) {
+      Throwable cause = e.getCause();
+      if (cause instanceof UncheckedIOException) throw ((UncheckedIOException) cause).getCause();
+      if (cause instanceof RuntimeException) throw (RuntimeException) cause;
+      throw new IOException(cause);
+    }
   }
 }
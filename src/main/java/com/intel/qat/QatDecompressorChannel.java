@@ -0,0 +1,193 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
+
+import java.io.EOFException;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.channels.ClosedChannelException;
+import java.nio.channels.ReadableByteChannel;
+import java.util.Objects;
+
+/**
+ * This class implements a ReadableByteChannel that reads compressed data from another channel, such
+ * as a <code>FileChannel</code> or a <code>SocketChannel</code>, and decompresses it using Intel
+ * &reg; QuickAssist Technology (QAT).
+ *
+ * <p>Unlike {@link QatDecompressorInputStream}, this class buffers data in direct byte buffers
+ * from {@link QatBufferAllocator}, so compressed data never passes through the Java heap. When the
+ * destination of a read is a direct buffer with room for at least the buffer size, data is
+ * decompressed straight into it.
+ */
+public class QatDecompressorChannel implements ReadableByteChannel {
+  private final ReadableByteChannel in;
+  private final QatZipper qzip;
+  private final ByteBuffer inputBuffer;
+  private final ByteBuffer outputBuffer;
+  private boolean open;
+  private boolean eof;
+  private boolean inputEnded;
+
+  /** The default size in bytes of the input buffer (64KB). */
+  public static final int DEFAULT_BUFFER_SIZE = 1 << 16;
+
+  /**
+   * Creates a new channel with the given parameters.
+   *
+   * @param in the source channel
+   * @param bufferSize the input buffer size
+   * @param algorithm the compression algorithm (deflate or LZ4).
+   * @param mode the mode of operation (HARDWARE - only hardware, AUTO - hardware with a software
+   *     failover.)
+   * @param pmode the polling mode
+   */
+  public QatDecompressorChannel(
+      ReadableByteChannel in, int bufferSize, Algorithm algorithm, Mode mode, PollingMode pmode) {
+    if (bufferSize <= 0) throw new IllegalArgumentException();
+    this.in = Objects.requireNonNull(in);
+    qzip = new QatZipper(algorithm, mode, pmode);
+    inputBuffer = QatBufferAllocator.allocate(bufferSize);
+    outputBuffer = QatBufferAllocator.allocate(bufferSize);
+    outputBuffer.limit(0);
+    open = true;
+  }
+
+  /**
+   * Creates a new channel with the given parameters, {@link QatZipper#DEFAULT_MODE}, and {@link
+   * PollingMode#BUSY}.
+   *
+   * @param in the source channel
+   * @param bufferSize the input buffer size
+   * @param algorithm the compression algorithm (deflate or LZ4).
+   */
+  public QatDecompressorChannel(ReadableByteChannel in, int bufferSize, Algorithm algorithm) {
+    this(in, bufferSize, algorithm, QatZipper.DEFAULT_MODE, PollingMode.BUSY);
+  }
+
+  /**
+   * Creates a new channel with {@link Algorithm#DEFLATE}, {@link QatZipper#DEFAULT_MODE}, and
+   * {@link PollingMode#BUSY}.
+   *
+   * @param in the source channel
+   * @param bufferSize the input buffer size
+   */
+  public QatDecompressorChannel(ReadableByteChannel in, int bufferSize) {
+    this(in, bufferSize, Algorithm.DEFLATE);
+  }
+
+  /**
+   * Creates a new channel with {@link DEFAULT_BUFFER_SIZE}, {@link Algorithm#DEFLATE}, {@link
+   * QatZipper#DEFAULT_MODE}, and {@link PollingMode#BUSY}.
+   *
+   * @param in the source channel
+   */
+  public QatDecompressorChannel(ReadableByteChannel in) {
+    this(in, DEFAULT_BUFFER_SIZE, Algorithm.DEFLATE);
+  }
+
+  /**
+   * Reads decompressed data into the given buffer.
+   *
+   * @param dst the buffer into which the data is read
+   * @return the number of bytes read, possibly zero if the source channel is in non-blocking mode
+   *     and has no data available, or -1 if the end of the stream is reached
+   * @throws IOException if this channel is closed or an I/O error occurs
+   */
+  @Override
+  public int read(ByteBuffer dst) throws IOException {
+    if (!open) throw new ClosedChannelException();
+    if (!dst.hasRemaining()) return 0;
+    if (!outputBuffer.hasRemaining()) {
+      if (eof) return -1;
+      if (dst.isDirect() && dst.remaining() >= outputBuffer.capacity()) {
+        int decompressed = decode(dst);
+        if (decompressed < 0) eof = true;
+        return decompressed;
+      }
+      outputBuffer.clear();
+      int decompressed = decode(outputBuffer);
+      outputBuffer.flip();
+      if (decompressed < 0) {
+        eof = true;
+        return -1;
+      }
+    }
+    int len = Math.min(dst.remaining(), outputBuffer.remaining());
+    ByteBuffer chunk = outputBuffer.duplicate();
+    chunk.limit(chunk.position() + len);
+    dst.put(chunk);
+    outputBuffer.position(chunk.position());
+    return len;
+  }
+
+  /**
+   * Tells whether or not this channel is open.
+   *
+   * @return true if, and only if, this channel is open
+   */
+  @Override
+  public boolean isOpen() {
+    return open;
+  }
+
+  /**
+   * Closes this channel and releases resources. This method will close the source channel.
+   *
+   * @throws IOException if an I/O error occurs
+   */
+  @Override
+  public void close() throws IOException {
+    if (!open) return;
+    open = false;
+    try {
+      qzip.end();
+    } finally {
+      QatBufferAllocator.release(inputBuffer);
+      QatBufferAllocator.release(outputBuffer);
+      in.close();
+    }
+  }
+
+  /**
+   * Reads from the source channel and decompresses into the given buffer until at least one byte
+   * is produced, the source has no data available, or the input ends.
+   *
+   * @return the number of decompressed bytes, or -1 if the input has ended
+   */
+  private int decode(ByteBuffer dst) throws IOException {
+    while (!inputEnded) {
+      boolean wasFull = !inputBuffer.hasRemaining();
+      int bytesRead = in.read(inputBuffer);
+      inputBuffer.flip();
+      if (!inputBuffer.hasRemaining()) {
+        inputBuffer.clear();
+        if (bytesRead < 0) {
+          inputEnded = true;
+          break;
+        }
+        return 0;
+      }
+
+      int dstPos = dst.position();
+      qzip.decompress(inputBuffer, dst);
+      int decompressed = dst.position() - dstPos;
+      if (inputBuffer.hasRemaining()) {
+        if (decompressed == 0 && qzip.getBytesRead() == 0 && (bytesRead < 0 || wasFull))
+          throw new EOFException("Unexpected end of compressed stream");
+      } else if (bytesRead < 0) inputEnded = true;
+      inputBuffer.compact();
+
+      if (decompressed > 0) return decompressed;
+      if (bytesRead == 0 && !wasFull) return 0;
+    }
+    return -1;
+  }
+}
@@ -7,13 +7,22 @@
 package com.intel.qat;
 
 import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Format;
 import static com.intel.qat.QatZipper.Mode;
 import static com.intel.qat.QatZipper.PollingMode;
 
+import java.io.EOFException;
 import java.io.FilterInputStream;
 import java.io.IOException;
 import java.io.InputStream;
+import java.io.InterruptedIOException;
 import java.util.Objects;
+import java.util.concurrent.ArrayBlockingQueue;
+import java.util.concurrent.BlockingQueue;
+import java.util.concurrent.CancellationException;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.Future;
+import java.util.concurrent.LinkedBlockingQueue;
 
 /**
  * This class implements an InputStream filter that decompresses data using Intel &reg; QuickAssist
@@ -29,35 +38,166 @@ public class QatDecompressorInputStream extends FilterInputStream {
   private QatZipper qzip;
   private boolean closed;
   private boolean eof;
+  private boolean inputEnded;
+
+  // State of the read-ahead mode; only used when readAhead > 0.
+  private final int readAhead;
+  private BlockingQueue<byte[]> freeBuffers;
+  private BlockingQueue<Block> readyBlocks;
+  private Future<?> producer;
+  private volatile boolean stopped;
+  private IOException failure;
+
+  // The native stream state of the streaming mode, or 0.
+  private long stream;
+
+  private static final byte[] EMPTY = new byte[0];
 
   /** The default size in bytes of the input buffer (64KB). */
   public static final int DEFAULT_BUFFER_SIZE = 1 << 16;
 
+  /** The default number of blocks decompressed ahead of the reader. 0 disables read-ahead. */
+  public static final int DEFAULT_READ_AHEAD = 0;
+
   /**
    * Creates a new input stream with the given parameters.
    *
+   * <p>If <code>readAhead</code> is greater than 0, a background task reads from the underlying
+   * stream and decompresses up to that many blocks ahead of the reader, so that reads mostly copy
+   * already decompressed data. Errors from the background task are reported by a later call to
+   * <code>read</code>.
+   *
    * @param in the input stream
    * @param bufferSize the input buffer size
    * @param algorithm the compression algorithm (deflate or LZ4).
    * @param mode the mode of operation (HARDWARE - only hardware, AUTO - hardware with a software
    *     failover.)
    * @param pmode the polling mode
+   * @param readAhead the number of blocks decompressed ahead of the reader
    */
   public QatDecompressorInputStream(
-      InputStream in, int bufferSize, Algorithm algorithm, Mode mode, PollingMode pmode) {
+      InputStream in,
+      int bufferSize,
+      Algorithm algorithm,
+      Mode mode,
+      PollingMode pmode,
+      int readAhead) {
+    this(in, bufferSize, algorithm, QatZipper.DEFAULT_FORMAT, mode, pmode, readAhead, false);
+  }
+
+  /**
+   * Creates a new input stream with the given parameters that, if <code>streaming</code> is true,
+   * decompresses through a QATzip stream.
+   *
+   * <p>In streaming mode a compressed block may span any number of reads from the underlying
+   * stream, so the input buffer need not hold a whole block.
+   *
+   * @param in the input stream
+   * @param bufferSize the input buffer size
+   * @param algorithm the compression algorithm (deflate or LZ4).
+   * @param mode the mode of operation (HARDWARE - only hardware, AUTO - hardware with a software
+   *     failover.)
+   * @param pmode the polling mode
+   * @param streaming whether to decompress through a QATzip stream
+   */
+  public QatDecompressorInputStream(
+      InputStream in,
+      int bufferSize,
+      Algorithm algorithm,
+      Mode mode,
+      PollingMode pmode,
+      boolean streaming) {
+    this(
+        in,
+        bufferSize,
+        algorithm,
+        QatZipper.DEFAULT_FORMAT,
+        mode,
+        pmode,
+        DEFAULT_READ_AHEAD,
+        streaming);
+  }
+
+  /**
+   * Creates a new input stream with the given parameters that decompresses {@link
+   * Algorithm#DEFLATE} data in the given {@link Format}, for example a standard gzip file with
+   * {@link Format#GZIP}. Only the gzip formats can be read from a stream; see {@link
+   * QatCompressorOutputStream#QatCompressorOutputStream(OutputStream, int, Format, int, Mode,
+   * PollingMode)}.
+   *
+   * @param in the input stream
+   * @param bufferSize the input buffer size
+   * @param format the format of the compressed data ({@link Format#GZIP_EXT} or {@link
+   *     Format#GZIP}).
+   * @param mode the mode of operation (HARDWARE - only hardware, AUTO - hardware with a software
+   *     failover.)
+   * @param pmode the polling mode
+   * @param streaming whether to decompress through a QATzip stream
+   * @throws IllegalArgumentException if <code>format</code> is not a gzip format.
+   */
+  public QatDecompressorInputStream(
+      InputStream in,
+      int bufferSize,
+      Format format,
+      Mode mode,
+      PollingMode pmode,
+      boolean streaming) {
+    this(in, bufferSize, Algorithm.DEFLATE, format, mode, pmode, DEFAULT_READ_AHEAD, streaming);
+  }
+
+  private QatDecompressorInputStream(
+      InputStream in,
+      int bufferSize,
+      Algorithm algorithm,
+      Format format,
+      Mode mode,
+      PollingMode pmode,
+      int readAhead,
+      boolean streaming) {
     super(in);
-    if (bufferSize <= 0) throw new IllegalArgumentException();
+    if (bufferSize <= 0 || readAhead < 0) throw new IllegalArgumentException();
+    if (format == Format.ZLIB || format == Format.RAW)
+      throw new IllegalArgumentException("Streams only support the gzip formats.");
     Objects.requireNonNull(in);
     inputBuffer = new byte[bufferSize];
     outputBuffer = new byte[bufferSize];
     outputPosition = outputBuffer.length;
     inputBufferLimit = bufferSize;
     outputBufferLimit = bufferSize;
-    qzip = new QatZipper(algorithm, mode, pmode);
+    qzip =
+        format == QatZipper.DEFAULT_FORMAT
+            ? new QatZipper(algorithm, mode, pmode)
+            : new QatZipper(format, QatZipper.DEFAULT_COMPRESS_LEVEL, mode, pmode);
+    this.readAhead = readAhead;
+    if (readAhead > 0) {
+      // One buffer is held by the reader while the others are being filled.
+      freeBuffers = new ArrayBlockingQueue<>(readAhead + 1);
+      for (int i = 0; i < readAhead; i++) freeBuffers.add(new byte[bufferSize]);
+      readyBlocks = new LinkedBlockingQueue<>();
+    }
+    if (streaming) {
+      stream = qzip.createStream();
+      inputBufferLimit = 0;
+    }
     closed = false;
     eof = false;
   }
 
+  /**
+   * Creates a new input stream with the given parameters and {@link DEFAULT_READ_AHEAD}.
+   *
+   * @param in the input stream
+   * @param bufferSize the input buffer size
+   * @param algorithm the compression algorithm (deflate or LZ4).
+   * @param mode the mode of operation (HARDWARE - only hardware, AUTO - hardware with a software
+   *     failover.)
+   * @param pmode the polling mode
+   */
+  public QatDecompressorInputStream(
+      InputStream in, int bufferSize, Algorithm algorithm, Mode mode, PollingMode pmode) {
+    this(in, bufferSize, algorithm, mode, pmode, DEFAULT_READ_AHEAD);
+  }
+
   /**
    * Creates a new input stream with {@link DEFAULT_BUFFER_SIZE}, {@link Algorithm#DEFLATE}, {@link
    * QatZipper#DEFAULT_MODE}, and {@link PollingMode#BUSY}.
@@ -229,11 +369,19 @@ public class QatDecompressorInputStream extends FilterInputStream {
   @Override
   public void close() throws IOException {
     if (closed) return;
-    qzip.end();
-    in.close();
-    inputBuffer = null;
-    outputBuffer = null;
     closed = true;
+    try {
+      if (producer != null) stopReadAhead();
+    } finally {
+      try {
+        if (stream != 0) qzip.endStream(stream);
+      } finally {
+        qzip.end();
+        in.close();
+        inputBuffer = null;
+        outputBuffer = null;
+      }
+    }
   }
 
   /** Marks the current position in this input stream. This method does nothing. */
@@ -263,50 +411,192 @@ public class QatDecompressorInputStream extends FilterInputStream {
   }
 
   /**
-   * Skips up to n bytes of compressed bytes.
+   * Skips up to n bytes of uncompressed data. The data is decompressed into the output buffer and
+   * dropped there, so skipping allocates nothing. To skip without decompressing, use a {@link
+   * QatSeekableInputStream}.
    *
    * @param n the maximum number of bytes to skip
    * @return the number of bytes skipped or 0 if n is negative.
+   * @throws IOException if the stream is closed
    */
   @Override
   public long skip(long n) throws IOException {
-    if (n < 0) return 0;
-    return read(new byte[(int) n]);
+    if (closed) throw new IOException("Stream is closed");
+    long skipped = 0;
+    while (skipped < n) {
+      if (outputPosition == outputBufferLimit) {
+        if (eof) break;
+        fill();
+        continue;
+      }
+      int len = (int) Math.min(n - skipped, outputBufferLimit - outputPosition);
+      outputPosition += len;
+      skipped += len;
+    }
+    return skipped;
   }
 
   private void fill() throws IOException {
     if (eof) return;
-    int bytesRead = in.read(inputBuffer, inputPosition, inputBuffer.length - inputPosition);
-    inputBufferLimit = (inputPosition + Math.max(0, bytesRead));
-    inputPosition = 0;
-    if (bytesRead < 0 && inputBufferLimit == 0) {
-      eof = true;
+    if (readAhead > 0) {
+      fillFromReadAhead();
       return;
     }
-    outputPosition = 0;
-    outputBufferLimit = outputBuffer.length;
-    int decompressed =
-        qzip.decompress(
-            inputBuffer,
-            inputPosition,
-            inputBufferLimit,
-            outputBuffer,
-            outputPosition,
-            outputBufferLimit - outputPosition);
-    inputPosition += qzip.getBytesRead();
-    outputPosition += decompressed;
-    outputBufferLimit = outputPosition;
-    outputPosition = 0;
-    if (inputPosition != inputBufferLimit) {
-      System.arraycopy(
-          inputBuffer, inputPosition, inputBuffer, 0, inputBufferLimit - inputPosition);
-      inputPosition = inputBufferLimit - inputPosition;
-      inputBufferLimit = inputBuffer.length;
-    } else if (bytesRead < 0 && inputPosition == inputBufferLimit) eof = true;
-    else {
+    outputPosition = outputBufferLimit = 0;
+    if (stream != 0) {
+      int decompressed = decodeStream(outputBuffer);
+      if (decompressed > 0) outputBufferLimit = decompressed;
+      else eof = true;
+      return;
+    }
+    int decompressed = decode(outputBuffer);
+    if (decompressed > 0) outputBufferLimit = decompressed;
+    if (inputEnded) eof = true;
+  }
+
+  /**
+   * Reads from the underlying stream and decompresses into the given buffer until at least one
+   * byte is produced or the input ends.
+   *
+   * @return the number of decompressed bytes, or -1 if the input has ended
+   */
+  private int decode(byte[] dst) throws IOException {
+    while (!inputEnded) {
+      int bytesRead = in.read(inputBuffer, inputPosition, inputBuffer.length - inputPosition);
+      inputBufferLimit = (inputPosition + Math.max(0, bytesRead));
       inputPosition = 0;
+      if (bytesRead < 0 && inputBufferLimit == 0) {
+        inputEnded = true;
+        break;
+      }
+      int decompressed = qzip.decompress(inputBuffer, 0, inputBufferLimit, dst, 0, dst.length);
+      int consumed = qzip.getBytesRead();
+      if (consumed != inputBufferLimit) {
+        if (decompressed == 0
+            && consumed == 0
+            && (bytesRead < 0 || inputBufferLimit == inputBuffer.length))
+          throw new EOFException("Unexpected end of compressed stream");
+        System.arraycopy(inputBuffer, consumed, inputBuffer, 0, inputBufferLimit - consumed);
+        inputPosition = inputBufferLimit - consumed;
+      } else if (bytesRead < 0) inputEnded = true;
       inputBufferLimit = inputBuffer.length;
+      if (decompressed > 0) return decompressed;
+    }
+    return -1;
+  }
+
+  /**
+   * Reads from the underlying stream and decompresses through the QATzip stream into the given
+   * buffer until at least one byte is produced or the input ends.
+   *
+   * @return the number of decompressed bytes, or -1 if the input has ended
+   */
+  private int decodeStream(byte[] dst) throws IOException {
+    while (true) {
+      if (inputPosition == inputBufferLimit && !inputEnded) {
+        int bytesRead = in.read(inputBuffer, 0, inputBuffer.length);
+        inputPosition = 0;
+        inputBufferLimit = Math.max(0, bytesRead);
+        if (bytesRead < 0) inputEnded = true;
+      }
+      int decompressed =
+          qzip.decompressStream(
+              stream,
+              inputBuffer,
+              inputPosition,
+              inputBufferLimit - inputPosition,
+              dst,
+              0,
+              dst.length,
+              inputEnded);
+      int consumed = qzip.getBytesRead();
+      inputPosition += consumed;
+      if (decompressed > 0) return decompressed;
+      if (consumed == 0 && inputEnded) {
+        if (inputPosition == inputBufferLimit && !qzip.streamPending(stream)) return -1;
+        throw new EOFException("Unexpected end of compressed stream");
+      }
+      if (consumed == 0 && inputPosition < inputBufferLimit)
+        throw new IOException("Compressed stream is malformed");
+    }
+  }
+
+  private void fillFromReadAhead() throws IOException {
+    if (failure != null) throw failure;
+    if (producer == null) producer = QatZipper.StreamExecutor.INSTANCE.submit(this::produce);
+    if (outputBuffer != EMPTY) freeBuffers.add(outputBuffer);
+    outputBuffer = EMPTY;
+    outputPosition = outputBufferLimit = 0;
+
+    Block block;
+    try {
+      block = readyBlocks.take();
+    } catch (InterruptedException e) {
+      Thread.currentThread().interrupt();
+      throw new InterruptedIOException();
+    }
+    if (block.error != null) {
+      failure =
+          block.error instanceof IOException
+              ? (IOException) block.error
+              : new IOException(block.error);
+      if (block.error instanceof RuntimeException) throw (RuntimeException) block.error;
+      throw failure;
+    }
+    if (block.data == null) {
+      eof = true;
+      return;
+    }
+    outputBuffer = block.data;
+    outputBufferLimit = block.length;
+  }
+
+  /** Decompresses blocks ahead of the reader until the input ends or the stream is closed. */
+  private void produce() {
+    try {
+      while (!stopped) {
+        byte[] buf = freeBuffers.take();
+        if (stopped) return;
+        int decompressed = decode(buf);
+        if (decompressed < 0) break;
+        readyBlocks.add(new Block(buf, decompressed, null));
+        if (inputEnded) break;
+      }
+      readyBlocks.add(Block.END);
+    } catch (Throwable t) {
+      if (!stopped) readyBlocks.add(new Block(null, 0, t));
+    }
+  }
+
+  /** Stops the read-ahead task and waits until it no longer uses the session or the input. */
+  private void stopReadAhead() throws IOException {
+    stopped = true;
+    // Unblock a producer waiting for a free buffer; one blocked in a read is unblocked, for most
+    // streams, by closing the input.
+    freeBuffers.offer(EMPTY);
+    in.close();
+    try {
+      producer.get();
+    } catch (ExecutionException | CancellationException e) {
+      // The producer reports its own errors through readyBlocks.
+    } catch (InterruptedException e) {
+      Thread.currentThread().interrupt();
+      throw new InterruptedIOException();
+    }
+  }
+
+  /** A decompressed block, the end of the input, or a failure of the read-ahead task. */
+  private static final class Block {
+    static final Block END = new Block(null, 0, null);
+
+    final byte[] data;
+    final int length;
+    final Throwable error;
+
+    Block(byte[] data, int length, Throwable error) {
+      this.data = data;
+      this.length = length;
+      this.error = error;
     }
-    if (decompressed == 0) fill();
   }
 }
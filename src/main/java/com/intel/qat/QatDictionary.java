@@ -0,0 +1,186 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collection;
+import java.util.Comparator;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.Objects;
+import java.util.zip.Adler32;
+
+/**
+ * A preset dictionary for compressing small records that share content with each other, such as
+ * JSON documents with the same keys. Each record is compressed as if it followed the dictionary, so
+ * content the record shares with the dictionary costs only a back-reference.
+ *
+ * <p>QAT hardware has no support for preset dictionaries, so a {@link QatZipper} created with a
+ * dictionary sets up no QAT session, only accepts {@link QatZipper.Mode#AUTO}, and compresses and
+ * decompresses in software. Its data is in none of the {@link QatZipper.Format}s, so {@link
+ * QatZipper#getFormat()} throws. {@link QatZipper.Algorithm#DEFLATE} then produces zlib streams
+ * (RFC 1950) that can also be decompressed by {@link java.util.zip.Inflater} with the same
+ * dictionary; {@link QatZipper.Algorithm#LZ4} produces LZ4 blocks, each preceded by an 8-byte
+ * header holding the compressed and the uncompressed size in little-endian order. Data compressed
+ * with a dictionary can only be decompressed with the same dictionary.
+ */
+public final class QatDictionary {
+  /**
+   * The maximum size of a dictionary in bytes (64KB). DEFLATE only uses the last 32KB of a larger
+   * dictionary.
+   */
+  public static final int MAX_SIZE = 1 << 16;
+
+  /** The number of sample bytes considered by {@link #train} (2MB); later samples are ignored. */
+  public static final int MAX_TRAINING_BYTES = 1 << 21;
+
+  // The length of the segments whose occurrences are counted during training.
+  private static final int SEGMENT_LENGTH = 8;
+
+  // The maximum length of a piece of a sample copied into a trained dictionary.
+  private static final int MAX_PIECE_LENGTH = 1024;
+
+  private final byte[] data;
+
+  /**
+   * Creates a dictionary with the given content. The most common content should come last, where
+   * it is closest to the data being compressed.
+   *
+   * @param data the dictionary content, at most {@link #MAX_SIZE} bytes
+   */
+  public QatDictionary(byte[] data) {
+    Objects.requireNonNull(data);
+    if (data.length == 0 || data.length > MAX_SIZE)
+      throw new IllegalArgumentException("Invalid dictionary size.");
+    this.data = data.clone();
+  }
+
+  /**
+   * Trains a dictionary from samples of the records it will compress. The dictionary is made of
+   * the pieces of the samples that are shared by the most samples, with the most widely shared
+   * pieces last.
+   *
+   * <p>Training is meant to run offline, on a few hundred to a few thousand representative
+   * records; only the first {@link #MAX_TRAINING_BYTES} bytes of samples are considered.
+   *
+   * @param samples the sample records
+   * @param size the maximum size of the dictionary, at most {@link #MAX_SIZE} bytes
+   * @return the trained dictionary.
+   * @throws IllegalArgumentException if the samples have no content in common.
+   */
+  public static QatDictionary train(Collection<byte[]> samples, int size) {
+    Objects.requireNonNull(samples);
+    if (size <= 0 || size > MAX_SIZE)
+      throw new IllegalArgumentException("Invalid dictionary size.");
+
+    // Count the number of samples each segment occurs in.
+    Map<Long, Segment> segments = new LinkedHashMap<>();
+    int sampleIndex = 0;
+    long total = 0;
+    for (byte[] sample : samples) {
+      if (total >= MAX_TRAINING_BYTES) break;
+      total += sample.length;
+      for (int i = 0; i + SEGMENT_LENGTH <= sample.length; i++) {
+        Segment s = segments.computeIfAbsent(segmentKey(sample, i), k -> new Segment());
+        if (s.count == 0) {
+          s.sample = sample;
+          s.offset = i;
+        }
+        if (s.lastSample != sampleIndex) {
+          s.lastSample = sampleIndex;
+          s.count++;
+        }
+      }
+      sampleIndex++;
+    }
+
+    List<Segment> ranked = new ArrayList<>();
+    for (Segment s : segments.values()) if (s.count > 1) ranked.add(s);
+    ranked.sort(Comparator.comparingInt((Segment s) -> s.count).reversed());
+
+    // Extend each shared segment over the following bytes while they are about as widely shared,
+    // skipping segments already covered by a previous piece.
+    List<byte[]> pieces = new ArrayList<>();
+    int used = 0;
+    for (Segment s : ranked) {
+      if (used == size) break;
+      if (s.taken) continue;
+      s.taken = true;
+      int end = s.offset + SEGMENT_LENGTH;
+      while (end < s.sample.length && end - s.offset < MAX_PIECE_LENGTH) {
+        Segment next = segments.get(segmentKey(s.sample, end - SEGMENT_LENGTH + 1));
+        if (next.count * 2 < s.count) break;
+        next.taken = true;
+        end++;
+      }
+      int len = Math.min(end - s.offset, size - used);
+      pieces.add(Arrays.copyOfRange(s.sample, s.offset, s.offset + len));
+      used += len;
+    }
+    if (used == 0) throw new IllegalArgumentException("The samples have no content in common.");
+
+    byte[] dict = new byte[used];
+    int pos = used;
+    for (byte[] piece : pieces) {
+      pos -= piece.length;
+      System.arraycopy(piece, 0, dict, pos, piece.length);
+    }
+    return new QatDictionary(dict);
+  }
+
+  private static long segmentKey(byte[] b, int off) {
+    long key = 0;
+    for (int i = 0; i < SEGMENT_LENGTH; i++) key = (key << 8) | (b[off + i] & 0xFF);
+    return key;
+  }
+
+  /**
+   * Returns a copy of the dictionary content.
+   *
+   * @return the dictionary content.
+   */
+  public byte[] getBytes() {
+    return data.clone();
+  }
+
+  /**
+   * Returns the size of the dictionary in bytes.
+   *
+   * @return the dictionary size.
+   */
+  public int size() {
+    return data.length;
+  }
+
+  /**
+   * Returns the Adler-32 checksum of the dictionary, which zlib streams compressed with it record
+   * as the dictionary identifier.
+   *
+   * @return the dictionary identifier.
+   */
+  public long getId() {
+    Adler32 adler = new Adler32();
+    adler.update(data);
+    return adler.getValue();
+  }
+
+  /** Returns the dictionary content without copying it. */
+  byte[] bytes() {
+    return data;
+  }
+
+  /** A segment of the samples and the number of samples it occurs in. */
+  private static final class Segment {
+    byte[] sample;
+    int offset;
+    int count;
+    int lastSample = -1;
+    boolean taken;
+  }
+}
@@ -7,12 +7,36 @@ package com.intel.qat;
 
 /** Signals that a QAT error has occurred. */
 public class QatException extends RuntimeException {
+  private final int errorCode;
+
   /**
    * Constructs a QatException with the specified detail message.
    *
    * @param message the string containing a detail message
    */
   public QatException(String message) {
+    this(message, 0);
+  }
+
+  /**
+   * Constructs a QatException with the specified detail message and QATzip status code.
+   *
+   * @param message the string containing a detail message
+   * @param errorCode the QATzip status code of the failed call
+   */
+  public QatException(String message, int errorCode) {
     super(message);
+    this.errorCode = errorCode;
+  }
+
+  /**
+   * Returns the QATzip status code of the failed call, for example -103 (<code>
+   * QZ_NOSW_NO_INST_ATTACH</code>) if no QAT instance was available in {@link
+   * QatZipper.Mode#HARDWARE}.
+   *
+   * @return the status code, or 0 if the error did not come from QATzip.
+   */
+  public int getErrorCode() {
+    return errorCode;
   }
 }
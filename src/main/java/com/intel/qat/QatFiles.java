@@ -0,0 +1,247 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
+
+import java.io.EOFException;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.file.Path;
+import java.nio.file.StandardOpenOption;
+
+/**
+ * This class consists of static methods that compress and decompress whole files. The input file
+ * is memory-mapped in large windows that are passed to QAT through the direct-buffer path, and the
+ * output is written from a direct buffer to a <code>FileChannel</code>, so file data never passes
+ * through the Java heap.
+ *
+ * <p>The compressed format is the same as that of {@link QatCompressorOutputStream}, so files
+ * written by either can be read by {@link #decompress} and by {@link QatDecompressorInputStream}.
+ */
+public final class QatFiles {
+  /** The size in bytes of the input window mapped at a time (64MB). */
+  static final int WINDOW_SIZE = 1 << 26;
+
+  private QatFiles() {}
+
+  /** Compresses a source buffer into a destination buffer, advancing both positions. */
+  private interface BufferCodec {
+    int apply(ByteBuffer src, ByteBuffer dst);
+  }
+
+  /**
+   * Compresses a file.
+   *
+   * @param in the file to compress
+   * @param out the file to write the compressed data to; it is created or truncated
+   * @param algorithm the compression algorithm (deflate or LZ4).
+   * @param level the compression level.
+   * @param mode the mode of operation (HARDWARE - only hardware, AUTO - hardware with a software
+   *     failover.)
+   * @param pmode the polling mode
+   * @param parallelism the number of sessions that compress the file concurrently; if greater than
+   *     1, the file is compressed by a {@link QatParallelZipper}
+   * @return the size of the compressed file in bytes
+   * @throws IOException if an I/O error occurs
+   */
+  public static long compress(
+      Path in,
+      Path out,
+      Algorithm algorithm,
+      int level,
+      Mode mode,
+      PollingMode pmode,
+      int parallelism)
+      throws IOException {
+    return compress(in, out, algorithm, level, mode, pmode, parallelism, WINDOW_SIZE);
+  }
+
+  /** Compresses a file, mapping windows of the given size. */
+  static long compress(
+      Path in,
+      Path out,
+      Algorithm algorithm,
+      int level,
+      Mode mode,
+      PollingMode pmode,
+      int parallelism,
+      int windowSize)
+      throws IOException {
+    if (parallelism <= 0 || windowSize <= 0) throw new IllegalArgumentException();
+
+    if (parallelism > 1) {
+      QatParallelZipper pzip =
+          new QatParallelZipper(
+              algorithm,
+              level,
+              mode,
+              pmode,
+              QatParallelZipper.DEFAULT_BLOCK_SIZE,
+              parallelism,
+              QatParallelZipper.BlockExecutor.INSTANCE);
+      int outputSize = (int) pzip.maxCompressedLength(windowSize);
+      return compress(in, out, pzip::compress, windowSize, outputSize);
+    }
+
+    QatZipper qzip = new QatZipper(algorithm, level, mode, pmode);
+    try {
+      return compress(in, out, qzip::compress, windowSize, qzip.maxCompressedLength(windowSize));
+    } finally {
+      qzip.end();
+    }
+  }
+
+  /**
+   * Compresses a file with a single session, {@link QatZipper#DEFAULT_COMPRESS_LEVEL}, {@link
+   * QatZipper#DEFAULT_MODE}, and {@link PollingMode#BUSY}.
+   *
+   * @param in the file to compress
+   * @param out the file to write the compressed data to; it is created or truncated
+   * @param algorithm the compression algorithm (deflate or LZ4).
+   * @return the size of the compressed file in bytes
+   * @throws IOException if an I/O error occurs
+   */
+  public static long compress(Path in, Path out, Algorithm algorithm) throws IOException {
+    return compress(
+        in,
+        out,
+        algorithm,
+        QatZipper.DEFAULT_COMPRESS_LEVEL,
+        QatZipper.DEFAULT_MODE,
+        PollingMode.BUSY,
+        1);
+  }
+
+  /**
+   * Compresses a file with a single session, {@link Algorithm#DEFLATE}, {@link
+   * QatZipper#DEFAULT_COMPRESS_LEVEL}, {@link QatZipper#DEFAULT_MODE}, and {@link
+   * PollingMode#BUSY}.
+   *
+   * @param in the file to compress
+   * @param out the file to write the compressed data to; it is created or truncated
+   * @return the size of the compressed file in bytes
+   * @throws IOException if an I/O error occurs
+   */
+  public static long compress(Path in, Path out) throws IOException {
+    return compress(in, out, Algorithm.DEFLATE);
+  }
+
+  /**
+   * Decompresses a file.
+   *
+   * @param in the file to decompress
+   * @param out the file to write the decompressed data to; it is created or truncated
+   * @param algorithm the compression algorithm (deflate or LZ4).
+   * @param mode the mode of operation (HARDWARE - only hardware, AUTO - hardware with a software
+   *     failover.)
+   * @param pmode the polling mode
+   * @return the size of the decompressed file in bytes
+   * @throws IOException if an I/O error occurs or the compressed file is truncated
+   */
+  public static long decompress(
+      Path in, Path out, Algorithm algorithm, Mode mode, PollingMode pmode) throws IOException {
+    return decompress(in, out, algorithm, mode, pmode, WINDOW_SIZE);
+  }
+
+  /** Decompresses a file, mapping windows of the given size. */
+  static long decompress(
+      Path in, Path out, Algorithm algorithm, Mode mode, PollingMode pmode, int windowSize)
+      throws IOException {
+    if (windowSize <= 0) throw new IllegalArgumentException();
+    QatZipper qzip = new QatZipper(algorithm, mode, pmode);
+    ByteBuffer buffer = QatBufferAllocator.allocate(windowSize);
+    // A member holds at most one window of data, so an input window of its worst-case compressed
+    // size always holds at least one whole member.
+    int inputSize = qzip.maxCompressedLength(windowSize);
+    try (FileChannel src = FileChannel.open(in, StandardOpenOption.READ);
+        FileChannel dst = openOutput(out)) {
+      long size = src.size();
+      long position = 0;
+      long written = 0;
+      while (position < size) {
+        long len = Math.min(inputSize, size - position);
+        ByteBuffer window = src.map(FileChannel.MapMode.READ_ONLY, position, len);
+        buffer.clear();
+        qzip.decompress(window, buffer);
+        if (qzip.getBytesRead() == 0)
+          throw new EOFException("Unexpected end of compressed file " + in);
+        position += qzip.getBytesRead();
+        buffer.flip();
+        written += writeFully(dst, buffer);
+      }
+      return written;
+    } finally {
+      QatBufferAllocator.release(buffer);
+      qzip.end();
+    }
+  }
+
+  /**
+   * Decompresses a file with {@link QatZipper#DEFAULT_MODE} and {@link PollingMode#BUSY}.
+   *
+   * @param in the file to decompress
+   * @param out the file to write the decompressed data to; it is created or truncated
+   * @param algorithm the compression algorithm (deflate or LZ4).
+   * @return the size of the decompressed file in bytes
+   * @throws IOException if an I/O error occurs or the compressed file is truncated
+   */
+  public static long decompress(Path in, Path out, Algorithm algorithm) throws IOException {
+    return decompress(in, out, algorithm, QatZipper.DEFAULT_MODE, PollingMode.BUSY);
+  }
+
+  /**
+   * Decompresses a file with {@link Algorithm#DEFLATE}, {@link QatZipper#DEFAULT_MODE}, and
+   * {@link PollingMode#BUSY}.
+   *
+   * @param in the file to decompress
+   * @param out the file to write the decompressed data to; it is created or truncated
+   * @return the size of the decompressed file in bytes
+   * @throws IOException if an I/O error occurs or the compressed file is truncated
+   */
+  public static long decompress(Path in, Path out) throws IOException {
+    return decompress(in, out, Algorithm.DEFLATE);
+  }
+
+  private static long compress(
+      Path in, Path out, BufferCodec codec, int windowSize, int outputSize) throws IOException {
+    ByteBuffer buffer = QatBufferAllocator.allocate(outputSize);
+    try (FileChannel src = FileChannel.open(in, StandardOpenOption.READ);
+        FileChannel dst = openOutput(out)) {
+      long size = src.size();
+      long written = 0;
+      for (long position = 0; position < size; position += windowSize) {
+        long len = Math.min(windowSize, size - position);
+        ByteBuffer window = src.map(FileChannel.MapMode.READ_ONLY, position, len);
+        buffer.clear();
+        codec.apply(window, buffer);
+        buffer.flip();
+        written += writeFully(dst, buffer);
+      }
+      return written;
+    } finally {
+      QatBufferAllocator.release(buffer);
+    }
+  }
+
+  private static FileChannel openOutput(Path out) throws IOException {
+    return FileChannel.open(
+        out,
+        StandardOpenOption.CREATE,
+        StandardOpenOption.WRITE,
+        StandardOpenOption.TRUNCATE_EXISTING);
+  }
+
+  private static int writeFully(FileChannel channel, ByteBuffer buffer) throws IOException {
+    int len = buffer.remaining();
+    while (buffer.hasRemaining()) channel.write(buffer);
+    return len;
+  }
+}
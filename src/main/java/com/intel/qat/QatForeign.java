@@ -0,0 +1,55 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+/**
+ * The foreign function backend, which calls the native library through java.lang.foreign instead
+ * of JNI for heap arrays: their data is copied to and from native memory rather than pinned with
+ * GetPrimitiveArrayCritical, so that a request never holds off the garbage collector while it runs
+ * on QAT.
+ *
+ * <p>This version, for JDK releases before 22, is never enabled and JNI is always used. The jar
+ * carries the implementation for JDK 22 and later under <code>META-INF/versions/22</code>.
+ */
+final class QatForeign {
+  private QatForeign() {}
+
+  /**
+   * Returns true if byte array requests use the foreign function backend.
+   *
+   * @return false
+   */
+  static boolean isEnabled() {
+    return false;
+  }
+
+  /** Compresses a byte array; see InternalJNI.compressByteArray. */
+  static long compressByteArray(
+      long session,
+      byte[] src,
+      int srcOffset,
+      int srcLen,
+      byte[] dst,
+      int dstOffset,
+      int dstLen,
+      int retryCount) {
+    throw new UnsupportedOperationException();
+  }
+
+  /** Decompresses a byte array; see InternalJNI.decompressByteArray. */
+  static long decompressByteArray(
+      long session,
+      byte[] src,
+      int srcOffset,
+      int srcLen,
+      byte[] dst,
+      int dstOffset,
+      int dstLen,
+      int retryCount) {
+    throw new UnsupportedOperationException();
+  }
+}
@@ -0,0 +1,199 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import java.io.DataInputStream;
+import java.io.DataOutputStream;
+import java.io.IOException;
+import java.io.InputStream;
+import java.io.OutputStream;
+import java.util.Arrays;
+import java.util.zip.CRC32;
+import java.util.zip.CheckedInputStream;
+import java.util.zip.CheckedOutputStream;
+
+/**
+ * The member boundaries of a stream of independently compressed members, such as the gzip members
+ * or LZ4 frames {@link QatParallelZipper} produces. The index records where each member starts in
+ * the compressed stream and how much data it decompresses to, so that the members can be
+ * decompressed concurrently, or a member found by its uncompressed offset, without reading the
+ * members before it.
+ *
+ * <p>An index is written next to the compressed stream, as a sidecar, with {@link
+ * #writeTo(OutputStream)}. Its serialized form is the magic "QIDX", a version, the number of
+ * members and, for each member, its compressed and uncompressed lengths, all big-endian, followed
+ * by the CRC-32 of what precedes it.
+ */
+public final class QatIndex {
+  private static final int MAGIC = 0x51494458; // "QIDX"
+  private static final int VERSION = 1;
+
+  /** The compressed offsets of the members, followed by the compressed size. */
+  private long[] compressedOffsets;
+
+  /** The uncompressed offsets of the members, followed by the uncompressed size. */
+  private long[] uncompressedOffsets;
+
+  private int size;
+
+  /** Creates an empty index. */
+  QatIndex() {
+    compressedOffsets = new long[16 + 1];
+    uncompressedOffsets = new long[16 + 1];
+  }
+
+  /** Appends a member of the given lengths. */
+  void add(int compressedLength, int uncompressedLength) {
+    if (size + 1 == compressedOffsets.length) {
+      compressedOffsets = Arrays.copyOf(compressedOffsets, 2 * size + 1);
+      uncompressedOffsets = Arrays.copyOf(uncompressedOffsets, 2 * size + 1);
+    }
+    compressedOffsets[size + 1] = compressedOffsets[size] + compressedLength;
+    uncompressedOffsets[size + 1] = uncompressedOffsets[size] + uncompressedLength;
+    size++;
+  }
+
+  /**
+   * Returns the number of members.
+   *
+   * @return the number of members.
+   */
+  public int size() {
+    return size;
+  }
+
+  /**
+   * Returns the offset of a member in the compressed stream.
+   *
+   * @param member the index of the member
+   * @return the compressed offset of the member.
+   */
+  public long compressedOffset(int member) {
+    return compressedOffsets[checkMember(member)];
+  }
+
+  /**
+   * Returns the compressed length of a member.
+   *
+   * @param member the index of the member
+   * @return the compressed length of the member.
+   */
+  public int compressedLength(int member) {
+    checkMember(member);
+    return (int) (compressedOffsets[member + 1] - compressedOffsets[member]);
+  }
+
+  /**
+   * Returns the offset of the data of a member in the uncompressed stream.
+   *
+   * @param member the index of the member
+   * @return the uncompressed offset of the member.
+   */
+  public long uncompressedOffset(int member) {
+    return uncompressedOffsets[checkMember(member)];
+  }
+
+  /**
+   * Returns the length of the data a member decompresses to.
+   *
+   * @param member the index of the member
+   * @return the uncompressed length of the member.
+   */
+  public int uncompressedLength(int member) {
+    checkMember(member);
+    return (int) (uncompressedOffsets[member + 1] - uncompressedOffsets[member]);
+  }
+
+  /**
+   * Returns the size of the compressed stream.
+   *
+   * @return the sum of the compressed lengths of the members.
+   */
+  public long compressedSize() {
+    return compressedOffsets[size];
+  }
+
+  /**
+   * Returns the size of the uncompressed stream.
+   *
+   * @return the sum of the uncompressed lengths of the members.
+   */
+  public long uncompressedSize() {
+    return uncompressedOffsets[size];
+  }
+
+  /**
+   * Returns the member whose data contains the given uncompressed offset.
+   *
+   * @param uncompressedOffset an offset in the uncompressed stream
+   * @return the index of the member.
+   * @throws IndexOutOfBoundsException if the offset is not within the uncompressed stream.
+   */
+  public int memberAt(long uncompressedOffset) {
+    if (uncompressedOffset < 0 || uncompressedOffset >= uncompressedSize())
+      throw new IndexOutOfBoundsException("Offset is out of bounds.");
+    int i = Arrays.binarySearch(uncompressedOffsets, 0, size + 1, uncompressedOffset);
+    if (i < 0) return -i - 2;
+    // Skip the members that decompress to nothing.
+    while (uncompressedOffsets[i + 1] == uncompressedOffset) i++;
+    return i;
+  }
+
+  /**
+   * Writes the index to the output stream, which is not closed.
+   *
+   * @param out the output stream
+   * @throws IOException if an I/O error occurs
+   */
+  public void writeTo(OutputStream out) throws IOException {
+    CheckedOutputStream checked = new CheckedOutputStream(out, new CRC32());
+    DataOutputStream data = new DataOutputStream(checked);
+    data.writeInt(MAGIC);
+    data.writeInt(VERSION);
+    data.writeInt(size);
+    for (int i = 0; i < size; i++) {
+      data.writeInt(compressedLength(i));
+      data.writeInt(uncompressedLength(i));
+    }
+    data.flush();
+    new DataOutputStream(out).writeInt((int) checked.getChecksum().getValue());
+    out.flush();
+  }
+
+  /**
+   * Reads an index written by {@link #writeTo(OutputStream)}.
+   *
+   * @param in the input stream
+   * @return the index.
+   * @throws IOException if an I/O error occurs, or the stream does not hold a valid index.
+   */
+  public static QatIndex readFrom(InputStream in) throws IOException {
+    CheckedInputStream checked = new CheckedInputStream(in, new CRC32());
+    DataInputStream data = new DataInputStream(checked);
+    if (data.readInt() != MAGIC) throw new IOException("Not a QAT index.");
+    if (data.readInt() != VERSION) throw new IOException("Unsupported QAT index version.");
+    int size = data.readInt();
+    if (size < 0) throw new IOException("Corrupt QAT index.");
+
+    QatIndex index = new QatIndex();
+    for (int i = 0; i < size; i++) {
+      int compressedLength = data.readInt();
+      int uncompressedLength = data.readInt();
+      if (compressedLength <= 0 || uncompressedLength < 0)
+        throw new IOException("Corrupt QAT index.");
+      index.add(compressedLength, uncompressedLength);
+    }
+    int crc = (int) checked.getChecksum().getValue();
+    if (new DataInputStream(in).readInt() != crc) throw new IOException("Corrupt QAT index.");
+    return index;
+  }
+
+  private int checkMember(int member) {
+    if (member < 0 || member >= size) throw new IndexOutOfBoundsException("No such member.");
+    return member;
+  }
+}
@@ -0,0 +1,499 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
+
+import java.io.EOFException;
+import java.io.IOException;
+import java.io.InputStream;
+import java.io.OutputStream;
+import java.io.UncheckedIOException;
+import java.nio.ByteBuffer;
+import java.util.ArrayDeque;
+import java.util.Objects;
+import java.util.concurrent.CompletableFuture;
+import java.util.concurrent.CompletionException;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.concurrent.Executor;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.function.UnaryOperator;
+
+/**
+ * This class compresses large inputs by splitting them into fixed-size blocks and compressing the
+ * blocks concurrently, each on a session borrowed from the {@link QatSessionPool}. Every block is
+ * compressed into an independent gzip member (for {@link Algorithm#DEFLATE}) or LZ4 frame (for
+ * {@link Algorithm#LZ4}), and the blocks are written out in input order. The output is therefore a
+ * valid concatenated stream that {@link QatZipper#decompress} and {@link
+ * QatDecompressorInputStream} can read.
+ *
+ * <p>{@link #compressIndexed(InputStream, OutputStream)} also returns a {@link QatIndex} of the
+ * blocks, which {@link #decompress(InputStream, QatIndex, OutputStream)} uses to decompress the
+ * blocks concurrently as well.
+ *
+ * <p>Unlike {@link QatZipper}, a <code>QatParallelZipper</code> holds no session of its own and is
+ * thread-safe. The calling thread waits while the executor compresses the blocks, so a call made
+ * from a thread of a bounded executor that also runs its blocks can deadlock once every thread
+ * waits. The default executor has threads of its own and runs the blocks of calls made from those
+ * threads on the calling thread; a custom executor must not run code that calls this
+ * QatParallelZipper.
+ */
+public class QatParallelZipper {
+  /** The default block size in bytes (1MB). */
+  public static final int DEFAULT_BLOCK_SIZE = 1 << 20;
+
+  /** The default number of blocks compressed concurrently. */
+  public static final int DEFAULT_PARALLELISM = Runtime.getRuntime().availableProcessors();
+
+  private final QatSessionPool.Key key;
+  private final int retryCount;
+  private final int blockSize;
+  private final int parallelism;
+  private final Executor executor;
+  private final int maxBlockLength;
+
+  /** Recycled input and output buffers, so that each in-flight block needs no new allocation. */
+  private final ConcurrentLinkedQueue<byte[]> inputBuffers = new ConcurrentLinkedQueue<>();
+
+  private final ConcurrentLinkedQueue<byte[]> outputBuffers = new ConcurrentLinkedQueue<>();
+
+  /**
+   * Creates a new QatParallelZipper with the given parameters.
+   *
+   * @param algorithm the compression {@link Algorithm}
+   * @param level the compression level.
+   * @param mode the {@link Mode} of QAT execution
+   * @param pmode the {@link PollingMode}
+   * @param blockSize the size in bytes of the blocks that are compressed independently
+   * @param parallelism the maximum number of blocks compressed concurrently
+   * @param executor the executor that compresses the blocks; the calling thread waits for it, so it
+   *     must not run code that calls this QatParallelZipper
+   * @throws QatException if a QAT session cannot be created.
+   */
+  public QatParallelZipper(
+      Algorithm algorithm,
+      int level,
+      Mode mode,
+      PollingMode pmode,
+      int blockSize,
+      int parallelism,
+      Executor executor) {
+    if (blockSize <= 0 || parallelism <= 0) throw new IllegalArgumentException();
+    this.key = new QatSessionPool.Key(algorithm, level, mode, pmode);
+    this.retryCount = QatZipper.DEFAULT_RETRY_COUNT;
+    this.blockSize = blockSize;
+    this.parallelism = parallelism;
+    this.executor = Objects.requireNonNull(executor);
+
+    QatZipper qzip = new QatZipper(key, retryCount);
+    try {
+      maxBlockLength = qzip.maxCompressedLength(blockSize);
+    } finally {
+      qzip.end();
+    }
+  }
+
+  /**
+   * Creates a new QatParallelZipper with the given parameters, {@link #DEFAULT_BLOCK_SIZE}, {@link
+   * #DEFAULT_PARALLELISM}, and a shared executor of {@link #DEFAULT_PARALLELISM} threads, which is
+   * not the one used by {@link QatZipper#compressAsync}.
+   *
+   * @param algorithm the compression {@link Algorithm}
+   * @param level the compression level.
+   * @param mode the {@link Mode} of QAT execution
+   * @param pmode the {@link PollingMode}
+   * @throws QatException if a QAT session cannot be created.
+   */
+  public QatParallelZipper(Algorithm algorithm, int level, Mode mode, PollingMode pmode) {
+    this(
+        algorithm,
+        level,
+        mode,
+        pmode,
+        DEFAULT_BLOCK_SIZE,
+        DEFAULT_PARALLELISM,
+        BlockExecutor.INSTANCE);
+  }
+
+  /**
+   * Creates a new QatParallelZipper with the given algorithm, {@link
+   * QatZipper#DEFAULT_COMPRESS_LEVEL}, {@link QatZipper#DEFAULT_MODE}, and {@link
+   * QatZipper#DEFAULT_POLLING_MODE}.
+   *
+   * @param algorithm the compression {@link Algorithm}
+   * @throws QatException if a QAT session cannot be created.
+   */
+  public QatParallelZipper(Algorithm algorithm) {
+    this(
+        algorithm,
+        QatZipper.DEFAULT_COMPRESS_LEVEL,
+        QatZipper.DEFAULT_MODE,
+        QatZipper.DEFAULT_POLLING_MODE);
+  }
+
+  /**
+   * Returns the block size of this QatParallelZipper.
+   *
+   * @return the block size in bytes.
+   */
+  public int getBlockSize() {
+    return blockSize;
+  }
+
+  /**
+   * Returns the maximum compression length for the specified source length.
+   *
+   * @param len the length of the source array or buffer.
+   * @return the maximum compression length for the specified length.
+   */
+  public long maxCompressedLength(long len) {
+    if (len < 0) throw new IllegalArgumentException();
+    long blocks = (len + blockSize - 1) / blockSize;
+    return Math.max(1, blocks) * maxBlockLength;
+  }
+
+  /**
+   * Compresses the source array and stores the result in the destination array.
+   *
+   * @param src the source array holding the source data
+   * @param dst the destination array for the compressed data
+   * @return the size of the compressed data in bytes
+   */
+  public int compress(byte[] src, byte[] dst) {
+    return compress(src, 0, src.length, dst, 0, dst.length);
+  }
+
+  /**
+   * Compresses the source array, starting at the specified offset, and stores the result in the
+   * destination array starting at the specified destination offset.
+   *
+   * @param src the source array holding the source data
+   * @param srcOffset the start offset of the source data
+   * @param srcLen the length of source data to compress
+   * @param dst the destination array for the compressed data
+   * @param dstOffset the destination offset where to start storing the compressed data
+   * @param dstLen the maximum length that can be written to the destination array
+   * @return the size of the compressed data in bytes
+   */
+  public int compress(
+      byte[] src, int srcOffset, int srcLen, byte[] dst, int dstOffset, int dstLen) {
+    if (src == null || dst == null || srcLen == 0 || dst.length == 0)
+      throw new IllegalArgumentException(
+          "Either source or destination array or both have size 0 or null value.");
+
+    if (srcOffset < 0 || srcLen < 0 || srcOffset + srcLen > src.length)
+      throw new ArrayIndexOutOfBoundsException("Source offset is out of bounds.");
+
+    if (dstOffset < 0 || dstLen < 0 || dstOffset + dstLen > dst.length)
+      throw new ArrayIndexOutOfBoundsException("Destination offset is out of bounds.");
+
+    return compress(
+        ByteBuffer.wrap(src, srcOffset, srcLen), ByteBuffer.wrap(dst, dstOffset, dstLen));
+  }
+
+  /**
+   * Compresses the source buffer and stores the result in the destination buffer. On success, the
+   * positions of both buffers are advanced by the number of bytes read and written.
+   *
+   * @param src the source buffer holding the source data
+   * @param dst the destination buffer that will store the compressed data
+   * @return the size of the compressed data in bytes
+   */
+  public int compress(ByteBuffer src, ByteBuffer dst) {
+    if (src == null || dst == null || !src.hasRemaining() || !dst.hasRemaining())
+      throw new IllegalArgumentException();
+
+    final ByteBuffer source = src.duplicate();
+    final int start = dst.position();
+    run(
+        () -> {
+          if (!source.hasRemaining()) return null;
+          // A duplicate rather than a slice keeps the array offset of heap buffers at zero.
+          ByteBuffer block = source.duplicate();
+          block.limit(block.position() + Math.min(blockSize, block.remaining()));
+          source.position(block.limit());
+          return new Block(null, block);
+        },
+        this::compressBlock,
+        (b, len, srcLen) -> {
+          if (len > dst.remaining()) throw new QatException("Destination buffer is too small.");
+          dst.put(b, 0, len);
+        });
+    src.position(src.limit());
+    return dst.position() - start;
+  }
+
+  /**
+   * Compresses all data read from the input stream and writes it to the output stream. Neither
+   * stream is closed.
+   *
+   * @param in the input stream holding the source data
+   * @param out the output stream for the compressed data
+   * @return the number of compressed bytes written
+   * @throws IOException if an I/O error occurs
+   */
+  public long compress(InputStream in, OutputStream out) throws IOException {
+    return compress(in, out, null);
+  }
+
+  /**
+   * Compresses all data read from the input stream and writes it to the output stream, and returns
+   * the index of the compressed blocks. Neither stream is closed. Writing the index next to the
+   * compressed data, with {@link QatIndex#writeTo(OutputStream)}, lets it be decompressed in
+   * parallel.
+   *
+   * @param in the input stream holding the source data
+   * @param out the output stream for the compressed data
+   * @return the index of the compressed blocks
+   * @throws IOException if an I/O error occurs
+   */
+  public QatIndex compressIndexed(InputStream in, OutputStream out) throws IOException {
+    QatIndex index = new QatIndex();
+    compress(in, out, index);
+    return index;
+  }
+
+  /**
+   * Compresses all data read from the input stream into a seekable container, which {@link
+   * QatSeekableChannel} and {@link QatSeekableInputStream} can read from any uncompressed offset.
+   * The container is the compressed blocks followed by a footer that indexes them. Neither stream
+   * is closed. The block size is the granularity of random access: reading from an offset
+   * decompresses the block that holds it.
+   *
+   * @param in the input stream holding the source data
+   * @param out the output stream for the container
+   * @return the number of bytes written
+   * @throws IOException if an I/O error occurs
+   */
+  public long compressSeekable(InputStream in, OutputStream out) throws IOException {
+    QatIndex index = compressIndexed(in, out);
+    return index.compressedSize() + QatSeekableChannel.writeFooter(index, out);
+  }
+
+  private long compress(InputStream in, OutputStream out, QatIndex index) throws IOException {
+    Objects.requireNonNull(in);
+    Objects.requireNonNull(out);
+
+    long[] written = new long[1];
+    boolean[] eof = new boolean[1];
+    try {
+      run(
+          () -> {
+            if (eof[0]) return null;
+            byte[] buf = buffer(inputBuffers, blockSize);
+            int n = in.readNBytes(buf, 0, blockSize);
+            if (n < blockSize) eof[0] = true;
+            if (n == 0) {
+              inputBuffers.offer(buf);
+              return null;
+            }
+            return new Block(buf, ByteBuffer.wrap(buf, 0, n));
+          },
+          this::compressBlock,
+          (b, len, srcLen) -> {
+            out.write(b, 0, len);
+            written[0] += len;
+            if (index != null) index.add(len, srcLen);
+          });
+    } catch (UncheckedIOException e) {
+      throw e.getCause();
+    }
+    return written[0];
+  }
+
+  /**
+   * Decompresses the members of a compressed stream concurrently, each on a session borrowed from
+   * the {@link QatSessionPool}, and writes the decompressed data to the output stream in order.
+   * Neither stream is closed. The index gives the boundaries of the members, which must have been
+   * compressed with the algorithm of this QatParallelZipper; the block size does not need to match.
+   *
+   * @param in the input stream holding the compressed data, positioned at its first member
+   * @param index the index of the members of the compressed data
+   * @param out the output stream for the decompressed data
+   * @return the number of decompressed bytes written
+   * @throws IOException if an I/O error occurs, or the input ends before the last member
+   * @throws QatException if a member does not decompress to its length in the index
+   */
+  public long decompress(InputStream in, QatIndex index, OutputStream out) throws IOException {
+    Objects.requireNonNull(in);
+    Objects.requireNonNull(index);
+    Objects.requireNonNull(out);
+
+    long[] written = new long[1];
+    int[] member = new int[1];
+    try {
+      run(
+          () -> {
+            if (member[0] == index.size()) return null;
+            int len = index.compressedLength(member[0]);
+            byte[] buf = buffer(inputBuffers, len);
+            if (in.readNBytes(buf, 0, len) < len)
+              throw new EOFException("Unexpected end of compressed data.");
+            return new Block(
+                buf, ByteBuffer.wrap(buf, 0, len), index.uncompressedLength(member[0]++));
+          },
+          this::decompressBlock,
+          (b, len, srcLen) -> {
+            out.write(b, 0, len);
+            written[0] += len;
+          });
+    } catch (UncheckedIOException e) {
+      throw e.getCause();
+    }
+    return written[0];
+  }
+
+  /** Supplies the next block to compress, or null at the end of the input. */
+  private interface BlockSupplier {
+    Block next() throws IOException;
+  }
+
+  /** Consumes processed blocks in input order, along with the length of their source data. */
+  private interface BlockSink {
+    void write(byte[] b, int len, int srcLen) throws IOException;
+  }
+
+  /** A block of source data and, once processed, its compressed or decompressed bytes. */
+  private static final class Block {
+    final byte[] inputBuffer;
+    final ByteBuffer input;
+    final int inputLength;
+
+    /** The length the block decompresses to, or -1 for a block to compress. */
+    final int decompressedLength;
+
+    byte[] output;
+    int length;
+
+    Block(byte[] inputBuffer, ByteBuffer input) {
+      this(inputBuffer, input, -1);
+    }
+
+    Block(byte[] inputBuffer, ByteBuffer input, int decompressedLength) {
+      this.inputBuffer = inputBuffer;
+      this.input = input;
+      this.inputLength = input.remaining();
+      this.decompressedLength = decompressedLength;
+    }
+  }
+
+  /**
+   * Runs the task on the blocks from the supplier concurrently, keeping at most twice the
+   * parallelism in flight, and hands the blocks to the sink in order.
+   */
+  private void run(BlockSupplier supplier, UnaryOperator<Block> task, BlockSink sink) {
+    // A thread of the shared executor that waited for its own pool could deadlock it.
+    Executor executor =
+        this.executor == BlockExecutor.INSTANCE && Thread.currentThread() instanceof BlockThread
+            ? Runnable::run
+            : this.executor;
+    ArrayDeque<CompletableFuture<Block>> inFlight = new ArrayDeque<>();
+    RuntimeException failure = null;
+    try {
+      Block next = supplier.next();
+      while (next != null || !inFlight.isEmpty()) {
+        while (next != null && inFlight.size() < 2 * parallelism) {
+          Block block = next;
+          inFlight.add(CompletableFuture.supplyAsync(() -> task.apply(block), executor));
+          next = supplier.next();
+        }
+        Block done = inFlight.poll().join();
+        try {
+          sink.write(done.output, done.length, done.inputLength);
+        } finally {
+          recycle(done);
+        }
+      }
+    } catch (IOException e) {
+      failure = new UncheckedIOException(e);
+    } catch (CompletionException e) {
+      failure =
+          e.getCause() instanceof RuntimeException
+              ? (RuntimeException) e.getCause()
+              : new QatException(e.getCause().getMessage());
+    } catch (RuntimeException e) {
+      failure = e;
+    }
+
+    if (failure != null) {
+      // Wait for the remaining blocks so that no task outlives this call.
+      for (CompletableFuture<Block> f : inFlight) {
+        try {
+          recycle(f.join());
+        } catch (CompletionException ignored) {
+          // The first failure is reported.
+        }
+      }
+      throw failure;
+    }
+  }
+
+  private Block compressBlock(Block block) {
+    byte[] out = buffer(outputBuffers, maxBlockLength);
+    QatZipper qzip = new QatZipper(key, retryCount);
+    try {
+      block.length = qzip.compress(block.input, ByteBuffer.wrap(out));
+      block.output = out;
+    } catch (RuntimeException e) {
+      outputBuffers.offer(out);
+      throw e;
+    } finally {
+      qzip.end();
+    }
+    return block;
+  }
+
+  private Block decompressBlock(Block block) {
+    byte[] out = buffer(outputBuffers, block.decompressedLength);
+    QatZipper qzip = new QatZipper(key, retryCount);
+    try {
+      // A member that decompresses to nothing needs no request.
+      if (block.decompressedLength > 0) {
+        block.length =
+            qzip.decompress(block.input, ByteBuffer.wrap(out, 0, block.decompressedLength));
+        if (block.input.hasRemaining()) block.length = -1;
+      }
+      block.output = out;
+    } catch (RuntimeException e) {
+      outputBuffers.offer(out);
+      throw e;
+    } finally {
+      qzip.end();
+    }
+    if (block.length != block.decompressedLength)
+      throw new QatException("The compressed data does not match the index.");
+    return block;
+  }
+
+  /** Returns a recycled buffer of at least the given size, or a new one. */
+  private static byte[] buffer(ConcurrentLinkedQueue<byte[]> buffers, int size) {
+    byte[] buf = buffers.poll();
+    return buf != null && buf.length >= size ? buf : new byte[Math.max(size, 1)];
+  }
+
+  private void recycle(Block block) {
+    if (block.inputBuffer != null) inputBuffers.offer(block.inputBuffer);
+    if (block.output != null) outputBuffers.offer(block.output);
+  }
+
+  /** Holds the shared executor that compresses blocks, created on first use. */
+  static class BlockExecutor {
+    static final ExecutorService INSTANCE =
+        Executors.newFixedThreadPool(Math.max(1, DEFAULT_PARALLELISM), BlockThread::new);
+  }
+
+  /** A thread of the shared block executor. */
+  private static final class BlockThread extends Thread {
+    BlockThread(Runnable r) {
+      super(r, "qat-parallel");
+      setDaemon(true);
+    }
+  }
+}
@@ -0,0 +1,166 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import java.util.Objects;
+import java.util.concurrent.ThreadLocalRandom;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.locks.LockSupport;
+
+/**
+ * How a {@link QatZipper} retries a request for which no QAT instance is available. Without a
+ * policy, such a request is re-issued immediately up to the retry count of the <code>QatZipper
+ * </code>, which under contention burns CPU and adds to the contention.
+ *
+ * <p>With a policy, each retry waits for an exponentially growing delay, from the initial backoff
+ * up to the maximum backoff. Each delay is jittered, so that threads that failed together do not
+ * retry together. Retries stop after <code>maxRetries</code> attempts or once the timeout, counted
+ * from the first failure, has passed.
+ *
+ * <p>If failover is enabled, a request of a {@link QatZipper.Mode#HARDWARE} zipper that still has
+ * no instance is then moved to a pooled session in {@link QatZipper.Mode#AUTO}, which compresses
+ * in software when no instance is available. Requests of zippers with a preset dictionary or
+ * checksums enabled are not moved, since that state belongs to their own session.
+ *
+ * <p>The policy applies to single compress and decompress calls, to each buffer of a batch, and to
+ * the zippers of {@link QatZipper#compressAll}. Requests of a decompression stream are retried on
+ * their own session, without failover, since the stream state belongs to it.
+ */
+public final class QatRetryPolicy {
+  /** The QATzip status of a request for which no instance could be attached. */
+  static final int NO_INSTANCE = -103;
+
+  private final int maxRetries;
+  private final long initialBackoffNanos;
+  private final long maxBackoffNanos;
+  private final long timeoutNanos;
+  private final boolean failover;
+
+  /**
+   * Creates a retry policy.
+   *
+   * @param maxRetries the maximum number of retries
+   * @param initialBackoff the delay before the first retry
+   * @param maxBackoff the maximum delay between retries
+   * @param timeout the time after the first failure after which no retry is made, or 0 for no
+   *     timeout
+   * @param unit the time unit of the backoffs and the timeout
+   * @param failover whether to move the request to other sessions once the retries are exhausted
+   */
+  public QatRetryPolicy(
+      int maxRetries,
+      long initialBackoff,
+      long maxBackoff,
+      long timeout,
+      TimeUnit unit,
+      boolean failover) {
+    Objects.requireNonNull(unit);
+    if (maxRetries < 0) throw new IllegalArgumentException("Invalid value for retry count.");
+    if (initialBackoff < 0 || maxBackoff < initialBackoff)
+      throw new IllegalArgumentException("Invalid backoff.");
+    if (timeout < 0) throw new IllegalArgumentException("Invalid timeout.");
+
+    this.maxRetries = maxRetries;
+    this.initialBackoffNanos = unit.toNanos(initialBackoff);
+    this.maxBackoffNanos = unit.toNanos(maxBackoff);
+    this.timeoutNanos = unit.toNanos(timeout);
+    this.failover = failover;
+  }
+
+  /**
+   * Creates a retry policy without a timeout and without failover.
+   *
+   * @param maxRetries the maximum number of retries
+   * @param initialBackoff the delay before the first retry
+   * @param maxBackoff the maximum delay between retries
+   * @param unit the time unit of the backoffs
+   */
+  public QatRetryPolicy(int maxRetries, long initialBackoff, long maxBackoff, TimeUnit unit) {
+    this(maxRetries, initialBackoff, maxBackoff, 0, unit, false);
+  }
+
+  /**
+   * Returns the maximum number of retries.
+   *
+   * @return the maximum number of retries.
+   */
+  public int getMaxRetries() {
+    return maxRetries;
+  }
+
+  /**
+   * Returns the delay before the first retry.
+   *
+   * @param unit the time unit of the returned value
+   * @return the initial backoff.
+   */
+  public long getInitialBackoff(TimeUnit unit) {
+    return unit.convert(initialBackoffNanos, TimeUnit.NANOSECONDS);
+  }
+
+  /**
+   * Returns the maximum delay between retries.
+   *
+   * @param unit the time unit of the returned value
+   * @return the maximum backoff.
+   */
+  public long getMaxBackoff(TimeUnit unit) {
+    return unit.convert(maxBackoffNanos, TimeUnit.NANOSECONDS);
+  }
+
+  /**
+   * Returns the time after the first failure after which no retry is made.
+   *
+   * @param unit the time unit of the returned value
+   * @return the timeout, or 0 if there is none.
+   */
+  public long getTimeout(TimeUnit unit) {
+    return unit.convert(timeoutNanos, TimeUnit.NANOSECONDS);
+  }
+
+  /**
+   * Returns whether requests are moved to other sessions once the retries are exhausted.
+   *
+   * @return true if failover is enabled.
+   */
+  public boolean isFailover() {
+    return failover;
+  }
+
+  /** Returns the deadline of a request that failed now, or 0 if there is no timeout. */
+  long deadline() {
+    return timeoutNanos > 0 ? System.nanoTime() + timeoutNanos : 0;
+  }
+
+  /** Returns the jittered delay before the given retry, counted from 0. */
+  long backoffNanos(int attempt) {
+    long delay = initialBackoffNanos;
+    for (int i = 0; i < attempt && delay < maxBackoffNanos; i++) delay *= 2;
+    delay = Math.min(delay, maxBackoffNanos);
+    if (delay < 2) return delay;
+
+    // Half the delay plus a random part of the other half.
+    return delay / 2 + ThreadLocalRandom.current().nextLong(delay / 2 + 1);
+  }
+
+  /**
+   * Waits before the given retry.
+   *
+   * @return false if the retry should not be made, because the deadline has passed or the thread
+   *     was interrupted.
+   */
+  boolean await(int attempt, long deadline) {
+    long delay = backoffNanos(attempt);
+    if (deadline != 0) {
+      long left = deadline - System.nanoTime();
+      if (left <= 0) return false;
+      delay = Math.min(delay, left);
+    }
+    if (delay > 0) LockSupport.parkNanos(delay);
+    return !Thread.currentThread().isInterrupted();
+  }
+}
@@ -0,0 +1,290 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
+
+import java.io.ByteArrayInputStream;
+import java.io.ByteArrayOutputStream;
+import java.io.DataOutputStream;
+import java.io.EOFException;
+import java.io.IOException;
+import java.io.OutputStream;
+import java.nio.ByteBuffer;
+import java.nio.channels.ClosedChannelException;
+import java.nio.channels.NonWritableChannelException;
+import java.nio.channels.SeekableByteChannel;
+import java.util.Objects;
+
+/**
+ * This class implements a read-only SeekableByteChannel over a seekable container, whose
+ * uncompressed data can be read from any offset. A seekable container is written by {@link
+ * QatParallelZipper#compressSeekable}: the input is split into fixed-size blocks, each block is
+ * compressed independently into a gzip member or LZ4 frame, and a footer that holds the {@link
+ * QatIndex} of the blocks follows the last block. Positioning the channel costs nothing; a read
+ * decompresses only the blocks it reads from, and the most recent block is kept, so sequential
+ * reads decompress each block once.
+ *
+ * <p>The footer is the serialized index, followed by the 8-byte big-endian offset of the index and
+ * the magic "QSEK". The blocks before the footer form a concatenated stream that {@link
+ * QatDecompressorInputStream} reads as well, but tools that reject trailing data after the last
+ * member do not.
+ */
+public class QatSeekableChannel implements SeekableByteChannel {
+  private static final int MAGIC = 0x5153454b; // "QSEK"
+  private static final int TRAILER_SIZE = Long.BYTES + Integer.BYTES;
+
+  private final SeekableByteChannel source;
+  private final QatZipper qzip;
+  private final QatIndex index;
+  private final ByteBuffer inputBuffer;
+  private final ByteBuffer blockBuffer;
+
+  /** The block held in the block buffer, or -1. */
+  private int block = -1;
+
+  private long position;
+  private boolean open;
+
+  /**
+   * Opens a seekable container.
+   *
+   * @param source the channel holding the container; it is read with positional reads, so its
+   *     position is not meaningful while this channel is open
+   * @param algorithm the compression algorithm the container was written with (deflate or LZ4).
+   * @param mode the mode of operation (HARDWARE - only hardware, AUTO - hardware with a software
+   *     failover.)
+   * @param pmode the polling mode
+   * @throws IOException if an I/O error occurs, or the source does not hold a seekable container
+   */
+  public QatSeekableChannel(
+      SeekableByteChannel source, Algorithm algorithm, Mode mode, PollingMode pmode)
+      throws IOException {
+    this.source = Objects.requireNonNull(source);
+    index = readFooter(source);
+
+    int maxCompressed = 0;
+    int maxUncompressed = 0;
+    for (int i = 0; i < index.size(); i++) {
+      maxCompressed = Math.max(maxCompressed, index.compressedLength(i));
+      maxUncompressed = Math.max(maxUncompressed, index.uncompressedLength(i));
+    }
+    qzip = new QatZipper(algorithm, mode, pmode);
+    inputBuffer = QatBufferAllocator.allocate(maxCompressed);
+    blockBuffer = QatBufferAllocator.allocate(maxUncompressed);
+    open = true;
+  }
+
+  /**
+   * Opens a seekable container with {@link QatZipper#DEFAULT_MODE} and {@link PollingMode#BUSY}.
+   *
+   * @param source the channel holding the container
+   * @param algorithm the compression algorithm the container was written with (deflate or LZ4).
+   * @throws IOException if an I/O error occurs, or the source does not hold a seekable container
+   */
+  public QatSeekableChannel(SeekableByteChannel source, Algorithm algorithm) throws IOException {
+    this(source, algorithm, QatZipper.DEFAULT_MODE, PollingMode.BUSY);
+  }
+
+  /**
+   * Returns the index of the blocks of the container.
+   *
+   * @return the index.
+   */
+  public QatIndex getIndex() {
+    return index;
+  }
+
+  /**
+   * Reads uncompressed data from the current position into the given buffer, and advances the
+   * position by the number of bytes read.
+   *
+   * @param dst the buffer into which the data is read
+   * @return the number of bytes read, or -1 if the position is at or past the end of the data
+   * @throws IOException if this channel is closed or an I/O error occurs
+   */
+  @Override
+  public int read(ByteBuffer dst) throws IOException {
+    if (!open) throw new ClosedChannelException();
+    if (position >= index.uncompressedSize()) return -1;
+
+    int result = 0;
+    while (dst.hasRemaining() && position < index.uncompressedSize()) {
+      int member = index.memberAt(position);
+      load(member);
+      ByteBuffer chunk = blockBuffer.duplicate();
+      chunk.position((int) (position - index.uncompressedOffset(member)));
+      chunk.limit(chunk.position() + Math.min(chunk.remaining(), dst.remaining()));
+      int len = chunk.remaining();
+      dst.put(chunk);
+      position += len;
+      result += len;
+    }
+    return result;
+  }
+
+  /**
+   * Throws NonWritableChannelException; this channel is read-only.
+   *
+   * @param src the buffer from which the data would be written
+   * @return never returns
+   */
+  @Override
+  public int write(ByteBuffer src) {
+    throw new NonWritableChannelException();
+  }
+
+  /**
+   * Returns the position in the uncompressed data.
+   *
+   * @return the position.
+   * @throws IOException if this channel is closed
+   */
+  @Override
+  public long position() throws IOException {
+    if (!open) throw new ClosedChannelException();
+    return position;
+  }
+
+  /** Returns the position, without checking that the channel is open. */
+  long getPositionUnchecked() {
+    return position;
+  }
+
+  /**
+   * Sets the position in the uncompressed data. A position past the end is allowed; reads from it
+   * return -1.
+   *
+   * @param newPosition the new position
+   * @return this channel
+   * @throws IOException if this channel is closed
+   */
+  @Override
+  public QatSeekableChannel position(long newPosition) throws IOException {
+    if (!open) throw new ClosedChannelException();
+    if (newPosition < 0) throw new IllegalArgumentException("Negative position.");
+    position = newPosition;
+    return this;
+  }
+
+  /**
+   * Returns the size of the uncompressed data.
+   *
+   * @return the uncompressed size.
+   * @throws IOException if this channel is closed
+   */
+  @Override
+  public long size() throws IOException {
+    if (!open) throw new ClosedChannelException();
+    return index.uncompressedSize();
+  }
+
+  /**
+   * Throws NonWritableChannelException; this channel is read-only.
+   *
+   * @param size the size to truncate to
+   * @return never returns
+   */
+  @Override
+  public SeekableByteChannel truncate(long size) {
+    throw new NonWritableChannelException();
+  }
+
+  /**
+   * Tells whether or not this channel is open.
+   *
+   * @return true if, and only if, this channel is open
+   */
+  @Override
+  public boolean isOpen() {
+    return open;
+  }
+
+  /**
+   * Closes this channel and releases resources. This method will close the source channel.
+   *
+   * @throws IOException if an I/O error occurs
+   */
+  @Override
+  public void close() throws IOException {
+    if (!open) return;
+    open = false;
+    try {
+      qzip.end();
+    } finally {
+      QatBufferAllocator.release(inputBuffer);
+      QatBufferAllocator.release(blockBuffer);
+      source.close();
+    }
+  }
+
+  /** Decompresses the given block into the block buffer, unless it is already there. */
+  private void load(int member) throws IOException {
+    if (member == block) return;
+    block = -1;
+
+    inputBuffer.clear().limit(index.compressedLength(member));
+    readFully(source, inputBuffer, index.compressedOffset(member));
+    inputBuffer.flip();
+
+    blockBuffer.clear().limit(index.uncompressedLength(member));
+    if (blockBuffer.hasRemaining()) qzip.decompress(inputBuffer, blockBuffer);
+    if (blockBuffer.hasRemaining() || inputBuffer.hasRemaining())
+      throw new QatException("The compressed data does not match the index.");
+    blockBuffer.flip();
+    block = member;
+  }
+
+  /** Fills the buffer from the channel, starting at the given offset. */
+  private static void readFully(SeekableByteChannel channel, ByteBuffer dst, long offset)
+      throws IOException {
+    channel.position(offset);
+    while (dst.hasRemaining()) {
+      if (channel.read(dst) < 0) throw new EOFException("Unexpected end of seekable container.");
+    }
+  }
+
+  /**
+   * Writes the footer of a seekable container whose blocks have just been written.
+   *
+   * @return the size of the footer in bytes.
+   */
+  static int writeFooter(QatIndex index, OutputStream out) throws IOException {
+    ByteArrayOutputStream footer = new ByteArrayOutputStream();
+    index.writeTo(footer);
+    DataOutputStream data = new DataOutputStream(footer);
+    data.writeLong(index.compressedSize());
+    data.writeInt(MAGIC);
+    data.flush();
+    footer.writeTo(out);
+    out.flush();
+    return footer.size();
+  }
+
+  /** Reads the index from the footer of a seekable container. */
+  private static QatIndex readFooter(SeekableByteChannel source) throws IOException {
+    long size = source.size();
+    if (size < TRAILER_SIZE) throw new IOException("Not a seekable container.");
+    ByteBuffer trailer = ByteBuffer.allocate(TRAILER_SIZE);
+    readFully(source, trailer, size - TRAILER_SIZE);
+    trailer.flip();
+    long indexOffset = trailer.getLong();
+    if (trailer.getInt() != MAGIC || indexOffset < 0 || indexOffset > size - TRAILER_SIZE)
+      throw new IOException("Not a seekable container.");
+
+    long indexSize = size - TRAILER_SIZE - indexOffset;
+    if (indexSize > Integer.MAX_VALUE) throw new IOException("Corrupt seekable container.");
+    ByteBuffer data = ByteBuffer.allocate((int) indexSize);
+    readFully(source, data, indexOffset);
+    QatIndex index = QatIndex.readFrom(new ByteArrayInputStream(data.array()));
+    if (index.compressedSize() != indexOffset)
+      throw new IOException("Corrupt seekable container.");
+    return index;
+  }
+}
@@ -0,0 +1,198 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
+
+import java.io.IOException;
+import java.io.InputStream;
+import java.nio.ByteBuffer;
+import java.nio.channels.SeekableByteChannel;
+import java.util.Objects;
+
+/**
+ * This class implements an InputStream over a seekable container written by {@link
+ * QatParallelZipper#compressSeekable}. Unlike {@link QatDecompressorInputStream}, it can {@link
+ * #seek(long)} to any uncompressed offset, and skipping and <code>mark</code>/<code>reset</code>
+ * only move the position: data is decompressed one block at a time as it is read. See {@link
+ * QatSeekableChannel}, which this stream reads from.
+ */
+public class QatSeekableInputStream extends InputStream {
+  private final QatSeekableChannel channel;
+  private final byte[] single = new byte[1];
+  private long mark;
+  private boolean closed;
+
+  /**
+   * Opens a seekable container.
+   *
+   * @param source the channel holding the container
+   * @param algorithm the compression algorithm the container was written with (deflate or LZ4).
+   * @param mode the mode of operation (HARDWARE - only hardware, AUTO - hardware with a software
+   *     failover.)
+   * @param pmode the polling mode
+   * @throws IOException if an I/O error occurs, or the source does not hold a seekable container
+   */
+  public QatSeekableInputStream(
+      SeekableByteChannel source, Algorithm algorithm, Mode mode, PollingMode pmode)
+      throws IOException {
+    channel = new QatSeekableChannel(source, algorithm, mode, pmode);
+  }
+
+  /**
+   * Opens a seekable container with {@link QatZipper#DEFAULT_MODE} and {@link PollingMode#BUSY}.
+   *
+   * @param source the channel holding the container
+   * @param algorithm the compression algorithm the container was written with (deflate or LZ4).
+   * @throws IOException if an I/O error occurs, or the source does not hold a seekable container
+   */
+  public QatSeekableInputStream(SeekableByteChannel source, Algorithm algorithm)
+      throws IOException {
+    this(source, algorithm, QatZipper.DEFAULT_MODE, PollingMode.BUSY);
+  }
+
+  /**
+   * Reads the next byte of uncompressed data.
+   *
+   * @return the next byte of data or -1 if the end of the stream is reached.
+   * @throws IOException if the stream is closed
+   */
+  @Override
+  public int read() throws IOException {
+    return read(single, 0, 1) < 0 ? -1 : Byte.toUnsignedInt(single[0]);
+  }
+
+  /**
+   * Reads uncompressed data into the provided array.
+   *
+   * @param b the array into which the data is read
+   * @param off the starting offset in the array
+   * @param len the maximum number of bytes to be read
+   * @return the number of bytes read, or -1 if the end of the stream is reached
+   * @throws IOException if the stream is closed
+   */
+  @Override
+  public int read(byte[] b, int off, int len) throws IOException {
+    ensureOpen();
+    Objects.requireNonNull(b);
+    if (off < 0 || len < 0 || off + len > b.length) throw new IndexOutOfBoundsException();
+    if (len == 0) return 0;
+    return channel.read(ByteBuffer.wrap(b, off, len));
+  }
+
+  /**
+   * Skips up to n bytes of uncompressed data without decompressing them.
+   *
+   * @param n the maximum number of bytes to skip
+   * @return the number of bytes skipped or 0 if n is negative.
+   * @throws IOException if the stream is closed
+   */
+  @Override
+  public long skip(long n) throws IOException {
+    ensureOpen();
+    long position = channel.position();
+    long skipped = Math.max(0, Math.min(n, channel.size() - position));
+    channel.position(position + skipped);
+    return skipped;
+  }
+
+  /**
+   * Returns the number of uncompressed bytes left.
+   *
+   * @return the number of bytes left, or Integer.MAX_VALUE if more are left.
+   * @throws IOException if the stream is closed
+   */
+  @Override
+  public int available() throws IOException {
+    ensureOpen();
+    return (int) Math.min(Integer.MAX_VALUE, Math.max(0, channel.size() - channel.position()));
+  }
+
+  /**
+   * Moves to the given offset in the uncompressed data.
+   *
+   * @param position the new position; reads from past the end return -1
+   * @throws IOException if the stream is closed
+   */
+  public void seek(long position) throws IOException {
+    ensureOpen();
+    channel.position(position);
+  }
+
+  /**
+   * Returns the offset in the uncompressed data of the next byte read.
+   *
+   * @return the position.
+   * @throws IOException if the stream is closed
+   */
+  public long getPosition() throws IOException {
+    ensureOpen();
+    return channel.position();
+  }
+
+  /**
+   * Returns the size of the uncompressed data.
+   *
+   * @return the uncompressed size.
+   * @throws IOException if the stream is closed
+   */
+  public long length() throws IOException {
+    ensureOpen();
+    return channel.size();
+  }
+
+  /**
+   * Marks the current position in this input stream. The read limit is ignored; the mark stays
+   * valid however much is read.
+   *
+   * @param readLimit ignored
+   */
+  @Override
+  public void mark(int readLimit) {
+    if (!closed) mark = channel.getPositionUnchecked();
+  }
+
+  /**
+   * Repositions this stream to the position at the time the mark method was last called, or to the
+   * start of the stream if it was not called.
+   *
+   * @throws IOException if the stream is closed
+   */
+  @Override
+  public void reset() throws IOException {
+    seek(mark);
+  }
+
+  /**
+   * Tests if this input stream supports the mark and reset methods. This method unconditionally
+   * returns true.
+   *
+   * @return true
+   */
+  @Override
+  public boolean markSupported() {
+    return true;
+  }
+
+  /**
+   * Closes this input stream and releases resources. This method will close the source channel.
+   *
+   * @throws IOException if an I/O error occurs
+   */
+  @Override
+  public void close() throws IOException {
+    if (closed) return;
+    closed = true;
+    channel.close();
+  }
+
+  private void ensureOpen() throws IOException {
+    if (closed) throw new IOException("Stream is closed");
+  }
+}
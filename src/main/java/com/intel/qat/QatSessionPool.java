@@ -0,0 +1,299 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Format;
+import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
+
+import java.util.Objects;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ConcurrentLinkedDeque;
+import java.util.concurrent.Executors;
+import java.util.concurrent.ScheduledExecutorService;
+import java.util.concurrent.ScheduledFuture;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicInteger;
+
+/**
+ * A process-wide pool of QAT sessions. Setting up a QAT session is expensive compared to
+ * compressing a small buffer, so applications that create short-lived {@link QatZipper} objects
+ * should use {@link QatZipper#fromPool} instead of a constructor. A pooled <code>QatZipper</code>
+ * borrows an idle session that matches its algorithm, compression level, execution mode and
+ * polling mode, and returns the session to the pool when {@link QatZipper#end()} is called.
+ *
+ * <p>The pool keeps at most {@link #getMaxSize()} idle sessions per configuration; sessions
+ * returned beyond that are torn down. Sessions that stay idle longer than the idle timeout are torn
+ * down by a background thread, but never below {@link #getMinSize()} idle sessions per
+ * configuration.
+ */
+public final class QatSessionPool {
+  /** The default minimum number of idle sessions retained per configuration. */
+  public static final int DEFAULT_MIN_SIZE = 0;
+
+  /** The default maximum number of idle sessions retained per configuration. */
+  public static final int DEFAULT_MAX_SIZE = Runtime.getRuntime().availableProcessors();
+
+  /** The default idle timeout in milliseconds (60 seconds). */
+  public static final long DEFAULT_IDLE_TIMEOUT_MILLIS = 60_000;
+
+  private static volatile int minSize = DEFAULT_MIN_SIZE;
+  private static volatile int maxSize = DEFAULT_MAX_SIZE;
+  private static volatile long idleTimeoutNanos =
+      TimeUnit.MILLISECONDS.toNanos(DEFAULT_IDLE_TIMEOUT_MILLIS);
+
+  private static final ConcurrentHashMap<Key, Partition> partitions = new ConcurrentHashMap<>();
+
+  private static ScheduledExecutorService evictor;
+  private static volatile ScheduledFuture<?> evictionTask;
+
+  private QatSessionPool() {}
+
+  /**
+   * Configures the pool. The new limits apply to all configurations; idle sessions in excess of
+   * the new maximum are torn down by the next eviction run.
+   *
+   * @param minSize the minimum number of idle sessions retained per configuration
+   * @param maxSize the maximum number of idle sessions retained per configuration
+   * @param idleTimeout the time after which an idle session may be torn down, or a non-positive
+   *     value to disable idle eviction
+   * @param unit the time unit of the idle timeout
+   */
+  public static synchronized void configure(
+      int minSize, int maxSize, long idleTimeout, TimeUnit unit) {
+    if (minSize < 0 || maxSize < minSize)
+      throw new IllegalArgumentException("Invalid pool size limits.");
+    Objects.requireNonNull(unit);
+
+    QatSessionPool.minSize = minSize;
+    QatSessionPool.maxSize = maxSize;
+    QatSessionPool.idleTimeoutNanos = idleTimeout > 0 ? unit.toNanos(idleTimeout) : 0;
+
+    if (evictionTask != null) {
+      evictionTask.cancel(false);
+      evictionTask = null;
+    }
+    scheduleEviction();
+  }
+
+  /**
+   * Returns the minimum number of idle sessions retained per configuration.
+   *
+   * @return the minimum pool size.
+   */
+  public static int getMinSize() {
+    return minSize;
+  }
+
+  /**
+   * Returns the maximum number of idle sessions retained per configuration.
+   *
+   * @return the maximum pool size.
+   */
+  public static int getMaxSize() {
+    return maxSize;
+  }
+
+  /**
+   * Returns the idle timeout in the given time unit, or 0 if idle eviction is disabled.
+   *
+   * @param unit the time unit of the returned value
+   * @return the idle timeout.
+   */
+  public static long getIdleTimeout(TimeUnit unit) {
+    return unit.convert(idleTimeoutNanos, TimeUnit.NANOSECONDS);
+  }
+
+  /**
+   * Tears down all idle sessions. Sessions currently borrowed are not affected and are returned to
+   * the pool as usual.
+   */
+  public static void clear() {
+    for (Partition p : partitions.values()) {
+      Idle e;
+      while ((e = p.idle.pollLast()) != null) {
+        p.idleCount.decrementAndGet();
+        InternalJNI.teardown(e.session);
+      }
+    }
+  }
+
+  /** Returns the number of idle sessions in the pool for the given key. */
+  static int idleCount(Key key) {
+    Partition p = partitions.get(key);
+    return p == null ? 0 : p.idleCount.get();
+  }
+
+  /**
+   * Borrows a session that matches the given key, setting up a new one if none is idle.
+   *
+   * @throws QatException if a new QAT session cannot be created.
+   */
+  static long borrow(Key key) {
+    Partition p = partitions.get(key);
+    if (p != null) {
+      Idle e = p.idle.pollFirst();
+      if (e != null) {
+        p.idleCount.decrementAndGet();
+        return e.session;
+      }
+    }
+    return key.createSession();
+  }
+
+  /** Returns a session to the pool, tearing it down if the pool is full. */
+  static void release(Key key, long session) {
+    InternalJNI.setChecksumEnabled(session, false);
+    if (key.pmode == PollingMode.ADAPTIVE)
+      InternalJNI.setSpinBudget(session, QatZipper.DEFAULT_SPIN_BUDGET_NANOS);
+    Partition p = partitions.computeIfAbsent(key, k -> new Partition());
+    if (p.idleCount.incrementAndGet() > maxSize) {
+      p.idleCount.decrementAndGet();
+      InternalJNI.teardown(session);
+      return;
+    }
+    p.idle.offerFirst(new Idle(session, System.nanoTime()));
+    if (evictionTask == null) startEvictor();
+  }
+
+  private static synchronized void startEvictor() {
+    if (evictionTask == null) scheduleEviction();
+  }
+
+  private static void scheduleEviction() {
+    long timeout = idleTimeoutNanos;
+    if (timeout == 0) return;
+
+    if (evictor == null) {
+      evictor =
+          Executors.newSingleThreadScheduledExecutor(
+              r -> {
+                Thread t = new Thread(r, "qat-session-pool-evictor");
+                t.setDaemon(true);
+                return t;
+              });
+    }
+    long period = Math.max(timeout / 2, TimeUnit.MILLISECONDS.toNanos(10));
+    evictionTask =
+        evictor.scheduleWithFixedDelay(
+            QatSessionPool::evictIdle, period, period, TimeUnit.NANOSECONDS);
+  }
+
+  /** Tears down sessions that have been idle longer than the idle timeout. */
+  static void evictIdle() {
+    long timeout = idleTimeoutNanos;
+    long now = System.nanoTime();
+    for (Partition p : partitions.values()) {
+      // Sessions are returned to the head of the deque, so the oldest ones are at the tail.
+      while (p.idleCount.get() > minSize) {
+        Idle e = p.idle.pollLast();
+        if (e == null) break;
+        boolean expired = timeout > 0 && now - e.releasedAt > timeout;
+        if (!expired && p.idleCount.get() <= maxSize) {
+          p.idle.offerLast(e);
+          break;
+        }
+        p.idleCount.decrementAndGet();
+        InternalJNI.teardown(e.session);
+      }
+    }
+  }
+
+  /** The set of parameters a pooled session is set up with. */
+  static final class Key {
+    final Algorithm algorithm;
+    final int level;
+    final Mode mode;
+    final PollingMode pmode;
+    final int softwareThreshold;
+    final Format format;
+
+    Key(Algorithm algorithm, int level, Mode mode, PollingMode pmode) {
+      this(algorithm, level, mode, pmode, QatZipper.DEFAULT_SOFTWARE_THRESHOLD);
+    }
+
+    Key(Algorithm algorithm, int level, Mode mode, PollingMode pmode, int softwareThreshold) {
+      this(algorithm, level, mode, pmode, softwareThreshold, QatZipper.DEFAULT_FORMAT);
+    }
+
+    /**
+     * Creates a key, resolving {@link QatZipper#AUTO_SOFTWARE_THRESHOLD} to the calibrated
+     * threshold. Hardware-only and ZSTD sessions ignore the threshold. Only DEFLATE sessions have a
+     * format other than {@link QatZipper#DEFAULT_FORMAT}.
+     */
+    Key(
+        Algorithm algorithm,
+        int level,
+        Mode mode,
+        PollingMode pmode,
+        int softwareThreshold,
+        Format format) {
+      this.algorithm = Objects.requireNonNull(algorithm);
+      this.level = level;
+      this.mode = Objects.requireNonNull(mode);
+      this.pmode = Objects.requireNonNull(pmode);
+      this.format = Objects.requireNonNull(format);
+      if (algorithm != Algorithm.DEFLATE && format != QatZipper.DEFAULT_FORMAT)
+        throw new IllegalArgumentException("Formats other than GZIP_EXT require DEFLATE.");
+      if (softwareThreshold != QatZipper.AUTO_SOFTWARE_THRESHOLD
+          && (softwareThreshold < QatZipper.MIN_SOFTWARE_THRESHOLD
+              || softwareThreshold > QatZipper.MAX_SOFTWARE_THRESHOLD))
+        throw new IllegalArgumentException("Invalid software threshold.");
+      if (mode == Mode.HARDWARE || algorithm == Algorithm.ZSTD)
+        this.softwareThreshold = QatZipper.MIN_SOFTWARE_THRESHOLD;
+      else if (softwareThreshold == QatZipper.AUTO_SOFTWARE_THRESHOLD)
+        this.softwareThreshold = QatCalibration.softwareThreshold(algorithm, level, pmode);
+      else this.softwareThreshold = softwareThreshold;
+    }
+
+    long createSession() {
+      return InternalJNI.setup(
+          algorithm.ordinal(),
+          level,
+          mode.ordinal(),
+          pmode.ordinal(),
+          softwareThreshold,
+          format.ordinal());
+    }
+
+    @Override
+    public boolean equals(Object o) {
+      if (this == o) return true;
+      if (!(o instanceof Key)) return false;
+      Key k = (Key) o;
+      return algorithm == k.algorithm
+          && level == k.level
+          && mode == k.mode
+          && pmode == k.pmode
+          && softwareThreshold == k.softwareThreshold
+          && format == k.format;
+    }
+
+    @Override
+    public int hashCode() {
+      return Objects.hash(algorithm, level, mode, pmode, softwareThreshold, format);
+    }
+  }
+
+  /** The idle sessions of one configuration. */
+  private static final class Partition {
+    final ConcurrentLinkedDeque<Idle> idle = new ConcurrentLinkedDeque<>();
+    final AtomicInteger idleCount = new AtomicInteger();
+  }
+
+  /** An idle session and the time it was returned to the pool. */
+  private static final class Idle {
+    final long session;
+    final long releasedAt;
+
+    Idle(long session, long releasedAt) {
+      this.session = session;
+      this.releasedAt = releasedAt;
+    }
+  }
+}
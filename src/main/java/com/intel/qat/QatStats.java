@@ -0,0 +1,359 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import java.lang.management.ManagementFactory;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.LinkedHashMap;
+import java.util.Map;
+import javax.management.JMException;
+import javax.management.MBeanServer;
+import javax.management.ObjectName;
+
+/**
+ * A snapshot of the counters kept by the native layer for a QAT session, or for all sessions. The
+ * counters cover bytes in and out, calls, calls on hardware and software sessions, retries, errors
+ * by QATzip status code, and a latency histogram.
+ *
+ * <p>Counting is disabled by default, in which case the native layer does no work beyond checking
+ * a flag. It can be enabled with {@link #setEnabled(boolean)} or by setting the
+ * <code>qat.stats.enabled</code> system property to <code>true</code>. The global counters can
+ * also be published over JMX with {@link #registerMBean()}.
+ */
+public final class QatStats {
+  /**
+   * The number of latency histogram buckets. Bucket <code>i</code> counts successful calls that
+   * took between 2<sup>i</sup> and 2<sup>i+1</sup> nanoseconds; the last bucket also counts slower
+   * calls.
+   */
+  public static final int LATENCY_BUCKETS = 32;
+
+  /** The name the global statistics MBean is registered under. */
+  public static final String MBEAN_NAME = "com.intel.qat:type=QatStats";
+
+  // The layout of the native counter array; it must match stats.h.
+  private static final int COMPRESS_CALLS = 0;
+  private static final int COMPRESS_BYTES_IN = 1;
+  private static final int COMPRESS_BYTES_OUT = 2;
+  private static final int DECOMPRESS_CALLS = 3;
+  private static final int DECOMPRESS_BYTES_IN = 4;
+  private static final int DECOMPRESS_BYTES_OUT = 5;
+  private static final int HW_CALLS = 6;
+  private static final int SW_CALLS = 7;
+  private static final int RETRIES = 8;
+  private static final int ERRORS = 9;
+  private static final int LATENCY = 10;
+  private static final int ERROR_COUNTS = LATENCY + LATENCY_BUCKETS;
+
+  private static final int[] ERROR_CODES = InternalJNI.statsErrorCodes();
+
+  /** The length of the native counter array. */
+  static final int LENGTH = ERROR_COUNTS + ERROR_CODES.length;
+
+  private final long[] counters;
+
+  QatStats(long[] counters) {
+    this.counters = counters;
+  }
+
+  /** Returns the counters of the given session, or the global counters if it is 0. */
+  static QatStats read(long session) {
+    long[] counters = new long[LENGTH];
+    InternalJNI.readStats(session, counters);
+    return new QatStats(counters);
+  }
+
+  /**
+   * Returns a snapshot of the counters of all sessions.
+   *
+   * @return the global statistics.
+   */
+  public static QatStats global() {
+    return read(0);
+  }
+
+  /** Resets the counters of all sessions combined. Per-session counters are not affected. */
+  public static void reset() {
+    InternalJNI.resetStats(0);
+  }
+
+  /**
+   * Enables or disables counting for all sessions.
+   *
+   * @param enabled true to enable counting
+   */
+  public static void setEnabled(boolean enabled) {
+    InternalJNI.setStatsEnabled(enabled);
+  }
+
+  /**
+   * Tells whether counting is enabled.
+   *
+   * @return true if counting is enabled.
+   */
+  public static boolean isEnabled() {
+    return InternalJNI.isStatsEnabled();
+  }
+
+  /**
+   * Registers an MBean with the platform MBean server that exposes the global counters under
+   * {@link #MBEAN_NAME}. Calling this method again has no effect.
+   *
+   * @throws IllegalStateException if the MBean cannot be registered
+   */
+  public static synchronized void registerMBean() {
+    MBeanServer server = ManagementFactory.getPlatformMBeanServer();
+    try {
+      ObjectName name = new ObjectName(MBEAN_NAME);
+      if (!server.isRegistered(name)) server.registerMBean(new MBean(), name);
+    } catch (JMException e) {
+      throw new IllegalStateException("Unable to register " + MBEAN_NAME, e);
+    }
+  }
+
+  /**
+   * Returns the number of compress calls.
+   *
+   * @return the number of compress calls.
+   */
+  public long getCompressCalls() {
+    return counters[COMPRESS_CALLS];
+  }
+
+  /**
+   * Returns the number of bytes read by successful compress calls.
+   *
+   * @return the number of uncompressed bytes.
+   */
+  public long getCompressBytesIn() {
+    return counters[COMPRESS_BYTES_IN];
+  }
+
+  /**
+   * Returns the number of bytes written by successful compress calls.
+   *
+   * @return the number of compressed bytes.
+   */
+  public long getCompressBytesOut() {
+    return counters[COMPRESS_BYTES_OUT];
+  }
+
+  /**
+   * Returns the number of decompress calls.
+   *
+   * @return the number of decompress calls.
+   */
+  public long getDecompressCalls() {
+    return counters[DECOMPRESS_CALLS];
+  }
+
+  /**
+   * Returns the number of bytes read by successful decompress calls.
+   *
+   * @return the number of compressed bytes.
+   */
+  public long getDecompressBytesIn() {
+    return counters[DECOMPRESS_BYTES_IN];
+  }
+
+  /**
+   * Returns the number of bytes written by successful decompress calls.
+   *
+   * @return the number of decompressed bytes.
+   */
+  public long getDecompressBytesOut() {
+    return counters[DECOMPRESS_BYTES_OUT];
+  }
+
+  /**
+   * Returns the number of calls made on sessions backed by QAT hardware.
+   *
+   * @return the number of hardware calls.
+   */
+  public long getHardwareCalls() {
+    return counters[HW_CALLS];
+  }
+
+  /**
+   * Returns the number of calls made on sessions that fell back to software because no hardware was
+   * available when they were set up.
+   *
+   * @return the number of software calls.
+   */
+  public long getSoftwareCalls() {
+    return counters[SW_CALLS];
+  }
+
+  /**
+   * Returns the number of retries made while waiting for a hardware instance.
+   *
+   * @return the number of retries.
+   */
+  public long getRetries() {
+    return counters[RETRIES];
+  }
+
+  /**
+   * Returns the number of calls that failed.
+   *
+   * @return the number of errors.
+   */
+  public long getErrors() {
+    return counters[ERRORS];
+  }
+
+  /**
+   * Returns the number of failed calls by QATzip status code. Codes without errors are omitted.
+   *
+   * @return an unmodifiable map from status code to error count.
+   */
+  public Map<Integer, Long> getErrorCounts() {
+    Map<Integer, Long> errors = new LinkedHashMap<>();
+    for (int i = 0; i < ERROR_CODES.length; i++) {
+      long count = counters[ERROR_COUNTS + i];
+      if (count > 0) errors.put(ERROR_CODES[i], count);
+    }
+    return Collections.unmodifiableMap(errors);
+  }
+
+  /**
+   * Returns the latency histogram of successful calls. See {@link #LATENCY_BUCKETS}.
+   *
+   * @return an array of {@link #LATENCY_BUCKETS} call counts.
+   */
+  public long[] getLatencyHistogram() {
+    return Arrays.copyOfRange(counters, LATENCY, LATENCY + LATENCY_BUCKETS);
+  }
+
+  /**
+   * Returns an upper bound of the given latency percentile, based on the latency histogram.
+   *
+   * @param percentile the percentile, between 0 and 100
+   * @return the upper bound in nanoseconds of the bucket holding the percentile, or 0 if no call
+   *     was counted.
+   */
+  public long getLatencyPercentile(double percentile) {
+    if (!(percentile >= 0 && percentile <= 100)) throw new IllegalArgumentException();
+
+    long total = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) total += counters[LATENCY + i];
+    if (total == 0) return 0;
+
+    long rank = Math.max(1, (long) Math.ceil(total * percentile / 100));
+    long seen = 0;
+    int bucket = 0;
+    for (; bucket < LATENCY_BUCKETS - 1; bucket++) {
+      seen += counters[LATENCY + bucket];
+      if (seen >= rank) break;
+    }
+    return bucket == LATENCY_BUCKETS - 1 ? Long.MAX_VALUE : 1L << (bucket + 1);
+  }
+
+  @Override
+  public String toString() {
+    return "QatStats[compressCalls="
+        + getCompressCalls()
+        + ", compressBytesIn="
+        + getCompressBytesIn()
+        + ", compressBytesOut="
+        + getCompressBytesOut()
+        + ", decompressCalls="
+        + getDecompressCalls()
+        + ", decompressBytesIn="
+        + getDecompressBytesIn()
+        + ", decompressBytesOut="
+        + getDecompressBytesOut()
+        + ", hardwareCalls="
+        + getHardwareCalls()
+        + ", softwareCalls="
+        + getSoftwareCalls()
+        + ", retries="
+        + getRetries()
+        + ", errors="
+        + getErrorCounts()
+        + "]";
+  }
+
+  /** The MBean that exposes the global counters, read afresh on every attribute access. */
+  private static final class MBean implements QatStatsMXBean {
+    @Override
+    public boolean isEnabled() {
+      return QatStats.isEnabled();
+    }
+
+    @Override
+    public void setEnabled(boolean enabled) {
+      QatStats.setEnabled(enabled);
+    }
+
+    @Override
+    public long getCompressCalls() {
+      return global().getCompressCalls();
+    }
+
+    @Override
+    public long getCompressBytesIn() {
+      return global().getCompressBytesIn();
+    }
+
+    @Override
+    public long getCompressBytesOut() {
+      return global().getCompressBytesOut();
+    }
+
+    @Override
+    public long getDecompressCalls() {
+      return global().getDecompressCalls();
+    }
+
+    @Override
+    public long getDecompressBytesIn() {
+      return global().getDecompressBytesIn();
+    }
+
+    @Override
+    public long getDecompressBytesOut() {
+      return global().getDecompressBytesOut();
+    }
+
+    @Override
+    public long getHardwareCalls() {
+      return global().getHardwareCalls();
+    }
+
+    @Override
+    public long getSoftwareCalls() {
+      return global().getSoftwareCalls();
+    }
+
+    @Override
+    public long getRetries() {
+      return global().getRetries();
+    }
+
+    @Override
+    public long getErrors() {
+      return global().getErrors();
+    }
+
+    @Override
+    public Map<Integer, Long> getErrorCounts() {
+      return global().getErrorCounts();
+    }
+
+    @Override
+    public long[] getLatencyHistogram() {
+      return global().getLatencyHistogram();
+    }
+
+    @Override
+    public void reset() {
+      QatStats.reset();
+    }
+  }
+}
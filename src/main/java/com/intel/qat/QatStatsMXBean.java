@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import java.util.Map;
+
+/**
+ * The management interface of the global QAT counters, registered with {@link
+ * QatStats#registerMBean()}. See {@link QatStats} for the meaning of each attribute.
+ */
+public interface QatStatsMXBean {
+  /**
+   * Tells whether counting is enabled.
+   *
+   * @return true if counting is enabled.
+   */
+  boolean isEnabled();
+
+  /**
+   * Enables or disables counting for all sessions.
+   *
+   * @param enabled true to enable counting
+   */
+  void setEnabled(boolean enabled);
+
+  /**
+   * Returns the number of compress calls.
+   *
+   * @return the number of compress calls.
+   */
+  long getCompressCalls();
+
+  /**
+   * Returns the number of bytes read by successful compress calls.
+   *
+   * @return the number of uncompressed bytes.
+   */
+  long getCompressBytesIn();
+
+  /**
+   * Returns the number of bytes written by successful compress calls.
+   *
+   * @return the number of compressed bytes.
+   */
+  long getCompressBytesOut();
+
+  /**
+   * Returns the number of decompress calls.
+   *
+   * @return the number of decompress calls.
+   */
+  long getDecompressCalls();
+
+  /**
+   * Returns the number of bytes read by successful decompress calls.
+   *
+   * @return the number of compressed bytes.
+   */
+  long getDecompressBytesIn();
+
+  /**
+   * Returns the number of bytes written by successful decompress calls.
+   *
+   * @return the number of decompressed bytes.
+   */
+  long getDecompressBytesOut();
+
+  /**
+   * Returns the number of calls made on sessions backed by QAT hardware.
+   *
+   * @return the number of hardware calls.
+   */
+  long getHardwareCalls();
+
+  /**
+   * Returns the number of calls made on sessions that fell back to software.
+   *
+   * @return the number of software calls.
+   */
+  long getSoftwareCalls();
+
+  /**
+   * Returns the number of retries made while waiting for a hardware instance.
+   *
+   * @return the number of retries.
+   */
+  long getRetries();
+
+  /**
+   * Returns the number of calls that failed.
+   *
+   * @return the number of errors.
+   */
+  long getErrors();
+
+  /**
+   * Returns the number of failed calls by QATzip status code.
+   *
+   * @return a map from status code to error count.
+   */
+  Map<Integer, Long> getErrorCounts();
+
+  /**
+   * Returns the latency histogram of successful calls.
+   *
+   * @return an array of {@link QatStats#LATENCY_BUCKETS} call counts.
+   */
+  long[] getLatencyHistogram();
+
+  /** Resets the global counters. */
+  void reset();
+}
@@ -9,6 +9,19 @@ package com.intel.qat;
 import java.lang.ref.Cleaner;
 import java.nio.ByteBuffer;
 import java.nio.ReadOnlyBufferException;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.Objects;
+import java.util.concurrent.CompletableFuture;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.concurrent.Executor;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.TimeUnit;
+import java.util.function.LongBinaryOperator;
+import java.util.function.LongUnaryOperator;
+import java.util.function.ToIntFunction;
 
 /**
  * This class provides methods that can be used to compress and decompress data using {@link
@@ -52,6 +65,14 @@ import java.nio.ReadOnlyBufferException;
  * To release QAT resources used by this <code>QatZipper</code>, the <code>end()</code> method
  * should be called explicitly. If not, resources will stay alive until this <code>QatZipper</code>
  * becomes phantom reachable.
+ *
+ * <p>Applications that create many short-lived <code>QatZipper</code> objects should use {@link
+ * #fromPool} instead, which borrows an already set up session from the {@link QatSessionPool}.
+ *
+ * <p>A <code>QatZipper</code> is not thread-safe and each call occupies its session until the
+ * accelerator responds. To keep several requests in flight from a single thread, use {@link
+ * #compressAsync} and {@link #decompressAsync}, which run each request on a pooled session with the
+ * same parameters as this <code>QatZipper</code>.
  */
 public class QatZipper {
   /** The default compression level is 6. */
@@ -68,13 +89,52 @@ public class QatZipper {
   /** The default polling mode. */
   public static final PollingMode DEFAULT_POLLING_MODE = PollingMode.BUSY;
 
+  /**
+   * The default time, 100 microseconds, for which a {@link PollingMode#ADAPTIVE} session busy polls
+   * a request. See {@link #setSpinBudget(long, TimeUnit)}.
+   */
+  public static final long DEFAULT_SPIN_BUDGET_NANOS = 100_000;
+
+  /**
+   * The default number of threads that run asynchronous requests. It can be set using the
+   * <code>qat.async.threads</code> system property and defaults to the number of processors.
+   */
+  public static final int DEFAULT_ASYNC_THREADS =
+      Integer.getInteger("qat.async.threads", Runtime.getRuntime().availableProcessors());
+
+  /** The smallest software threshold QATzip accepts (128 bytes). */
+  public static final int MIN_SOFTWARE_THRESHOLD = 128;
+
+  /** The largest software threshold (64KB), the size of a QATzip hardware buffer. */
+  public static final int MAX_SOFTWARE_THRESHOLD = 1 << 16;
+
+  /**
+   * Calibrates the software threshold when the first session with a given algorithm and level is
+   * set up. See {@link #QatZipper(Algorithm, int, Mode, int, PollingMode, int, int,
+   * QatDictionary)}.
+   */
+  public static final int AUTO_SOFTWARE_THRESHOLD = -1;
+
+  /**
+   * The default software threshold. It can be set using the <code>qat.sw.threshold</code> system
+   * property to a number of bytes or to <code>auto</code> for {@link #AUTO_SOFTWARE_THRESHOLD},
+   * and defaults to 1KB, the QATzip default.
+   */
+  public static final int DEFAULT_SOFTWARE_THRESHOLD = defaultSoftwareThreshold();
+
+  /** The default format of DEFLATE data. */
+  public static final Format DEFAULT_FORMAT = Format.GZIP_EXT;
+
   /** Indicates if a QAT session is valid or not. */
   private boolean isValid;
 
   /**
    * The number of retry counts for session creation before Qat-Java gives up and throws an error.
    */
-  private int retryCount;
+  private final int retryCount;
+
+  /** How requests without a QAT instance are retried, or null to retry them immediately. */
+  private QatRetryPolicy retryPolicy;
 
   /** Number of bytes read from the source by the most recent call to a compress/decompress. */
   private int bytesRead;
@@ -87,6 +147,39 @@ public class QatZipper {
   /** A reference to a QAT session in C. */
   private long session;
 
+  /** The parameters the QAT session was set up with. */
+  private final QatSessionPool.Key key;
+
+  /** The preset dictionary of the session, or null. */
+  private final QatDictionary dictionary;
+
+  /** Indicates if each call computes the checksum of its uncompressed data. */
+  private boolean checksumEnabled;
+
+  /** Indicates if compression adapts to the entropy of each source. */
+  private boolean adaptive;
+
+  /** The number of adaptive requests in a row that saved too little. */
+  private int incompressibleRun;
+
+  /** The number of requests stored without compressing them since the last probe. */
+  private int storedRun;
+
+  /** The spin budget of a {@link PollingMode#ADAPTIVE} session, in nanoseconds. */
+  private long spinBudgetNanos = DEFAULT_SPIN_BUDGET_NANOS;
+
+  /** Idle QatZippers that ran asynchronous requests on the shared executor, created on use. */
+  private volatile ConcurrentLinkedQueue<QatZipper> sharedAsyncIdle;
+
+  /** Idle QatZippers that ran asynchronous requests on other executors, created on use. */
+  private volatile ConcurrentLinkedQueue<QatZipper> asyncIdle;
+
+  /** Indicates if this QatZipper is acquired from {@link QatZippers} and not yet released. */
+  boolean acquired;
+
+  /** Gives up the place of this QatZipper in its {@link QatZippers} cache, or null. */
+  Cleaner.Cleanable slotCleanable;
+
   /** Cleaner instance associated with this object. */
   private static Cleaner cleaner;
 
@@ -94,7 +187,7 @@ public class QatZipper {
   private final Cleaner.Cleanable cleanable;
 
   static {
-    InternalJNI.initFieldIDs();
+    if (Boolean.getBoolean("qat.stats.enabled")) InternalJNI.setStatsEnabled(true);
 
     // Needed for applications where a Java security manager is in place -- e.g. OpenSearch.
     SecurityManager sm = System.getSecurityManager();
@@ -127,8 +220,8 @@ public class QatZipper {
 
   /**
    * Polling mode dictates how QAT processes compression/decompression requests and waits for a
-   * response, directly affecting the performance of these operations. Two polling modes are
-   * supported: BUSY and PERIODICAL. BUSY polling is the default polling mode.<br>
+   * response, directly affecting the performance of these operations. Three polling modes are
+   * supported: BUSY, PERIODICAL and ADAPTIVE. BUSY polling is the default polling mode.<br>
    * <br>
    * Use BUSY polling mode when:
    *
@@ -144,22 +237,221 @@ public class QatZipper {
    *   <li>Your workload has very high CPU utilization.
    *   <li>Your workload is throughput-sensitive.
    * </ul>
+   *
+   * <br>
+   * Use ADAPTIVE polling mode when:
+   *
+   * <ul>
+   *   <li>Your requests vary in size, and small ones are latency-sensitive.
+   *   <li>Your workload can spare cycles for short waits but not for long ones.
+   * </ul>
    */
   public static enum PollingMode {
     /** Use this mode unless your workload is CPU-bound. */
     BUSY,
 
     /** Use this mode when your workload is CPU-bound. */
-    PERIODICAL
+    PERIODICAL,
+
+    /**
+     * Busy polls requests expected to complete within the spin budget and polls longer ones
+     * periodically. The expected time of a request comes from the time per byte of recent
+     * busy-polled requests. A session in this mode holds two QAT sessions, one for each way of
+     * polling. See {@link QatZipper#setSpinBudget(long, TimeUnit)}.
+     */
+    ADAPTIVE
   }
 
-  /** The compression algorithm to use. DEFLATE and LZ4 are supported. */
+  /** The compression algorithm to use. DEFLATE, LZ4 and ZSTD are supported. */
   public static enum Algorithm {
     /** The deflate compression algorithm. */
     DEFLATE,
 
     /** The LZ4 compression algorithm. */
-    LZ4
+    LZ4,
+
+    /**
+     * The Zstandard compression algorithm. QAT finds the matches through the QAT-ZSTD plugin and
+     * libzstd entropy codes them in software; decompression runs in software. Each call to compress
+     * produces one Zstandard frame, which any Zstandard decoder can decompress. In {@link
+     * Mode#AUTO}, blocks that QAT cannot process are compressed entirely in software. ZSTD is only
+     * available if the native library was built with the plugin; see {@link
+     * #isSupported(Algorithm)}.
+     */
+    ZSTD
+  }
+
+  /**
+   * The format of the data of {@link Algorithm#DEFLATE} sessions. The other algorithms have a
+   * single format, {@link #GZIP_EXT}.
+   *
+   * <p>Each call to compress produces one complete gzip member, zlib stream or raw DEFLATE stream.
+   * QAT decompresses the gzip formats. Zlib and raw DEFLATE data do not record their compressed
+   * size, which QAT needs, so they are decompressed in software with zlib; each call to decompress
+   * only decompresses the complete streams in its source.
+   */
+  public static enum Format {
+    /**
+     * Gzip members with an extra field holding their sizes (QATzip's gzip-ext format), which any
+     * gzip decoder can read. This is the default.
+     */
+    GZIP_EXT,
+
+    /** Standard gzip members (RFC 1952). */
+    GZIP,
+
+    /**
+     * Zlib streams (RFC 1950), as used by <code>Content-Encoding: deflate</code> and PNG. QAT
+     * compresses the data, but the Adler-32 trailer is computed in software, in a second pass over
+     * the source. Decompression runs entirely in software.
+     */
+    ZLIB,
+
+    /**
+     * Raw DEFLATE streams (RFC 1951), with no header or trailer. QAT compresses the data, but
+     * decompression runs entirely in software.
+     */
+    RAW
+  }
+
+  /**
+   * Returns true if the given algorithm is available in this build of the native library.
+   *
+   * @param algorithm the compression {@link Algorithm}
+   * @return true if QatZipper objects can be created with the algorithm.
+   */
+  public static boolean isSupported(Algorithm algorithm) {
+    return algorithm != Algorithm.ZSTD || InternalJNI.isZstdAvailable();
+  }
+
+  /**
+   * Creates a new QatZipper with the specified parameters that compresses with a preset
+   * dictionary, or without one if <code>dictionary</code> is null, into the given {@link Format}.
+   * Sessions with a preset dictionary, and sessions of other algorithms than {@link
+   * Algorithm#DEFLATE}, only support {@link #DEFAULT_FORMAT}. QAT hardware has no support for
+   * preset dictionaries, so a session with a dictionary never sets up a QAT session: compression
+   * and decompression run in software, in the formats described by {@link QatDictionary}, and only
+   * {@link Mode#AUTO} is accepted. For small records with content in common, the better
+   * compression ratio usually outweighs the cost.
+   *
+   * <p>Below a few kilobytes, submitting a request to the accelerator costs more than compressing
+   * it on the CPU. In {@link Mode#AUTO}, sources smaller than <code>softwareThreshold</code> bytes
+   * are compressed in software, in the same format as the hardware produces. Sessions in {@link
+   * Mode#HARDWARE} never compress in software and ignore the threshold. With {@link
+   * #AUTO_SOFTWARE_THRESHOLD}, the threshold is the smallest source size for which the hardware was
+   * measured to be faster than software; the measurement takes a few milliseconds and runs once
+   * per algorithm and level.
+   *
+   * @param algorithm the compression {@link Algorithm}
+   * @param level the compression level.
+   * @param mode the {@link Mode} of QAT execution
+   * @param retryCount the number of attempts to acquire hardware resources
+   * @param pmode {@link PollingMode}
+   * @param softwareThreshold the software threshold, from {@link #MIN_SOFTWARE_THRESHOLD} to
+   *     {@link #MAX_SOFTWARE_THRESHOLD}, or {@link #AUTO_SOFTWARE_THRESHOLD}
+   * @param format the {@link Format} of the compressed data
+   * @param dictionary the preset dictionary, or null
+   * @throws QatException if QAT session cannot be created.
+   * @throws IllegalArgumentException if a dictionary is given with {@link Algorithm#ZSTD}, a format
+   *     other than {@link #DEFAULT_FORMAT} or {@link Mode#HARDWARE}.
+   */
+  public QatZipper(
+      Algorithm algorithm,
+      int level,
+      Mode mode,
+      int retryCount,
+      PollingMode pmode,
+      int softwareThreshold,
+      Format format,
+      QatDictionary dictionary)
+      throws QatException {
+    if (retryCount < 0) throw new IllegalArgumentException("Invalid value for retry count.");
+    if (dictionary != null && algorithm == Algorithm.ZSTD)
+      throw new IllegalArgumentException("Preset dictionaries are not supported with ZSTD.");
+    if (dictionary != null && format != DEFAULT_FORMAT)
+      throw new IllegalArgumentException("Preset dictionaries only support GZIP_EXT.");
+    if (dictionary != null && mode == Mode.HARDWARE)
+      throw new IllegalArgumentException("Preset dictionaries only run in software.");
+
+    this.retryCount = retryCount;
+    this.key = new QatSessionPool.Key(algorithm, level, mode, pmode, softwareThreshold, format);
+    this.dictionary = dictionary;
+    session =
+        dictionary == null
+            ? key.createSession()
+            : InternalJNI.setupDictionary(algorithm.ordinal(), level, dictionary.bytes());
+
+    // Register a QAT session cleaner for this object
+    cleanable = cleaner.register(this, new QatCleaner(session, null));
+    isValid = true;
+  }
+
+  /**
+   * Creates a new QatZipper with the specified parameters, a preset dictionary and {@link
+   * DEFAULT_FORMAT}. See {@link #QatZipper(Algorithm, int, Mode, int, PollingMode, int, Format,
+   * QatDictionary)}.
+   *
+   * @param algorithm the compression {@link Algorithm}
+   * @param level the compression level.
+   * @param mode the {@link Mode} of QAT execution
+   * @param retryCount the number of attempts to acquire hardware resources
+   * @param pmode {@link PollingMode}
+   * @param softwareThreshold the software threshold, from {@link #MIN_SOFTWARE_THRESHOLD} to
+   *     {@link #MAX_SOFTWARE_THRESHOLD}, or {@link #AUTO_SOFTWARE_THRESHOLD}
+   * @param dictionary the preset dictionary, or null
+   * @throws QatException if QAT session cannot be created.
+   */
+  public QatZipper(
+      Algorithm algorithm,
+      int level,
+      Mode mode,
+      int retryCount,
+      PollingMode pmode,
+      int softwareThreshold,
+      QatDictionary dictionary)
+      throws QatException {
+    this(
+        algorithm, level, mode, retryCount, pmode, softwareThreshold, DEFAULT_FORMAT, dictionary);
+  }
+
+  /**
+   * Creates a new QatZipper with the specified parameters, a preset dictionary and {@link
+   * DEFAULT_SOFTWARE_THRESHOLD}. See {@link #QatZipper(Algorithm, int, Mode, int, PollingMode, int,
+   * QatDictionary)}.
+   *
+   * @param algorithm the compression {@link Algorithm}
+   * @param level the compression level.
+   * @param mode the {@link Mode} of QAT execution
+   * @param retryCount the number of attempts to acquire hardware resources
+   * @param pmode {@link PollingMode}
+   * @param dictionary the preset dictionary, or null
+   * @throws QatException if QAT session cannot be created.
+   */
+  public QatZipper(
+      Algorithm algorithm,
+      int level,
+      Mode mode,
+      int retryCount,
+      PollingMode pmode,
+      QatDictionary dictionary)
+      throws QatException {
+    this(algorithm, level, mode, retryCount, pmode, DEFAULT_SOFTWARE_THRESHOLD, dictionary);
+  }
+
+  /**
+   * Creates a new QatZipper with the specified parameters and a preset dictionary, {@link
+   * DEFAULT_RETRY_COUNT} and {@link DEFAULT_POLLING_MODE}. See {@link #QatZipper(Algorithm, int,
+   * Mode, int, PollingMode, QatDictionary)}.
+   *
+   * @param algorithm the compression {@link Algorithm}
+   * @param level the compression level.
+   * @param mode the {@link Mode} of QAT execution
+   * @param dictionary the preset dictionary, or null
+   * @throws QatException if QAT session cannot be created.
+   */
+  public QatZipper(Algorithm algorithm, int level, Mode mode, QatDictionary dictionary)
+      throws QatException {
+    this(algorithm, level, mode, DEFAULT_RETRY_COUNT, DEFAULT_POLLING_MODE, dictionary);
   }
 
   /**
@@ -174,16 +466,124 @@ public class QatZipper {
    */
   public QatZipper(Algorithm algorithm, int level, Mode mode, int retryCount, PollingMode pmode)
       throws QatException {
+    this(algorithm, level, mode, retryCount, pmode, null);
+  }
+
+  /**
+   * Creates a new QatZipper that uses a session borrowed from the {@link QatSessionPool}.
+   *
+   * @param key the pool key of the session
+   * @param retryCount the number of attempts to acquire hardware resources
+   * @throws QatException if a new QAT session has to be created and cannot be.
+   */
+  QatZipper(QatSessionPool.Key key, int retryCount) {
     if (retryCount < 0) throw new IllegalArgumentException("Invalid value for retry count.");
 
     this.retryCount = retryCount;
-    InternalJNI.setup(this, algorithm.ordinal(), level, mode.ordinal(), pmode.ordinal());
+    this.key = key;
+    this.dictionary = null;
+    session = QatSessionPool.borrow(key);
 
-    // Register a QAT session cleaner for this object
-    cleanable = cleaner.register(this, new QatCleaner(session));
+    // Register a cleaner that returns the session to the pool
+    cleanable = cleaner.register(this, new QatCleaner(session, key));
     isValid = true;
   }
 
+  /**
+   * Returns a QatZipper with the specified parameters and software threshold whose session is
+   * borrowed from the {@link QatSessionPool}. See {@link #fromPool(Algorithm, int, Mode, int,
+   * PollingMode)}.
+   *
+   * @param algorithm the compression {@link Algorithm}
+   * @param level the compression level.
+   * @param mode the {@link Mode} of QAT execution
+   * @param retryCount the number of attempts to acquire hardware resources
+   * @param pmode {@link PollingMode}
+   * @param softwareThreshold the software threshold, from {@link #MIN_SOFTWARE_THRESHOLD} to
+   *     {@link #MAX_SOFTWARE_THRESHOLD}, or {@link #AUTO_SOFTWARE_THRESHOLD}
+   * @return a QatZipper backed by a pooled session
+   * @throws QatException if QAT session cannot be created.
+   */
+  public static QatZipper fromPool(
+      Algorithm algorithm,
+      int level,
+      Mode mode,
+      int retryCount,
+      PollingMode pmode,
+      int softwareThreshold) {
+    return new QatZipper(
+        new QatSessionPool.Key(algorithm, level, mode, pmode, softwareThreshold), retryCount);
+  }
+
+  /**
+   * Returns a QatZipper with the specified parameters whose session is borrowed from the {@link
+   * QatSessionPool}. A new session is set up only if the pool has no idle session with the same
+   * algorithm, level, mode and polling mode. Calling {@link #end()} returns the session to the
+   * pool.
+   *
+   * @param algorithm the compression {@link Algorithm}
+   * @param level the compression level.
+   * @param mode the {@link Mode} of QAT execution
+   * @param retryCount the number of attempts to acquire hardware resources
+   * @param pmode {@link PollingMode}
+   * @return a QatZipper backed by a pooled session
+   * @throws QatException if QAT session cannot be created.
+   */
+  public static QatZipper fromPool(
+      Algorithm algorithm, int level, Mode mode, int retryCount, PollingMode pmode) {
+    return new QatZipper(new QatSessionPool.Key(algorithm, level, mode, pmode), retryCount);
+  }
+
+  /**
+   * Returns a QatZipper with the specified parameters and {@link DEFAULT_RETRY_COUNT} whose session
+   * is borrowed from the {@link QatSessionPool}.
+   *
+   * @param algorithm the compression {@link Algorithm}
+   * @param level the compression level.
+   * @param mode the {@link Mode} of QAT execution
+   * @param pmode {@link PollingMode}
+   * @return a QatZipper backed by a pooled session
+   * @throws QatException if QAT session cannot be created.
+   */
+  public static QatZipper fromPool(Algorithm algorithm, int level, Mode mode, PollingMode pmode) {
+    return fromPool(algorithm, level, mode, DEFAULT_RETRY_COUNT, pmode);
+  }
+
+  /**
+   * Creates a new QatZipper that compresses with {@link Algorithm#DEFLATE} into the given {@link
+   * Format}. Uses {@link DEFAULT_RETRY_COUNT} and {@link DEFAULT_SOFTWARE_THRESHOLD}.
+   *
+   * @param format the {@link Format} of the compressed data
+   * @param level the compression level.
+   * @param mode the {@link Mode} of QAT execution
+   * @param pmode {@link PollingMode}
+   * @throws QatException if QAT session cannot be created.
+   */
+  public QatZipper(Format format, int level, Mode mode, PollingMode pmode) throws QatException {
+    this(
+        Algorithm.DEFLATE,
+        level,
+        mode,
+        DEFAULT_RETRY_COUNT,
+        pmode,
+        DEFAULT_SOFTWARE_THRESHOLD,
+        format,
+        null);
+  }
+
+  /**
+   * Creates a new QatZipper that compresses with {@link Algorithm#DEFLATE} into the given {@link
+   * Format}. Uses {@link DEFAULT_RETRY_COUNT} and {@link DEFAULT_POLLING_MODE}.
+   *
+   * @param format the {@link Format} of the compressed data
+   * @param level the compression level.
+   * @param mode the {@link Mode} of QAT execution
+   * @throws QatException if QAT session cannot be created.
+   */
+  public QatZipper(Format format, int level, Mode mode) throws QatException {
+    this(format, level, mode, DEFAULT_POLLING_MODE);
+  }
+
   /**
    * Creates a new QatZipper that uses {@link Algorithm#DEFLATE}, {@link DEFAULT_COMPRESS_LEVEL},
    * {@link DEFAULT_MODE}, {@link DEFAULT_RETRY_COUNT}, and {@link DEFAULT_POLLING_MODE}.
@@ -380,14 +780,28 @@ public class QatZipper {
 
     bytesRead = bytesWritten = 0;
 
-    int compressedSize =
-        InternalJNI.compressByteArray(
-            this, session, src, srcOffset, srcLen, dst, dstOffset, dstLen, retryCount);
+    if (adaptive && !checksumEnabled) {
+      compressAdaptive(
+          ByteBuffer.wrap(src, srcOffset, srcLen),
+          ByteBuffer.wrap(dst, dstOffset, dstLen),
+          (s, retries) ->
+              compressArray(s, src, srcOffset, srcLen, dst, dstOffset, dstLen, (int) retries));
+      return bytesWritten;
+    }
 
-    // bytesRead is updated by compressByteArray. We only need to update bytesWritten.
-    bytesWritten = compressedSize;
+    long result;
+    try {
+      result =
+          compressArray(
+              session, src, srcOffset, srcLen, dst, dstOffset, dstLen, nativeRetryCount());
+    } catch (QatException e) {
+      result = retry(e, s -> compressArray(s, src, srcOffset, srcLen, dst, dstOffset, dstLen, 0));
+    }
 
-    return compressedSize;
+    bytesRead = bytesRead(result);
+    bytesWritten = bytesWritten(result);
+
+    return bytesWritten;
   }
 
   /**
@@ -416,73 +830,29 @@ public class QatZipper {
 
     bytesRead = bytesWritten = 0;
 
-    int compressedSize = 0;
-    if (src.hasArray() && dst.hasArray()) {
-      compressedSize =
-          InternalJNI.compressByteBuffer(
-              session,
-              src,
-              src.array(),
-              srcPos,
-              src.remaining(),
-              dst.array(),
-              dstPos,
-              dst.remaining(),
-              retryCount);
-      dst.position(dstPos + compressedSize);
-    } else if (src.isDirect() && dst.isDirect()) {
-      compressedSize =
-          InternalJNI.compressDirectByteBuffer(
-              session, src, srcPos, src.remaining(), dst, dstPos, dst.remaining(), retryCount);
-    } else if (src.hasArray() && dst.isDirect()) {
-      compressedSize =
-          InternalJNI.compressDirectByteBufferDst(
-              session,
-              src,
-              src.array(),
-              srcPos,
-              src.remaining(),
-              dst,
-              dstPos,
-              dst.remaining(),
-              retryCount);
-    } else if (src.isDirect() && dst.hasArray()) {
-      compressedSize =
-          InternalJNI.compressDirectByteBufferSrc(
-              session,
-              src,
-              srcPos,
-              src.remaining(),
-              dst.array(),
-              dstPos,
-              dst.remaining(),
-              retryCount);
-      dst.position(dstPos + compressedSize);
-    } else {
-      int srcLen = src.remaining();
-      int dstLen = dst.remaining();
-
-      byte[] srcArr = new byte[srcLen];
-      byte[] dstArr = new byte[dstLen];
-
-      src.get(srcArr);
-      dst.get(dstArr);
-
-      src.position(src.position() - srcLen);
-      dst.position(dst.position() - dstLen);
+    if (adaptive && !checksumEnabled) {
+      compressAdaptive(
+          src.duplicate(),
+          dst.duplicate(),
+          (s, retries) -> compressBuffer(s, src, srcPos, dst, dstPos, (int) retries));
+      src.position(srcPos + bytesRead);
+      dst.position(dstPos + bytesWritten);
+      return bytesWritten;
+    }
 
-      int pos = src.position();
-      compressedSize =
-          InternalJNI.compressByteBuffer(
-              session, src, srcArr, 0, srcLen, dstArr, 0, dstLen, retryCount);
-      src.position(pos + src.position());
-      dst.put(dstArr, 0, compressedSize);
+    long result;
+    try {
+      result = compressBuffer(session, src, srcPos, dst, dstPos, nativeRetryCount());
+    } catch (QatException e) {
+      result = retry(e, s -> compressBuffer(s, src, srcPos, dst, dstPos, 0));
     }
 
-    bytesRead = src.position() - srcPos;
-    bytesWritten = dst.position() - dstPos;
+    bytesRead = bytesRead(result);
+    bytesWritten = bytesWritten(result);
+    src.position(srcPos + bytesRead);
+    dst.position(dstPos + bytesWritten);
 
-    return compressedSize;
+    return bytesWritten;
   }
 
   /**
@@ -522,14 +892,19 @@ public class QatZipper {
 
     bytesRead = bytesWritten = 0;
 
-    int decompressedSize =
-        InternalJNI.decompressByteArray(
-            this, session, src, srcOffset, srcLen, dst, dstOffset, dstLen, retryCount);
+    long result;
+    try {
+      result =
+          decompressArray(
+              session, src, srcOffset, srcLen, dst, dstOffset, dstLen, nativeRetryCount());
+    } catch (QatException e) {
+      result = retry(e, s -> decompressArray(s, src, srcOffset, srcLen, dst, dstOffset, dstLen, 0));
+    }
 
-    // bytesRead is updated by decompressedByteArray. We only need to update bytesWritten.
-    bytesWritten = decompressedSize;
+    bytesRead = bytesRead(result);
+    bytesWritten = bytesWritten(result);
 
-    return decompressedSize;
+    return bytesWritten;
   }
 
   /**
@@ -558,75 +933,1122 @@ public class QatZipper {
 
     bytesRead = bytesWritten = 0;
 
-    int decompressedSize = 0;
-    if (src.hasArray() && dst.hasArray()) {
-      decompressedSize =
-          InternalJNI.decompressByteBuffer(
+    long result;
+    try {
+      result = decompressBuffer(session, src, srcPos, dst, dstPos, nativeRetryCount());
+    } catch (QatException e) {
+      result = retry(e, s -> decompressBuffer(s, src, srcPos, dst, dstPos, 0));
+    }
+
+    bytesRead = bytesRead(result);
+    bytesWritten = bytesWritten(result);
+    src.position(srcPos + bytesRead);
+    dst.position(dstPos + bytesWritten);
+
+    return bytesWritten;
+  }
+
+  /**
+   * Compresses a batch of source buffers into the corresponding destination buffers with a single
+   * native call, which amortizes the per-call overhead of {@link #compress(ByteBuffer, ByteBuffer)}
+   * over many small buffers. The compressed size of <code>srcs[i]</code> is stored in <code>
+   * outLens[i]</code>, and the positions of both buffers are advanced as by {@link
+   * #compress(ByteBuffer, ByteBuffer)}.
+   *
+   * <p>A buffer whose request fails is retried as the retry policy says, and the batch resumes
+   * after it. If a buffer cannot be compressed, a QatException is thrown. The buffers before it
+   * have been compressed and their positions advanced; the remaining buffers are left untouched.
+   * After the call, {@link #getBytesRead()} and {@link #getBytesWritten()} return the totals for
+   * the batch.
+   *
+   * @param srcs the source buffers holding the source data
+   * @param dsts the destination buffers that will store the compressed data
+   * @param outLens an array that receives the size of the compressed data of each buffer
+   */
+  public void compressBatch(ByteBuffer[] srcs, ByteBuffer[] dsts, int[] outLens) {
+    processBatch(srcs, dsts, outLens, true);
+  }
+
+  /**
+   * Decompresses a batch of source buffers into the corresponding destination buffers with a single
+   * native call. The decompressed size of <code>srcs[i]</code> is stored in <code>outLens[i]
+   * </code>, and the positions of both buffers are advanced as by {@link #decompress(ByteBuffer,
+   * ByteBuffer)}. See {@link #compressBatch(ByteBuffer[], ByteBuffer[], int[])}.
+   *
+   * @param srcs the source buffers holding the compressed data
+   * @param dsts the destination buffers that will store the decompressed data
+   * @param outLens an array that receives the size of the decompressed data of each buffer
+   */
+  public void decompressBatch(ByteBuffer[] srcs, ByteBuffer[] dsts, int[] outLens) {
+    processBatch(srcs, dsts, outLens, false);
+  }
+
+  /**
+   * Compresses one source array with several QatZippers at once and stores the output of <code>
+   * zippers[i]</code> in <code>dsts[i]</code>. See {@link #compressAll(QatZipper[], ByteBuffer,
+   * ByteBuffer[])}.
+   *
+   * @param zippers the QatZippers, each with its own algorithm and level
+   * @param src the source array holding the source data
+   * @param dsts the destination arrays, one per QatZipper
+   * @return the size of the compressed data of each QatZipper
+   */
+  public static int[] compressAll(QatZipper[] zippers, byte[] src, byte[][] dsts) {
+    if (src == null || dsts == null) throw new IllegalArgumentException();
+    ByteBuffer[] buffers = new ByteBuffer[dsts.length];
+    for (int i = 0; i < dsts.length; i++) {
+      if (dsts[i] == null) throw new IllegalArgumentException();
+      buffers[i] = ByteBuffer.wrap(dsts[i]);
+    }
+    return compressAll(zippers, ByteBuffer.wrap(src), buffers);
+  }
+
+  /**
+   * Compresses one source buffer with several QatZippers at once, for example into LZ4 for data
+   * that is read often and into DEFLATE at level 9 for data that is archived, and stores the output
+   * of <code>zippers[i]</code> in <code>dsts[i]</code>. The source is read from memory once per
+   * zipper but pinned only once, and the zippers compress it concurrently within a single native
+   * call, the first on the calling thread and the others on worker threads that are kept for later
+   * calls, so the total time is close to that of the slowest zipper. Heap arrays stay pinned until
+   * the slowest zipper finishes.
+   *
+   * <p>On success, the position of each destination buffer is advanced by the size of its
+   * compressed data, the source position is advanced to its limit, and {@link #getBytesRead()} and
+   * {@link #getBytesWritten()} of each zipper describe its own compression. If a zipper fails, a
+   * QatException is thrown once all have finished, and no position is advanced. The retry count and
+   * retry policy of each zipper apply as for {@link #compress(ByteBuffer, ByteBuffer)}: a zipper
+   * whose request fails is retried on its own once the others have finished.
+   *
+   * @param zippers the QatZippers, each with its own algorithm and level; none may appear twice
+   * @param src the source buffer holding the source data
+   * @param dsts the destination buffers, one per QatZipper
+   * @return the size of the compressed data of each QatZipper
+   */
+  public static int[] compressAll(QatZipper[] zippers, ByteBuffer src, ByteBuffer[] dsts) {
+    if (zippers == null
+        || src == null
+        || dsts == null
+        || zippers.length == 0
+        || zippers.length != dsts.length)
+      throw new IllegalArgumentException("Mismatched or null arrays.");
+    if (!src.hasRemaining()) throw new IllegalArgumentException();
+
+    final int n = zippers.length;
+    long[] sessions = new long[n];
+    Object[] dstObjs = new Object[n];
+    int[] params = new int[3 * n];
+    for (int i = 0; i < n; i++) {
+      QatZipper zipper = zippers[i];
+      ByteBuffer dst = dsts[i];
+      if (zipper == null || dst == null || !dst.hasRemaining())
+        throw new IllegalArgumentException();
+      if (!zipper.isValid) throw new IllegalStateException("QAT session has been closed.");
+      if (dst.isReadOnly()) throw new ReadOnlyBufferException();
+      // Two threads must never share a session.
+      for (int j = 0; j < i; j++)
+        if (zippers[j] == zipper) throw new IllegalArgumentException("A QatZipper appears twice.");
+
+      sessions[i] = zipper.session;
+      dstObjs[i] = batchElement(dst);
+      params[3 * i] = batchOffset(dst);
+      params[3 * i + 1] = dst.remaining();
+      params[3 * i + 2] = zipper.nativeRetryCount();
+    }
+
+    // A read-only heap buffer has no accessible array; its bytes are copied once.
+    Object srcObj = batchElement(src);
+    int srcOffset = batchOffset(src);
+    if (srcObj == null) {
+      byte[] copy = new byte[src.remaining()];
+      src.duplicate().get(copy);
+      srcObj = copy;
+      srcOffset = 0;
+    }
+
+    for (QatZipper zipper : zippers) zipper.bytesRead = zipper.bytesWritten = 0;
+    int[] results = new int[2 * n];
+    InternalJNI.compressMulti(
+        sessions, srcObj, srcOffset, src.remaining(), dstObjs, params, results);
+
+    // A failed request reports -1 and its status; it is retried as its zipper's policy says.
+    final int srcPos = src.position();
+    for (int i = 0; i < n; i++) {
+      if (results[2 * i] >= 0) continue;
+      QatZipper zipper = zippers[i];
+      ByteBuffer dst = dsts[i];
+      final int dstPos = dst.position();
+      QatException e =
+          new QatException("Error occurred while compressing data.", results[2 * i + 1]);
+      long result = zipper.retry(e, s -> compressBuffer(s, src, srcPos, dst, dstPos, 0));
+      results[2 * i] = bytesRead(result);
+      results[2 * i + 1] = bytesWritten(result);
+    }
+
+    int[] outLens = new int[n];
+    for (int i = 0; i < n; i++) {
+      zippers[i].bytesRead = results[2 * i];
+      zippers[i].bytesWritten = outLens[i] = results[2 * i + 1];
+      dsts[i].position(dsts[i].position() + outLens[i]);
+    }
+    src.position(src.limit());
+    return outLens;
+  }
+
+  private void processBatch(ByteBuffer[] srcs, ByteBuffer[] dsts, int[] outLens, boolean compress) {
+    if (!isValid) throw new IllegalStateException("QAT session has been closed.");
+
+    if (srcs == null
+        || dsts == null
+        || outLens == null
+        || srcs.length != dsts.length
+        || outLens.length < srcs.length)
+      throw new IllegalArgumentException("Mismatched or null batch arrays.");
+
+    final int n = srcs.length;
+    Object[] srcObjs = new Object[n];
+    Object[] dstObjs = new Object[n];
+    int[] params = new int[4 * n];
+    boolean isNative = true;
+    for (int i = 0; i < n; i++) {
+      ByteBuffer src = srcs[i];
+      ByteBuffer dst = dsts[i];
+      if (src == null || dst == null || !src.hasRemaining() || !dst.hasRemaining())
+        throw new IllegalArgumentException();
+      if (dst.isReadOnly()) throw new ReadOnlyBufferException();
+
+      srcObjs[i] = batchElement(src);
+      dstObjs[i] = batchElement(dst);
+      isNative &= srcObjs[i] != null && dstObjs[i] != null;
+
+      params[4 * i] = batchOffset(src);
+      params[4 * i + 1] = src.remaining();
+      params[4 * i + 2] = batchOffset(dst);
+      params[4 * i + 3] = dst.remaining();
+    }
+
+    int totalRead = 0;
+    int totalWritten = 0;
+    bytesRead = bytesWritten = 0;
+
+    if (!isNative) {
+      // Buffers without an accessible memory region take the per-buffer path.
+      try {
+        for (int i = 0; i < n; i++) {
+          outLens[i] = compress ? compress(srcs[i], dsts[i]) : decompress(srcs[i], dsts[i]);
+          totalRead += bytesRead;
+          totalWritten += bytesWritten;
+        }
+      } finally {
+        bytesRead = totalRead;
+        bytesWritten = totalWritten;
+      }
+      return;
+    }
+
+    // A negative count marks buffers that were not processed.
+    int[] results = new int[2 * n];
+    Arrays.fill(results, -1);
+    try {
+      int done = 0;
+      while (done < n) {
+        try {
+          runBatch(compress, done, srcObjs, dstObjs, params, results);
+          done = n;
+        } catch (QatException e) {
+          while (done < n && results[2 * done] >= 0) done++;
+          if (done == n) throw e;
+          // The failed buffer is retried as compress() and decompress() retry, then the rest of
+          // the batch resumes after it.
+          final ByteBuffer src = srcs[done];
+          final ByteBuffer dst = dsts[done];
+          final int srcPos = src.position();
+          final int dstPos = dst.position();
+          long result =
+              retry(
+                  e,
+                  s ->
+                      compress
+                          ? compressBuffer(s, src, srcPos, dst, dstPos, 0)
+                          : decompressBuffer(s, src, srcPos, dst, dstPos, 0));
+          results[2 * done] = bytesRead(result);
+          results[2 * done + 1] = bytesWritten(result);
+          done++;
+        }
+      }
+    } finally {
+      for (int i = 0; i < n && results[2 * i] >= 0; i++) {
+        srcs[i].position(srcs[i].position() + results[2 * i]);
+        dsts[i].position(dsts[i].position() + results[2 * i + 1]);
+        outLens[i] = results[2 * i + 1];
+        totalRead += results[2 * i];
+        totalWritten += results[2 * i + 1];
+      }
+      bytesRead = totalRead;
+      bytesWritten = totalWritten;
+    }
+  }
+
+  /**
+   * Runs the native batch call on the buffers from the given index on, and stores their results at
+   * the same index of <code>results</code>.
+   */
+  private void runBatch(
+      boolean compress, int from, Object[] srcObjs, Object[] dstObjs, int[] params, int[] results) {
+    final int n = srcObjs.length;
+    Object[] srcs = from == 0 ? srcObjs : Arrays.copyOfRange(srcObjs, from, n);
+    Object[] dsts = from == 0 ? dstObjs : Arrays.copyOfRange(dstObjs, from, n);
+    int[] p = from == 0 ? params : Arrays.copyOfRange(params, 4 * from, 4 * n);
+    int[] r = from == 0 ? results : Arrays.copyOfRange(results, 2 * from, 2 * n);
+    try {
+      if (compress) InternalJNI.compressBatch(session, srcs, dsts, p, r, nativeRetryCount());
+      else InternalJNI.decompressBatch(session, srcs, dsts, p, r, nativeRetryCount());
+    } finally {
+      if (r != results) System.arraycopy(r, 0, results, 2 * from, r.length);
+    }
+  }
+
+  /**
+   * Creates the native state of a decompression stream on this session. QATzip buffers the data
+   * fed to a stream, so compressed blocks may arrive in chunks of any size. A stream must be ended
+   * with {@link #endStream(long)} before the session is ended.
+   */
+  long createStream() {
+    if (!isValid) throw new IllegalStateException("QAT session has been closed.");
+    if (dictionary != null) throw new IllegalStateException("Streams do not use dictionaries.");
+    if (key.algorithm == Algorithm.ZSTD)
+      throw new IllegalStateException("Streams do not support ZSTD.");
+
+    return InternalJNI.createStream();
+  }
+
+  /**
+   * Feeds the given source range to a decompression stream and copies out the decompressed data
+   * that is ready, which may be none. The source may end anywhere, even in the middle of a
+   * compressed block. <code>last</code> must be true once the compressed input has ended.
+   *
+   * @return the number of decompressed bytes written to the destination.
+   */
+  int decompressStream(
+      long stream,
+      byte[] src,
+      int srcOffset,
+      int srcLen,
+      byte[] dst,
+      int dstOffset,
+      int dstLen,
+      boolean last) {
+    if (!isValid) throw new IllegalStateException("QAT session has been closed.");
+
+    bytesRead = bytesWritten = 0;
+
+    long result;
+    try {
+      result =
+          InternalJNI.decompressStream(
               session,
+              stream,
               src,
-              src.array(),
-              srcPos,
-              src.remaining(),
-              dst.array(),
-              dstPos,
-              dst.remaining(),
-              retryCount);
-      dst.position(dstPos + decompressedSize);
+              srcOffset,
+              srcLen,
+              dst,
+              dstOffset,
+              dstLen,
+              last,
+              nativeRetryCount());
+    } catch (QatException e) {
+      // The stream state belongs to this session, so the request never fails over.
+      result =
+          retry(
+              e,
+              s ->
+                  InternalJNI.decompressStream(
+                      s, stream, src, srcOffset, srcLen, dst, dstOffset, dstLen, last, 0),
+              false);
+    }
+
+    bytesRead = bytesRead(result);
+    bytesWritten = bytesWritten(result);
+
+    return bytesWritten;
+  }
+
+  /** Tells whether a stream holds input it has not processed or output not yet copied out. */
+  boolean streamPending(long stream) {
+    return InternalJNI.streamPending(stream) > 0;
+  }
+
+  /** Releases the buffers QATzip holds for a stream and frees its native state. */
+  void endStream(long stream) {
+    if (!isValid) throw new IllegalStateException("QAT session has been closed.");
+
+    InternalJNI.endStream(session, stream);
+  }
+
+  /**
+   * Runs an asynchronous request on an idle QatZipper kept by this one for the executor, or on a
+   * new one, with the settings of this QatZipper. The QatZipper is kept for later requests until
+   * this one ends, so that requests do not each set up a session, or a dictionary, and register a
+   * cleaner.
+   */
+  private int runAsync(Executor executor, ToIntFunction<QatZipper> request) {
+    ConcurrentLinkedQueue<QatZipper> idle = asyncIdle(executor == AsyncExecutor.INSTANCE);
+    QatZipper zipper = idle.poll();
+    if (zipper == null) zipper = asyncZipper(executor);
+    boolean done = false;
+    try {
+      zipper.retryPolicy = retryPolicy;
+      if (zipper.spinBudgetNanos != spinBudgetNanos)
+        zipper.setSpinBudget(spinBudgetNanos, TimeUnit.NANOSECONDS);
+      if (zipper.checksumEnabled != checksumEnabled) zipper.setChecksumEnabled(checksumEnabled);
+      zipper.adaptive = adaptive;
+      int result = request.applyAsInt(zipper);
+      done = true;
+      return result;
+    } finally {
+      if (done && isValid) {
+        idle.offer(zipper);
+        // end() may have drained the queue before the offer.
+        if (!isValid) endIdle(idle);
+      } else {
+        zipper.end();
+      }
+    }
+  }
+
+  /** Returns the queue of idle asynchronous QatZippers for the shared executor or for others. */
+  private ConcurrentLinkedQueue<QatZipper> asyncIdle(boolean shared) {
+    ConcurrentLinkedQueue<QatZipper> idle = shared ? sharedAsyncIdle : asyncIdle;
+    if (idle != null) return idle;
+    synchronized (this) {
+      if (shared && sharedAsyncIdle == null) sharedAsyncIdle = new ConcurrentLinkedQueue<>();
+      if (!shared && asyncIdle == null) asyncIdle = new ConcurrentLinkedQueue<>();
+      return shared ? sharedAsyncIdle : asyncIdle;
+    }
+  }
+
+  /** Ends the idle asynchronous QatZippers of a queue. */
+  private static void endIdle(ConcurrentLinkedQueue<QatZipper> idle) {
+    if (idle == null) return;
+    QatZipper zipper;
+    while ((zipper = idle.poll()) != null) zipper.end();
+  }
+
+  /**
+   * Returns a new QatZipper for asynchronous requests on the given executor, with the same
+   * parameters as this one. Its session comes from the pool unless this QatZipper has a
+   * dictionary, in which case a new session is set up with the same dictionary. On the shared
+   * executor, a {@link PollingMode#BUSY} session is replaced by a {@link PollingMode#PERIODICAL}
+   * one, so that its threads do not each spin on a core while their requests run.
+   */
+  private QatZipper asyncZipper(Executor executor) {
+    PollingMode pmode =
+        executor == AsyncExecutor.INSTANCE && key.pmode == PollingMode.BUSY
+            ? PollingMode.PERIODICAL
+            : key.pmode;
+    QatZipper zipper =
+        dictionary == null
+            ? new QatZipper(
+                new QatSessionPool.Key(
+                    key.algorithm,
+                    key.level,
+                    key.mode,
+                    pmode,
+                    key.softwareThreshold,
+                    key.format),
+                retryCount)
+            : new QatZipper(
+                key.algorithm,
+                key.level,
+                key.mode,
+                retryCount,
+                pmode,
+                key.softwareThreshold,
+                key.format,
+                dictionary);
+    return zipper;
+  }
+
+  /** Returns the number of bytes read from a result packed by the native layer. */
+  private static int bytesRead(long result) {
+    return (int) (result >>> 32);
+  }
+
+  /** Returns the number of bytes written from a result packed by the native layer. */
+  private static int bytesWritten(long result) {
+    return (int) result;
+  }
+
+  /**
+   * Runs a request of another backend, such as {@link QatForeign}, on the session of this
+   * QatZipper with its retry count and retry policy, and records the bytes read and written.
+   *
+   * @param request the request, which runs on the given session with the given retry count and
+   *     returns a packed result
+   * @return the packed result.
+   */
+  long run(LongBinaryOperator request) {
+    if (!isValid) throw new IllegalStateException("QAT session has been closed.");
+
+    bytesRead = bytesWritten = 0;
+
+    long result;
+    try {
+      result = request.applyAsLong(session, nativeRetryCount());
+    } catch (QatException e) {
+      result = retry(e, s -> request.applyAsLong(s, 0));
+    }
+
+    bytesRead = bytesRead(result);
+    bytesWritten = bytesWritten(result);
+    return result;
+  }
+
+  /**
+   * Compresses the remaining bytes of the source view into the destination view as adaptive
+   * compression decides, and records the bytes read and written. The views cover the source and
+   * the destination of the request, which compresses on the given session with the given retry
+   * count; their positions do not change.
+   */
+  private void compressAdaptive(ByteBuffer src, ByteBuffer dst, LongBinaryOperator request) {
+    int len = src.remaining();
+    long storedLength = QatAdaptive.storedLength(key.format, len);
+    boolean storable = storedLength <= dst.remaining();
+    if (storable && skipCompression()) {
+      store(src, dst);
+      return;
+    }
+    double entropy = QatAdaptive.entropy(src);
+    if (storable && entropy >= QatAdaptive.STORE_ENTROPY) {
+      store(src, dst);
+      return;
+    }
+
+    long result =
+        entropy >= QatAdaptive.FAST_ENTROPY && key.level > QatAdaptive.FAST_LEVEL
+            ? runFast(request)
+            : run(request);
+    bytesRead = bytesRead(result);
+    bytesWritten = bytesWritten(result);
+    boolean saved = bytesRead < len || len - bytesWritten >= len >>> QatAdaptive.MIN_SAVING_SHIFT;
+    incompressibleRun = saved ? 0 : incompressibleRun + 1;
+
+    // Never return more than stored blocks take.
+    if (storable && bytesRead == len && bytesWritten >= storedLength) store(src, dst);
+  }
+
+  /**
+   * Returns true if a request should be stored without compressing it, because the recent ones
+   * saved too little. Every {@link QatAdaptive#PROBE_INTERVAL}th request is compressed anyway, so
+   * that compression resumes when the data changes.
+   */
+  private boolean skipCompression() {
+    if (incompressibleRun < QatAdaptive.INCOMPRESSIBLE_RUN) return false;
+    return ++storedRun % QatAdaptive.PROBE_INTERVAL != 0;
+  }
+
+  /** Writes the source view to the destination view as stored blocks. */
+  private void store(ByteBuffer src, ByteBuffer dst) {
+    bytesRead = src.remaining();
+    bytesWritten = QatAdaptive.writeStored(key.format, key.level, src, dst);
+  }
+
+  /**
+   * Runs a request on a pooled session at {@link QatAdaptive#FAST_LEVEL}, or, if there is none or
+   * the request fails on it, on the session of this QatZipper. The pooled session polls with the
+   * spin budget of this QatZipper, and gets the default one back before it is released.
+   */
+  private long runFast(LongBinaryOperator request) {
+    QatSessionPool.Key fast =
+        new QatSessionPool.Key(
+            key.algorithm,
+            QatAdaptive.FAST_LEVEL,
+            key.mode,
+            key.pmode,
+            key.softwareThreshold,
+            key.format);
+    long s;
+    try {
+      s = QatSessionPool.borrow(fast);
+    } catch (QatException e) {
+      return run(request);
+    }
+    boolean spinBudget =
+        key.pmode == PollingMode.ADAPTIVE && spinBudgetNanos != DEFAULT_SPIN_BUDGET_NANOS;
+    try {
+      if (spinBudget) InternalJNI.setSpinBudget(s, spinBudgetNanos);
+      return request.applyAsLong(s, nativeRetryCount());
+    } catch (QatException e) {
+      // Retried below on this session, with its retry policy.
+    } finally {
+      if (spinBudget) InternalJNI.setSpinBudget(s, DEFAULT_SPIN_BUDGET_NANOS);
+      QatSessionPool.release(fast, s);
+    }
+    return run(request);
+  }
+
+  /** Returns the retry count passed to native calls that the retry policy retries itself. */
+  private int nativeRetryCount() {
+    return retryPolicy == null ? retryCount : 0;
+  }
+
+  /**
+   * Retries a request that failed because no QAT instance could be attached, as the retry policy
+   * says. The request is retried on the session of this QatZipper, then, with failover, on the
+   * sessions of {@link #failoverKeys()}.
+   *
+   * @param e the exception of the failed request
+   * @param request the request, which runs on the given session and returns a packed result
+   * @return the packed result of the first successful retry.
+   * @throws QatException <code>e</code> if the policy does not apply or every retry failed.
+   */
+  private long retry(QatException e, LongUnaryOperator request) {
+    return retry(e, request, true);
+  }
+
+  /**
+   * Retries a request as {@link #retry(QatException, LongUnaryOperator)} does, moving it to other
+   * sessions only if <code>failover</code> is true.
+   */
+  private long retry(QatException e, LongUnaryOperator request, boolean failover) {
+    QatRetryPolicy policy = retryPolicy;
+    if (policy == null || e.getErrorCode() != QatRetryPolicy.NO_INSTANCE) throw e;
+
+    long deadline = policy.deadline();
+    for (int attempt = 0; attempt < policy.getMaxRetries(); attempt++) {
+      if (!policy.await(attempt, deadline)) break;
+      try {
+        return request.applyAsLong(session);
+      } catch (QatException f) {
+        if (f.getErrorCode() != QatRetryPolicy.NO_INSTANCE) throw f;
+      }
+    }
+
+    if (!failover || !policy.isFailover() || dictionary != null || checksumEnabled) throw e;
+    for (QatSessionPool.Key k : failoverKeys()) {
+      long s;
+      try {
+        s = QatSessionPool.borrow(k);
+      } catch (QatException f) {
+        e.addSuppressed(f);
+        continue;
+      }
+      try {
+        return request.applyAsLong(s);
+      } catch (QatException f) {
+        if (f.getErrorCode() != QatRetryPolicy.NO_INSTANCE) throw f;
+      } finally {
+        QatSessionPool.release(k, s);
+      }
+    }
+    throw e;
+  }
+
+  /**
+   * Returns the keys of the pooled sessions a request moves to when the session of this QatZipper
+   * has no instance: for hardware-only zippers, a session that falls back to software.
+   */
+  private List<QatSessionPool.Key> failoverKeys() {
+    List<QatSessionPool.Key> keys = new ArrayList<>(1);
+    if (key.mode == Mode.HARDWARE)
+      keys.add(
+          new QatSessionPool.Key(
+              key.algorithm,
+              key.level,
+              Mode.AUTO,
+              key.pmode,
+              key.softwareThreshold,
+              key.format));
+    return keys;
+  }
+
+  /**
+   * Compresses a byte array on the given session with the foreign function backend if it is
+   * enabled, or with JNI, and returns the bytes read and written packed as by the native layer.
+   */
+  private static long compressArray(
+      long session,
+      byte[] src,
+      int srcOffset,
+      int srcLen,
+      byte[] dst,
+      int dstOffset,
+      int dstLen,
+      int retryCount) {
+    if (QatForeign.isEnabled())
+      return QatForeign.compressByteArray(
+          session, src, srcOffset, srcLen, dst, dstOffset, dstLen, retryCount);
+    return InternalJNI.compressByteArray(
+        session, src, srcOffset, srcLen, dst, dstOffset, dstLen, retryCount);
+  }
+
+  /**
+   * Decompresses a byte array on the given session with the foreign function backend if it is
+   * enabled, or with JNI, and returns the bytes read and written packed as by the native layer.
+   */
+  private static long decompressArray(
+      long session,
+      byte[] src,
+      int srcOffset,
+      int srcLen,
+      byte[] dst,
+      int dstOffset,
+      int dstLen,
+      int retryCount) {
+    if (QatForeign.isEnabled())
+      return QatForeign.decompressByteArray(
+          session, src, srcOffset, srcLen, dst, dstOffset, dstLen, retryCount);
+    return InternalJNI.decompressByteArray(
+        session, src, srcOffset, srcLen, dst, dstOffset, dstLen, retryCount);
+  }
+
+  /**
+   * Compresss the remaining bytes of the source buffer into the destination buffer on the
+   * given session, and returns the bytes read and written packed as by the native layer.
+   */
+  private static long compressBuffer(
+      long session, ByteBuffer src, int srcPos, ByteBuffer dst, int dstPos, int retryCount) {
+    if (src.hasArray() && dst.hasArray()) {
+      if (QatForeign.isEnabled())
+        return QatForeign.compressByteArray(
+            session,
+            src.array(),
+            srcPos,
+            src.remaining(),
+            dst.array(),
+            dstPos,
+            dst.remaining(),
+            retryCount);
+      return InternalJNI.compressByteBuffer(
+          session,
+          src,
+          src.array(),
+          srcPos,
+          src.remaining(),
+          dst.array(),
+          dstPos,
+          dst.remaining(),
+          retryCount);
     } else if (src.isDirect() && dst.isDirect()) {
-      decompressedSize =
-          InternalJNI.decompressDirectByteBuffer(
-              session, src, srcPos, src.remaining(), dst, dstPos, dst.remaining(), retryCount);
+      return InternalJNI.compressDirectByteBuffer(
+          session, src, srcPos, src.remaining(), dst, dstPos, dst.remaining(), retryCount);
     } else if (src.hasArray() && dst.isDirect()) {
-      decompressedSize =
-          InternalJNI.decompressDirectByteBufferDst(
-              session,
-              src,
-              src.array(),
-              srcPos,
-              src.remaining(),
-              dst,
-              dstPos,
-              dst.remaining(),
-              retryCount);
+      return InternalJNI.compressDirectByteBufferDst(
+          session,
+          src,
+          src.array(),
+          srcPos,
+          src.remaining(),
+          dst,
+          dstPos,
+          dst.remaining(),
+          retryCount);
     } else if (src.isDirect() && dst.hasArray()) {
-      decompressedSize =
-          InternalJNI.decompressDirectByteBufferSrc(
-              session,
-              src,
-              srcPos,
-              src.remaining(),
-              dst.array(),
-              dstPos,
-              dst.remaining(),
-              retryCount);
-      dst.position(dstPos + decompressedSize);
-    } else {
-      int srcLen = src.remaining();
-      int dstLen = dst.remaining();
+      return InternalJNI.compressDirectByteBufferSrc(
+          session,
+          src,
+          srcPos,
+          src.remaining(),
+          dst.array(),
+          dstPos,
+          dst.remaining(),
+          retryCount);
+    } else if (dst.isDirect()) {
+      // A read-only heap source: a null array makes the native code read its backing array.
+      return InternalJNI.compressDirectByteBufferDst(
+          session,
+          src,
+          null,
+          srcPos,
+          src.remaining(),
+          dst,
+          dstPos,
+          dst.remaining(),
+          retryCount);
+    }
+    return InternalJNI.compressByteBuffer(
+        session,
+        src,
+        null,
+        srcPos,
+        src.remaining(),
+        dst.array(),
+        dstPos,
+        dst.remaining(),
+        retryCount);
+  }
 
-      byte[] srcArr = new byte[srcLen];
-      byte[] dstArr = new byte[dstLen];
+  /**
+   * Decompresss the remaining bytes of the source buffer into the destination buffer on the
+   * given session, and returns the bytes read and written packed as by the native layer.
+   */
+  private static long decompressBuffer(
+      long session, ByteBuffer src, int srcPos, ByteBuffer dst, int dstPos, int retryCount) {
+    if (src.hasArray() && dst.hasArray()) {
+      if (QatForeign.isEnabled())
+        return QatForeign.decompressByteArray(
+            session,
+            src.array(),
+            srcPos,
+            src.remaining(),
+            dst.array(),
+            dstPos,
+            dst.remaining(),
+            retryCount);
+      return InternalJNI.decompressByteBuffer(
+          session,
+          src,
+          src.array(),
+          srcPos,
+          src.remaining(),
+          dst.array(),
+          dstPos,
+          dst.remaining(),
+          retryCount);
+    } else if (src.isDirect() && dst.isDirect()) {
+      return InternalJNI.decompressDirectByteBuffer(
+          session, src, srcPos, src.remaining(), dst, dstPos, dst.remaining(), retryCount);
+    } else if (src.hasArray() && dst.isDirect()) {
+      return InternalJNI.decompressDirectByteBufferDst(
+          session,
+          src,
+          src.array(),
+          srcPos,
+          src.remaining(),
+          dst,
+          dstPos,
+          dst.remaining(),
+          retryCount);
+    } else if (src.isDirect() && dst.hasArray()) {
+      return InternalJNI.decompressDirectByteBufferSrc(
+          session,
+          src,
+          srcPos,
+          src.remaining(),
+          dst.array(),
+          dstPos,
+          dst.remaining(),
+          retryCount);
+    } else if (dst.isDirect()) {
+      // A read-only heap source: a null array makes the native code read its backing array.
+      return InternalJNI.decompressDirectByteBufferDst(
+          session,
+          src,
+          null,
+          srcPos,
+          src.remaining(),
+          dst,
+          dstPos,
+          dst.remaining(),
+          retryCount);
+    }
+    return InternalJNI.decompressByteBuffer(
+        session,
+        src,
+        null,
+        srcPos,
+        src.remaining(),
+        dst.array(),
+        dstPos,
+        dst.remaining(),
+        retryCount);
+  }
 
-      src.get(srcArr);
-      dst.get(dstArr);
+  /** Reads the <code>qat.sw.threshold</code> system property, ignoring malformed values. */
+  private static int defaultSoftwareThreshold() {
+    String value = System.getProperty("qat.sw.threshold");
+    if (value != null && value.equalsIgnoreCase("auto")) return AUTO_SOFTWARE_THRESHOLD;
+    Integer threshold = Integer.getInteger("qat.sw.threshold");
+    return threshold != null ? threshold : 1024;
+  }
 
-      src.position(src.position() - srcLen);
-      dst.position(dst.position() - dstLen);
+  /** Returns the object whose memory the native batch call reads, or null if there is none. */
+  private static Object batchElement(ByteBuffer buf) {
+    if (buf.isDirect()) return buf;
+    if (buf.hasArray()) return buf.array();
+    return null;
+  }
 
-      int pos = src.position();
-      decompressedSize =
-          InternalJNI.decompressByteBuffer(
-              session, src, srcArr, 0, srcLen, dstArr, 0, dstLen, retryCount);
-      src.position(pos + src.position());
-      dst.put(dstArr, 0, decompressedSize);
-    }
+  /** Returns the offset of the buffer's position within its batch element. */
+  private static int batchOffset(ByteBuffer buf) {
+    return buf.hasArray() ? buf.arrayOffset() + buf.position() : buf.position();
+  }
+
+  /**
+   * Compresses the source buffer into the destination buffer asynchronously, using a session from
+   * the {@link QatSessionPool} with the same parameters as this QatZipper. The request runs on a
+   * shared pool of {@link #DEFAULT_ASYNC_THREADS} threads, so a single caller can keep many
+   * requests in flight. The request has the retry policy, spin budget, checksum and adaptive
+   * settings of this QatZipper, but a {@link PollingMode#BUSY} QatZipper polls it periodically, so
+   * that the threads of the pool do not each occupy a core. Sessions, including those set up with
+   * the dictionary of this QatZipper, are kept for later requests until {@link #end()}.
+   *
+   * <p>The buffers must not be accessed until the returned future completes. On success the
+   * positions of both buffers are advanced as by {@link #compress(ByteBuffer, ByteBuffer)}; {@link
+   * #getBytesRead()} and {@link #getBytesWritten()} of this QatZipper are not updated.
+   *
+   * @param src the source buffer holding the source data
+   * @param dst the destination buffer that will store the compressed data
+   * @return a future that completes with the size of the compressed data in bytes
+   */
+  public CompletableFuture<Integer> compressAsync(ByteBuffer src, ByteBuffer dst) {
+    return compressAsync(src, dst, AsyncExecutor.INSTANCE);
+  }
+
+  /**
+   * Compresses the source buffer into the destination buffer asynchronously on the given executor.
+   * See {@link #compressAsync(ByteBuffer, ByteBuffer)}. The request keeps the polling mode of this
+   * QatZipper; with {@link PollingMode#BUSY}, each thread of the executor running a request
+   * occupies a core until it completes.
+   *
+   * @param src the source buffer holding the source data
+   * @param dst the destination buffer that will store the compressed data
+   * @param executor the executor that runs the request
+   * @return a future that completes with the size of the compressed data in bytes
+   */
+  public CompletableFuture<Integer> compressAsync(
+      ByteBuffer src, ByteBuffer dst, Executor executor) {
+    if (!isValid) throw new IllegalStateException("QAT session has been closed.");
+    Objects.requireNonNull(executor);
+
+    return CompletableFuture.supplyAsync(
+        () -> runAsync(executor, qzip -> qzip.compress(src, dst)), executor);
+  }
+
+  /**
+   * Decompresses the source buffer into the destination buffer asynchronously, using a session from
+   * the {@link QatSessionPool} with the same parameters as this QatZipper. See {@link
+   * #compressAsync(ByteBuffer, ByteBuffer)}.
+   *
+   * @param src the source buffer holding the compressed data
+   * @param dst the destination buffer that will store the decompressed data
+   * @return a future that completes with the size of the decompressed data in bytes
+   */
+  public CompletableFuture<Integer> decompressAsync(ByteBuffer src, ByteBuffer dst) {
+    return decompressAsync(src, dst, AsyncExecutor.INSTANCE);
+  }
+
+  /**
+   * Decompresses the source buffer into the destination buffer asynchronously on the given
+   * executor. See {@link #compressAsync(ByteBuffer, ByteBuffer)}.
+   *
+   * @param src the source buffer holding the compressed data
+   * @param dst the destination buffer that will store the decompressed data
+   * @param executor the executor that runs the request
+   * @return a future that completes with the size of the decompressed data in bytes
+   */
+  public CompletableFuture<Integer> decompressAsync(
+      ByteBuffer src, ByteBuffer dst, Executor executor) {
+    if (!isValid) throw new IllegalStateException("QAT session has been closed.");
+    Objects.requireNonNull(executor);
+
+    return CompletableFuture.supplyAsync(
+        () -> runAsync(executor, qzip -> qzip.decompress(src, dst)), executor);
+  }
+
+  /**
+   * Sets how requests for which no QAT instance is available are retried; see {@link
+   * QatRetryPolicy}. While a policy is set, it replaces the retry count this QatZipper was created
+   * with. Only sessions in {@link Mode#HARDWARE} report missing instances; in {@link Mode#AUTO},
+   * QATzip compresses such requests in software.
+   *
+   * @param policy the retry policy, or null to retry immediately up to the retry count this
+   *     QatZipper was created with
+   */
+  public void setRetryPolicy(QatRetryPolicy policy) {
+    retryPolicy = policy;
+  }
+
+  /**
+   * Returns the retry policy of this QatZipper.
+   *
+   * @return the retry policy, or null if requests are retried immediately.
+   */
+  public QatRetryPolicy getRetryPolicy() {
+    return retryPolicy;
+  }
+
+  /**
+   * Sets the time for which a {@link PollingMode#ADAPTIVE} session busy polls a request. Requests
+   * expected to take longer are polled periodically, which frees the CPU while the accelerator
+   * works but adds up to a polling interval to their latency. A larger budget favours latency, a
+   * smaller one CPU time; a budget of 0 polls all requests periodically.
+   *
+   * @param spinBudget the spin budget
+   * @param unit the time unit of the spin budget
+   * @throws IllegalStateException if the polling mode is not {@link PollingMode#ADAPTIVE}.
+   */
+  public void setSpinBudget(long spinBudget, TimeUnit unit) {
+    if (!isValid) throw new IllegalStateException("QAT session has been closed.");
+    if (key.pmode != PollingMode.ADAPTIVE)
+      throw new IllegalStateException("The polling mode is not adaptive.");
+    if (spinBudget < 0) throw new IllegalArgumentException("Invalid spin budget.");
+
+    long nanos = unit.toNanos(spinBudget);
+    InternalJNI.setSpinBudget(session, nanos);
+    spinBudgetNanos = nanos;
+  }
+
+  /**
+   * Returns the time for which a {@link PollingMode#ADAPTIVE} session busy polls a request.
+   *
+   * @param unit the time unit of the returned value
+   * @return the spin budget.
+   * @throws IllegalStateException if the polling mode is not {@link PollingMode#ADAPTIVE}.
+   */
+  public long getSpinBudget(TimeUnit unit) {
+    if (key.pmode != PollingMode.ADAPTIVE)
+      throw new IllegalStateException("The polling mode is not adaptive.");
+
+    return unit.convert(spinBudgetNanos, TimeUnit.NANOSECONDS);
+  }
+
+  /**
+   * Enables or disables adaptive compression, for mixed data that is partly already compressed.
+   * An adaptive QatZipper estimates the entropy of each source from the byte histogram of its first
+   * 4KB. Sources that look incompressible are written as stored DEFLATE blocks without using QAT,
+   * sources that look poorly compressible are compressed at level 1 on a pooled session, and the
+   * rest at the level of this QatZipper. Output larger than stored blocks is replaced by stored
+   * blocks. After several requests in a row that saved less than 1/32 of their source, most
+   * requests are stored without sampling them; every 8th is still compressed, so that compression
+   * resumes when the data changes.
+   *
+   * <p>The output is standard data of the format of this QatZipper and decompresses as usual.
+   * Adaptive compression applies to {@link #compress(byte[], int, int, byte[], int, int)} and
+   * {@link #compress(ByteBuffer, ByteBuffer)}, and not while checksums are enabled.
+   *
+   * @param adaptive true to compress adaptively
+   * @throws IllegalStateException if the algorithm is not {@link Algorithm#DEFLATE} or the
+   *     QatZipper has a preset dictionary.
+   */
+  public void setAdaptive(boolean adaptive) {
+    if (!isValid) throw new IllegalStateException("QAT session has been closed.");
+    if (adaptive && (key.algorithm != Algorithm.DEFLATE || dictionary != null))
+      throw new IllegalStateException(
+          "Adaptive compression requires DEFLATE without a dictionary.");
+
+    this.adaptive = adaptive;
+    incompressibleRun = storedRun = 0;
+  }
 
-    if (decompressedSize < 0) throw new QatException("QAT: Compression failed");
+  /**
+   * Returns true if adaptive compression is enabled.
+   *
+   * @return true if adaptive compression is enabled, false otherwise.
+   */
+  public boolean isAdaptive() {
+    return adaptive;
+  }
+
+  /**
+   * Enables or disables checksums. While enabled, each call to compress and decompress a byte array
+   * or a buffer computes the CRC-32 of its uncompressed data, which {@link #getChecksum()} returns.
+   * The value is the same as the one {@link java.util.zip.CRC32} produces.
+   *
+   * <p>With {@link Algorithm#DEFLATE}, the checksum comes for free: the accelerator computes it
+   * while compressing, and on decompression it is combined from the verified CRC-32 trailers of the
+   * compressed data. Otherwise, and with a preset dictionary, it is computed in native code over
+   * the uncompressed data. Comparing the checksum of compression with that of decompression checks
+   * the integrity of the data end to end without another pass over it in Java.
+   *
+   * @param enabled true to compute checksums
+   */
+  public void setChecksumEnabled(boolean enabled) {
+    if (!isValid) throw new IllegalStateException("QAT session has been closed.");
+
+    InternalJNI.setChecksumEnabled(session, enabled);
+    checksumEnabled = enabled;
+  }
+
+  /**
+   * Returns true if checksums are enabled.
+   *
+   * @return true if checksums are enabled, false otherwise.
+   */
+  public boolean isChecksumEnabled() {
+    return checksumEnabled;
+  }
+
+  /**
+   * Returns the CRC-32 of the uncompressed data of the most recent call to compress/decompress a
+   * byte array or a buffer, or of the last element of the most recent batch call. Asynchronous
+   * requests run on other sessions and do not update it.
+   *
+   * @return the CRC-32 of the uncompressed data.
+   * @throws IllegalStateException if checksums are not enabled.
+   */
+  public long getChecksum() {
+    if (!isValid) throw new IllegalStateException("QAT session has been closed.");
+    if (!checksumEnabled) throw new IllegalStateException("Checksums are not enabled.");
+
+    return InternalJNI.checksum(session);
+  }
 
-    bytesRead = src.position() - srcPos;
-    bytesWritten = dst.position() - dstPos;
+  /**
+   * Returns a snapshot of the counters of the QAT session. The counters are only updated while
+   * {@link QatStats#isEnabled()} is true. A session borrowed from the {@link QatSessionPool} keeps
+   * its counters across borrowers.
+   *
+   * @return the statistics of the session.
+   */
+  public QatStats getStats() {
+    if (!isValid) throw new IllegalStateException("QAT session has been closed.");
 
-    return decompressedSize;
+    return QatStats.read(session);
+  }
+
+  /**
+   * Returns the preset dictionary of this QatZipper.
+   *
+   * @return the dictionary, or null if there is none.
+   */
+  public QatDictionary getDictionary() {
+    return dictionary;
+  }
+
+  /**
+   * Returns the format of the data this QatZipper compresses and decompresses.
+   *
+   * @return the {@link Format}; {@link Format#GZIP_EXT} for algorithms other than DEFLATE.
+   * @throws IllegalStateException if this QatZipper has a preset dictionary, whose data is in none
+   *     of the formats; see {@link QatDictionary}.
+   */
+  public Format getFormat() {
+    if (dictionary != null)
+      throw new IllegalStateException("Dictionary data is not in any QatZipper format.");
+    return key.format;
+  }
+
+  /**
+   * Returns the size below which sources are compressed in software. For sessions set up with
+   * {@link #AUTO_SOFTWARE_THRESHOLD}, this is the calibrated threshold.
+   *
+   * @return the software threshold in bytes; it has no effect in {@link Mode#HARDWARE}.
+   */
+  public int getSoftwareThreshold() {
+    return key.softwareThreshold;
+  }
+
+  /** Returns the parameters the QAT session was set up with. */
+  QatSessionPool.Key key() {
+    return key;
+  }
+
+  /** Returns true if the QAT session has not been closed. */
+  boolean isValid() {
+    return isValid;
+  }
+
+  /**
+   * Restores the settings a borrower may have changed to those of a new QatZipper, before the
+   * QatZipper is handed to another borrower.
+   */
+  void reset() {
+    if (checksumEnabled) setChecksumEnabled(false);
+    if (spinBudgetNanos != DEFAULT_SPIN_BUDGET_NANOS)
+      setSpinBudget(DEFAULT_SPIN_BUDGET_NANOS, TimeUnit.NANOSECONDS);
+    retryPolicy = null;
+    adaptive = false;
+    incompressibleRun = storedRun = 0;
   }
 
   /**
@@ -650,30 +2072,74 @@ public class QatZipper {
   }
 
   /**
-   * Ends the current QAT session by freeing up resources. A new session must be used after a
-   * successful call of this method.
+   * Ends the current QAT session by freeing up resources, or returns it to the {@link
+   * QatSessionPool} if this QatZipper was obtained from {@link #fromPool}. The sessions kept for
+   * asynchronous requests are ended as well. A new session must be used after a successful call of
+   * this method.
    *
    * @throws QatException if QAT session cannot be gracefully ended.
    */
   public void end() throws QatException {
     if (!isValid) throw new IllegalStateException("QAT session has been closed.");
-    InternalJNI.teardown(session);
     isValid = false;
+    cleanable.clean();
+    endIdle(sharedAsyncIdle);
+    endIdle(asyncIdle);
+  }
+
+  /** Holds the shared executor for asynchronous requests, created on first use. */
+  static class AsyncExecutor {
+    static final ExecutorService INSTANCE =
+        Executors.newFixedThreadPool(
+            Math.max(1, DEFAULT_ASYNC_THREADS),
+            r -> {
+              Thread t = new Thread(r, "qat-async");
+              t.setDaemon(true);
+              return t;
+            });
+  }
+
+  /**
+   * Holds the threads that run the background stages of pipelined streams. Those stages block on
+   * I/O, so they do not share the fixed-size asynchronous executor.
+   */
+  static class StreamExecutor {
+    static final ExecutorService INSTANCE =
+        Executors.newCachedThreadPool(
+            r -> {
+              Thread t = new Thread(r, "qat-stream");
+              t.setDaemon(true);
+              return t;
+            });
+  }
+
+  /**
+   * Registers an action to run when the given object becomes phantom reachable, on the cleaner of
+   * this class.
+   */
+  static Cleaner.Cleanable registerCleanup(Object obj, Runnable action) {
+    return cleaner.register(obj, action);
   }
 
   /** A class that represents a cleaner action for a QAT session. */
   static class QatCleaner implements Runnable {
     private long qzSession;
+    private final QatSessionPool.Key poolKey;
 
-    /** Creates a new cleaner object that cleans up the specified session. */
-    public QatCleaner(long session) {
+    /**
+     * Creates a new cleaner object that cleans up the specified session, or returns it to the pool
+     * if a pool key is given.
+     */
+    public QatCleaner(long session, QatSessionPool.Key poolKey) {
       this.qzSession = session;
+      this.poolKey = poolKey;
     }
 
     @Override
     public void run() {
       if (qzSession != 0) {
-        InternalJNI.teardown(qzSession);
+        if (poolKey != null) QatSessionPool.release(poolKey, qzSession);
+        else InternalJNI.teardown(qzSession);
       }
     }
   }
@@ -0,0 +1,280 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
+
+import java.util.ArrayDeque;
+import java.util.Objects;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.locks.Condition;
+import java.util.concurrent.locks.ReentrantLock;
+import java.util.function.Function;
+
+/**
+ * A process-wide cache of {@link QatZipper} objects for applications that compress from many
+ * threads. A <code>QatZipper</code> is not thread-safe, and keeping one per thread, for example in
+ * a <code>ThreadLocal</code>, sets up a QAT session for every thread that ever compresses. With
+ * virtual threads, that is a session per task.
+ *
+ * <p>Instead, a thread acquires a <code>QatZipper</code> for the duration of a request and releases
+ * it afterwards:
+ *
+ * <pre>{@code
+ * int compressedSize =
+ *     QatZippers.withZipper(Algorithm.DEFLATE, 6, Mode.AUTO, qzip -> qzip.compress(src, dst));
+ * }</pre>
+ *
+ * <p>The cache keeps at most {@link #getMaxSize()} zippers per configuration, by default one per
+ * processor, which is as many as can run at once. A thread that acquires a zipper while all of
+ * them are in use waits until one is released; waiting does not hold a carrier thread, so virtual
+ * threads waiting for a zipper do not hold up the platform threads that run them. The number of
+ * sessions is thereby bounded by the number of processors, not of threads.
+ *
+ * <p>A released zipper is reset: checksums are disabled, its retry policy is removed and its spin
+ * budget restored. Zippers that are not released are not reused, and count against the maximum
+ * until they are garbage collected, when their session returns to the {@link QatSessionPool}.
+ */
+public final class QatZippers {
+  /**
+   * The default maximum number of zippers per configuration. It can be set using the <code>
+   * qat.zippers.max</code> system property and defaults to the number of processors.
+   */
+  public static final int DEFAULT_MAX_SIZE =
+      Integer.getInteger("qat.zippers.max", Runtime.getRuntime().availableProcessors());
+
+  private static volatile int maxSize = Math.max(1, DEFAULT_MAX_SIZE);
+
+  private static final ConcurrentHashMap<QatSessionPool.Key, Slot> slots =
+      new ConcurrentHashMap<>();
+
+  private QatZippers() {}
+
+  /**
+   * Sets the maximum number of zippers per configuration. If the new maximum is lower, zippers in
+   * excess of it are ended as they are released.
+   *
+   * @param maxSize the maximum number of zippers per configuration
+   */
+  public static void setMaxSize(int maxSize) {
+    if (maxSize < 1) throw new IllegalArgumentException("Invalid maximum size.");
+    QatZippers.maxSize = maxSize;
+    for (Slot slot : slots.values()) slot.signalAll();
+  }
+
+  /**
+   * Returns the maximum number of zippers per configuration.
+   *
+   * @return the maximum number of zippers per configuration.
+   */
+  public static int getMaxSize() {
+    return maxSize;
+  }
+
+  /**
+   * Acquires a QatZipper with the specified parameters, waiting if the maximum number of zippers
+   * with these parameters is in use. The zipper must be released with {@link #release(QatZipper)}
+   * instead of being ended.
+   *
+   * @param algorithm the compression {@link Algorithm}
+   * @param level the compression level.
+   * @param mode the {@link Mode} of QAT execution
+   * @param pmode {@link PollingMode}
+   * @return a QatZipper for the exclusive use of the caller until it is released
+   * @throws QatException if QAT session cannot be created, or the calling thread is interrupted
+   *     while waiting.
+   */
+  public static QatZipper acquire(Algorithm algorithm, int level, Mode mode, PollingMode pmode) {
+    QatSessionPool.Key key = new QatSessionPool.Key(algorithm, level, mode, pmode);
+    QatZipper zipper = slots.computeIfAbsent(key, Slot::new).take();
+    zipper.acquired = true;
+    return zipper;
+  }
+
+  /**
+   * Acquires a QatZipper with the specified parameters and {@link
+   * QatZipper#DEFAULT_POLLING_MODE}. See {@link #acquire(Algorithm, int, Mode, PollingMode)}.
+   *
+   * @param algorithm the compression {@link Algorithm}
+   * @param level the compression level.
+   * @param mode the {@link Mode} of QAT execution
+   * @return a QatZipper for the exclusive use of the caller until it is released
+   * @throws QatException if QAT session cannot be created, or the calling thread is interrupted
+   *     while waiting.
+   */
+  public static QatZipper acquire(Algorithm algorithm, int level, Mode mode) {
+    return acquire(algorithm, level, mode, QatZipper.DEFAULT_POLLING_MODE);
+  }
+
+  /**
+   * Releases a QatZipper acquired with {@link #acquire}, so that other threads can use it. The
+   * caller must not use the zipper afterwards.
+   *
+   * @param zipper the zipper to release
+   * @throws IllegalArgumentException if the zipper was not acquired, or was already released.
+   */
+  public static void release(QatZipper zipper) {
+    if (!zipper.acquired) throw new IllegalArgumentException("The QatZipper is not acquired.");
+    zipper.acquired = false;
+    slots.get(zipper.key()).put(zipper);
+  }
+
+  /**
+   * Runs a task with a QatZipper acquired for its duration and returns its result. The zipper is
+   * released when the task returns or throws.
+   *
+   * @param algorithm the compression {@link Algorithm}
+   * @param level the compression level.
+   * @param mode the {@link Mode} of QAT execution
+   * @param task the task to run
+   * @param <T> the type of the result
+   * @return the result of the task.
+   * @throws QatException if QAT session cannot be created, or the calling thread is interrupted
+   *     while waiting.
+   */
+  public static <T> T withZipper(
+      Algorithm algorithm, int level, Mode mode, Function<QatZipper, T> task) {
+    Objects.requireNonNull(task);
+    QatZipper zipper = acquire(algorithm, level, mode);
+    try {
+      return task.apply(zipper);
+    } finally {
+      release(zipper);
+    }
+  }
+
+  /** Ends all idle zippers. Zippers currently acquired are not affected. */
+  public static void clear() {
+    for (Slot slot : slots.values()) slot.clear();
+  }
+
+  /** Returns the number of zippers with the given parameters, acquired or idle. */
+  static int size(QatSessionPool.Key key) {
+    Slot slot = slots.get(key);
+    return slot == null ? 0 : slot.size();
+  }
+
+  /**
+   * The zippers of one configuration. A lock rather than a monitor guards them, since a virtual
+   * thread blocked on a monitor holds its carrier thread.
+   */
+  private static final class Slot {
+    final QatSessionPool.Key key;
+    final ArrayDeque<QatZipper> idle = new ArrayDeque<>();
+    final ReentrantLock lock = new ReentrantLock();
+    final Condition released = lock.newCondition();
+
+    /** The number of zippers created and not ended, acquired or idle. */
+    int live;
+
+    Slot(QatSessionPool.Key key) {
+      this.key = key;
+    }
+
+    /** Returns an idle zipper, or a new one if there is none and the maximum allows it. */
+    QatZipper take() {
+      lock.lock();
+      try {
+        while (idle.isEmpty() && live >= maxSize) released.await();
+        QatZipper zipper = idle.pollFirst();
+        if (zipper != null) return zipper;
+        live++;
+      } catch (InterruptedException e) {
+        Thread.currentThread().interrupt();
+        throw new QatException("Interrupted while waiting for a QatZipper.");
+      } finally {
+        lock.unlock();
+      }
+
+      // Set the session up outside the lock, so that releases are not held up.
+      QatZipper zipper;
+      try {
+        zipper = new QatZipper(key, QatZipper.DEFAULT_RETRY_COUNT);
+      } catch (RuntimeException e) {
+        vacate();
+        throw e;
+      }
+      // A zipper that is never released gives up its place when it is garbage collected.
+      zipper.slotCleanable = QatZipper.registerCleanup(zipper, this::vacate);
+      return zipper;
+    }
+
+    /** Takes a released zipper back, ending it if it is closed or in excess of the maximum. */
+    void put(QatZipper zipper) {
+      if (zipper.isValid()) {
+        try {
+          zipper.reset();
+        } catch (RuntimeException e) {
+          drop(zipper);
+          throw e;
+        }
+      }
+      lock.lock();
+      try {
+        if (zipper.isValid() && live <= maxSize) {
+          idle.offerFirst(zipper);
+          released.signal();
+          return;
+        }
+      } finally {
+        lock.unlock();
+      }
+      drop(zipper);
+    }
+
+    /** Ends the given zipper, if it is still open, and makes room for a new one. */
+    void drop(QatZipper zipper) {
+      if (zipper.isValid()) zipper.end();
+      zipper.slotCleanable.clean();
+    }
+
+    /** Makes room for a new zipper; runs once for every zipper created. */
+    private void vacate() {
+      lock.lock();
+      try {
+        live--;
+        released.signal();
+      } finally {
+        lock.unlock();
+      }
+    }
+
+    void clear() {
+      while (true) {
+        QatZipper zipper;
+        lock.lock();
+        try {
+          zipper = idle.pollLast();
+        } finally {
+          lock.unlock();
+        }
+        if (zipper == null) return;
+        drop(zipper);
+      }
+    }
+
+    void signalAll() {
+      lock.lock();
+      try {
+        released.signalAll();
+      } finally {
+        lock.unlock();
+      }
+    }
+
+    int size() {
+      lock.lock();
+      try {
+        return live;
+      } finally {
+        lock.unlock();
+      }
+    }
+  }
+}
@@ -11,5 +11,7 @@
  * through JNI bindings.
  */
 module com.intel.qat {
+  requires java.management;
+
   exports com.intel.qat;
 }
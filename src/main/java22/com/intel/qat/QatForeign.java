@@ -0,0 +1,237 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static java.lang.foreign.ValueLayout.ADDRESS;
+import static java.lang.foreign.ValueLayout.JAVA_BYTE;
+import static java.lang.foreign.ValueLayout.JAVA_INT;
+import static java.lang.foreign.ValueLayout.JAVA_LONG;
+
+import java.lang.foreign.Arena;
+import java.lang.foreign.FunctionDescriptor;
+import java.lang.foreign.Linker;
+import java.lang.foreign.MemorySegment;
+import java.lang.foreign.SymbolLookup;
+import java.lang.invoke.MethodHandle;
+
+/**
+ * The foreign function backend, which calls the native library through java.lang.foreign instead
+ * of JNI for heap arrays: their data is copied to and from native memory rather than pinned with
+ * GetPrimitiveArrayCritical, so that a request never holds off the garbage collector while it runs
+ * on QAT. Native segments are passed to the native library as they are.
+ *
+ * <p>The backend downcalls the <code>qat_java_compress</code> and <code>qat_java_decompress</code>
+ * entry points of the JNI library, which run on the same sessions and with the same session
+ * features as the JNI entry points. Copying costs throughput, so byte arrays use the backend only
+ * if the <code>qat.backend</code> system property is set to <code>foreign</code>; {@link
+ * QatSegments} uses it whenever the entry points can be linked, which they cannot if native access
+ * is denied to this module.
+ *
+ * <p>A platform thread keeps its scratch memory for later requests, up to {@link
+ * #MAX_SCRATCH_SIZE}. Larger requests, and requests on virtual threads, copy through memory that
+ * is freed when the request returns.
+ */
+final class QatForeign {
+  private static final MethodHandle COMPRESS;
+  private static final MethodHandle DECOMPRESS;
+
+  /** Whether byte array requests use this backend. */
+  private static final boolean ENABLED =
+      "foreign".equalsIgnoreCase(System.getProperty("qat.backend"));
+
+  /** The smallest scratch segment a thread keeps. */
+  private static final long MIN_SCRATCH_SIZE = 64 * 1024;
+
+  /** The most scratch memory a thread keeps, for the source and the destination together. */
+  static final long MAX_SCRATCH_SIZE = 4 * 1024 * 1024;
+
+  private static final ThreadLocal<Scratch> SCRATCH =
+      ThreadLocal.withInitial(() -> new Scratch(Arena.ofAuto(), true));
+
+  static {
+    MethodHandle compress = null;
+    MethodHandle decompress = null;
+    if (!"jni".equalsIgnoreCase(System.getProperty("qat.backend"))) {
+      try {
+        Native.loadLibrary();
+        SymbolLookup lookup = SymbolLookup.loaderLookup();
+        Linker linker = Linker.nativeLinker();
+        FunctionDescriptor descriptor =
+            FunctionDescriptor.of(
+                JAVA_INT, JAVA_LONG, ADDRESS, JAVA_INT, ADDRESS, JAVA_INT, JAVA_INT, ADDRESS);
+        compress = linker.downcallHandle(lookup.find("qat_java_compress").get(), descriptor);
+        decompress = linker.downcallHandle(lookup.find("qat_java_decompress").get(), descriptor);
+      } catch (RuntimeException | LinkageError e) {
+        compress = decompress = null;
+      }
+    }
+    COMPRESS = compress;
+    DECOMPRESS = decompress;
+  }
+
+  private QatForeign() {}
+
+  /**
+   * Returns true if byte array requests use the foreign function backend.
+   *
+   * @return true if the backend was selected and the native entry points were linked.
+   */
+  static boolean isEnabled() {
+    return ENABLED && isLinked();
+  }
+
+  /**
+   * Returns true if the native entry points were linked, so that segments can be compressed.
+   *
+   * @return true if the native entry points were linked.
+   */
+  static boolean isLinked() {
+    return COMPRESS != null;
+  }
+
+  /** Compresses a byte array; see InternalJNI.compressByteArray. */
+  static long compressByteArray(
+      long session,
+      byte[] src,
+      int srcOffset,
+      int srcLen,
+      byte[] dst,
+      int dstOffset,
+      int dstLen,
+      int retryCount) {
+    return compress(
+        session,
+        MemorySegment.ofArray(src).asSlice(srcOffset, srcLen),
+        MemorySegment.ofArray(dst).asSlice(dstOffset, dstLen),
+        retryCount);
+  }
+
+  /** Decompresses a byte array; see InternalJNI.decompressByteArray. */
+  static long decompressByteArray(
+      long session,
+      byte[] src,
+      int srcOffset,
+      int srcLen,
+      byte[] dst,
+      int dstOffset,
+      int dstLen,
+      int retryCount) {
+    return decompress(
+        session,
+        MemorySegment.ofArray(src).asSlice(srcOffset, srcLen),
+        MemorySegment.ofArray(dst).asSlice(dstOffset, dstLen),
+        retryCount);
+  }
+
+  /**
+   * Compresses the source segment into the destination segment on the given session.
+   *
+   * @return the bytes read and written, packed as by the native layer.
+   */
+  static long compress(long session, MemorySegment src, MemorySegment dst, int retryCount) {
+    return call(COMPRESS, "Error occurred while compressing data.", session, src, dst, retryCount);
+  }
+
+  /**
+   * Decompresses the source segment into the destination segment on the given session.
+   *
+   * @return the bytes read and written, packed as by the native layer.
+   */
+  static long decompress(long session, MemorySegment src, MemorySegment dst, int retryCount) {
+    return call(
+        DECOMPRESS, "Error occurred while decompressing data.", session, src, dst, retryCount);
+  }
+
+  /**
+   * Calls a native entry point, copying heap segments through the scratch segments of the current
+   * thread, or through memory allocated for the call.
+   */
+  private static long call(
+      MethodHandle handle,
+      String message,
+      long session,
+      MemorySegment src,
+      MemorySegment dst,
+      int retryCount) {
+    if (handle == null) throw new IllegalStateException("The foreign backend is not available.");
+    long copied = (src.isNative() ? 0 : src.byteSize()) + (dst.isNative() ? 0 : dst.byteSize());
+    if (copied <= MAX_SCRATCH_SIZE && !Thread.currentThread().isVirtual())
+      return call(handle, message, session, src, dst, retryCount, SCRATCH.get());
+    try (Arena arena = Arena.ofConfined()) {
+      return call(handle, message, session, src, dst, retryCount, new Scratch(arena, false));
+    }
+  }
+
+  private static long call(
+      MethodHandle handle,
+      String message,
+      long session,
+      MemorySegment src,
+      MemorySegment dst,
+      int retryCount,
+      Scratch scratch) {
+    MemorySegment in = src.isNative() ? src : scratch.source(src.byteSize()).copyFrom(src);
+    MemorySegment out = dst.isNative() ? dst : scratch.destination(dst.byteSize());
+
+    int status;
+    try {
+      status =
+          (int)
+              handle.invokeExact(
+                  session,
+                  in,
+                  (int) in.byteSize(),
+                  out,
+                  (int) out.byteSize(),
+                  retryCount,
+                  scratch.result);
+    } catch (RuntimeException | Error e) {
+      throw e;
+    } catch (Throwable t) {
+      throw new AssertionError(t);
+    }
+    if (status != 0) throw new QatException(message, status);
+
+    long result = scratch.result.get(JAVA_LONG, 0);
+    // The low half of the packed result is the number of bytes written.
+    if (out != dst) MemorySegment.copy(out, JAVA_BYTE, 0, dst, JAVA_BYTE, 0, (int) result);
+    return result;
+  }
+
+  /**
+   * The native memory heap data is copied through. The segments a thread keeps grow to its largest
+   * request within {@link #MAX_SCRATCH_SIZE} and are freed by the garbage collector once the thread
+   * ends; the segments of a single call are freed with its arena.
+   */
+  private static final class Scratch {
+    private final Arena arena;
+    private final boolean kept;
+    final MemorySegment result;
+    private MemorySegment source = MemorySegment.NULL;
+    private MemorySegment destination = MemorySegment.NULL;
+
+    Scratch(Arena arena, boolean kept) {
+      this.arena = arena;
+      this.kept = kept;
+      result = arena.allocate(JAVA_LONG);
+    }
+
+    MemorySegment source(long size) {
+      if (source.byteSize() < size) source = allocate(size);
+      return source.asSlice(0, size);
+    }
+
+    MemorySegment destination(long size) {
+      if (destination.byteSize() < size) destination = allocate(size);
+      return destination.asSlice(0, size);
+    }
+
+    private MemorySegment allocate(long size) {
+      return arena.allocate(kept ? Math.max(size, MIN_SCRATCH_SIZE) : size, 64);
+    }
+  }
+}
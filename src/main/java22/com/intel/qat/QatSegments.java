@@ -0,0 +1,79 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import java.lang.foreign.MemorySegment;
+
+/**
+ * Compresses and decompresses memory segments with a {@link QatZipper}, through the foreign
+ * function backend. Native segments, such as those allocated from an {@link
+ * java.lang.foreign.Arena}, are passed to QAT as they are; heap segments are copied to and from
+ * native memory, so no request pins the Java heap.
+ *
+ * <p>This class is available on JDK 22 and later. The calls update {@link
+ * QatZipper#getBytesRead()} and {@link QatZipper#getBytesWritten()}, and follow the retry count and
+ * the retry policy of the zipper.
+ */
+public final class QatSegments {
+  private QatSegments() {}
+
+  /**
+   * Returns true if the foreign function backend is available. It is not if the <code>qat.backend
+   * </code> system property is set to <code>jni</code>, or native access is denied to this module.
+   * Byte array requests use the backend only if the property is set to <code>foreign</code>.
+   *
+   * @return true if the foreign function backend is available.
+   */
+  public static boolean isAvailable() {
+    return QatForeign.isLinked();
+  }
+
+  /**
+   * Compresses the source segment into the destination segment. Returns the number of bytes of
+   * compressed data.
+   *
+   * @param qzip the zipper to compress with
+   * @param src the segment holding the source data
+   * @param dst the segment that will store the compressed data
+   * @return the size of the compressed data in bytes
+   * @throws IllegalStateException if the zipper is closed or the backend is not available
+   * @throws IllegalArgumentException if either segment is empty or larger than 2GB, or the
+   *     destination is read-only
+   */
+  public static int compress(QatZipper qzip, MemorySegment src, MemorySegment dst) {
+    check(src, dst);
+    return (int) qzip.run((s, retryCount) -> QatForeign.compress(s, src, dst, (int) retryCount));
+  }
+
+  /**
+   * Decompresses the source segment into the destination segment. Returns the number of bytes of
+   * decompressed data; {@link QatZipper#getBytesRead()} tells how much of the source was read.
+   *
+   * @param qzip the zipper to decompress with
+   * @param src the segment holding the compressed data
+   * @param dst the segment that will store the decompressed data
+   * @return the size of the decompressed data in bytes
+   * @throws IllegalStateException if the zipper is closed or the backend is not available
+   * @throws IllegalArgumentException if either segment is empty or larger than 2GB, or the
+   *     destination is read-only
+   */
+  public static int decompress(QatZipper qzip, MemorySegment src, MemorySegment dst) {
+    check(src, dst);
+    return (int)
+        qzip.run((s, retryCount) -> QatForeign.decompress(s, src, dst, (int) retryCount));
+  }
+
+  private static void check(MemorySegment src, MemorySegment dst) {
+    if (!QatForeign.isLinked())
+      throw new IllegalStateException("The foreign function backend is not available.");
+    if (src.byteSize() == 0 || dst.byteSize() == 0)
+      throw new IllegalArgumentException("Source or destination segment is empty.");
+    if (src.byteSize() > Integer.MAX_VALUE || dst.byteSize() > Integer.MAX_VALUE)
+      throw new IllegalArgumentException("Source or destination segment is larger than 2GB.");
+    if (dst.isReadOnly()) throw new IllegalArgumentException("Destination segment is read-only.");
+  }
+}
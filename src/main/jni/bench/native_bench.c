@@ -0,0 +1,222 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+/*
+ * A benchmark that drives the compress() and decompress() helpers of the JNI
+ * layer directly, without a JVM. Its latencies are those of the codec and the
+ * session logic alone, so the difference to a JMH run of the same payload is
+ * the JNI overhead: pinning, field access and the Java checks.
+ *
+ * The JNI translation unit is included rather than linked, so that its static
+ * helpers are reachable, and the exception helpers of util.c are replaced by
+ * ones that print the error; no JNI environment is ever dereferenced.
+ *
+ * Usage: qat-native-bench [-a deflate|lz4|zstd] [-l level] [-m hw|auto]
+ *        [-p busy|periodical|adaptive] [-s block_size] [-n iterations]
+ *        [-t sw_threshold] file
+ */
+#include "../com_intel_qat_InternalJNI.c"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/** The status of the most recent error, QZ_OK if there was none. */
+static int bench_status = QZ_OK;
+
+void throw_exception(JNIEnv *env, jlong err_code, const char *msg) {
+  (void)env;
+  bench_status = err_code != QZ_OK ? (int)err_code : QZ_FAIL;
+  fprintf(stderr, "%s (status %d)\n", msg, (int)err_code);
+}
+
+int init_exceptions(JNIEnv *env) {
+  (void)env;
+  return 0;
+}
+
+void release_exceptions(JNIEnv *env) { (void)env; }
+
+/** Returns the index of name in names, or -1. */
+static int lookup(const char *name, const char *const *names, int count) {
+  for (int i = 0; i < count; i++)
+    if (strcmp(name, names[i]) == 0) return i;
+  return -1;
+}
+
+/** Orders latencies for qsort. */
+static int compare_ns(const void *a, const void *b) {
+  long long x = *(const long long *)a;
+  long long y = *(const long long *)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * Prints the throughput and the latency percentiles of one operation. Sorts
+ * the latencies.
+ */
+static void report(const char *op, long long *ns, size_t count,
+                   unsigned long long bytes) {
+  long long total = 0;
+  for (size_t i = 0; i < count; i++) total += ns[i];
+  qsort(ns, count, sizeof(long long), compare_ns);
+  printf("%-10s %8zu calls %10.2f MB/sec  p50 %8.2f  p99 %8.2f  max %8.2f us\n",
+         op, count, total ? bytes * 1e9 / total / (1024 * 1024) : 0.0,
+         ns[count / 2] / 1e3, ns[count * 99 / 100] / 1e3, ns[count - 1] / 1e3);
+}
+
+static void *read_file(const char *path, size_t *size) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return NULL;
+  unsigned char *data = NULL;
+  if (fseek(f, 0, SEEK_END) == 0) {
+    long len = ftell(f);
+    if (len > 0 && fseek(f, 0, SEEK_SET) == 0 && (data = malloc(len)) &&
+        fread(data, 1, len, f) != (size_t)len) {
+      free(data);
+      data = NULL;
+    }
+    *size = len > 0 ? (size_t)len : 0;
+  }
+  fclose(f);
+  return data;
+}
+
+static void usage(void) {
+  fprintf(stderr,
+          "usage: qat-native-bench [-a deflate|lz4|zstd] [-l level] "
+          "[-m hw|auto]\n"
+          "       [-p busy|periodical|adaptive] [-s block_size] "
+          "[-n iterations]\n"
+          "       [-t sw_threshold] file\n");
+}
+
+int main(int argc, char **argv) {
+  static const char *const algorithms[] = {"deflate", "lz4", "zstd"};
+  static const char *const modes[] = {"hw", "auto"};
+  static const char *const pollings[] = {"busy", "periodical", "adaptive"};
+  int algorithm = DEFLATE_ALGORITHM;
+  int level = 6;
+  int mode = 1;
+  int polling = POLLING_BUSY;
+  long block_size = 64 * 1024;
+  long iterations = 100;
+  int sw_threshold = 1024;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "a:l:m:p:s:n:t:")) != -1) {
+    switch (opt) {
+      case 'a':
+        algorithm = lookup(optarg, algorithms, 3);
+        break;
+      case 'l':
+        level = atoi(optarg);
+        break;
+      case 'm':
+        mode = lookup(optarg, modes, 2);
+        break;
+      case 'p':
+        polling = lookup(optarg, pollings, 3);
+        break;
+      case 's':
+        block_size = atol(optarg);
+        break;
+      case 'n':
+        iterations = atol(optarg);
+        break;
+      case 't':
+        sw_threshold = atoi(optarg);
+        break;
+      default:
+        usage();
+        return 2;
+    }
+  }
+  if (optind != argc - 1 || algorithm < 0 || mode < 0 || polling < 0 ||
+      block_size < 0 || iterations < 1) {
+    usage();
+    return 2;
+  }
+
+  size_t size;
+  unsigned char *src = read_file(argv[optind], &size);
+  if (!src) {
+    fprintf(stderr, "Cannot read %s.\n", argv[optind]);
+    return 1;
+  }
+  if (block_size == 0 || (size_t)block_size > size) block_size = (long)size;
+  size_t blocks = (size + block_size - 1) / block_size;
+
+  jlong sess = Java_com_intel_qat_InternalJNI_setup(
+      NULL, NULL, algorithm, level, mode, polling, sw_threshold,
+      FORMAT_GZIP_EXT);
+  if (!sess) return 1;
+  QzSession_T *qz_session = (QzSession_T *)sess;
+
+  size_t max_block = Java_com_intel_qat_InternalJNI_maxCompressedSize(
+      NULL, NULL, sess, block_size);
+  unsigned char *compressed = malloc(blocks * max_block);
+  unsigned char *decompressed = malloc(size);
+  int *compressed_len = malloc(blocks * sizeof(int));
+  long long *ns = malloc(blocks * iterations * sizeof(long long));
+  if (!compressed || !decompressed || !compressed_len || !ns) {
+    fprintf(stderr, "Out of memory.\n");
+    return 1;
+  }
+
+  unsigned long long total_compressed = 0;
+  for (long it = 0; it < iterations && bench_status == QZ_OK; it++) {
+    total_compressed = 0;
+    for (size_t b = 0; b < blocks && bench_status == QZ_OK; b++) {
+      size_t off = b * block_size;
+      unsigned int len =
+          (unsigned int)(size - off < (size_t)block_size ? size - off
+                                                         : (size_t)block_size);
+      int bytes_read = 0;
+      long long start = stats_now();
+      compress(NULL, qz_session, src + off, len, compressed + b * max_block,
+               (unsigned int)max_block, &bytes_read, &compressed_len[b], 0);
+      ns[it * blocks + b] = stats_now() - start;
+      total_compressed += compressed_len[b];
+    }
+  }
+  if (bench_status == QZ_OK) {
+    printf("%s level %d, %zu blocks of %ld bytes, ratio %.2f\n",
+           algorithms[algorithm], level, blocks, block_size,
+           (double)size / total_compressed);
+    report("compress", ns, blocks * iterations,
+           (unsigned long long)size * iterations);
+  }
+
+  for (long it = 0; it < iterations && bench_status == QZ_OK; it++) {
+    for (size_t b = 0; b < blocks && bench_status == QZ_OK; b++) {
+      size_t off = b * block_size;
+      int bytes_read = 0;
+      int bytes_written = 0;
+      long long start = stats_now();
+      decompress(NULL, qz_session, compressed + b * max_block,
+                 (unsigned int)compressed_len[b], decompressed + off,
+                 (unsigned int)(size - off), &bytes_read, &bytes_written, 0);
+      ns[it * blocks + b] = stats_now() - start;
+    }
+  }
+  if (bench_status == QZ_OK) {
+    report("decompress", ns, blocks * iterations,
+           (unsigned long long)size * iterations);
+    if (memcmp(src, decompressed, size) != 0) {
+      fprintf(stderr, "Decompressed data does not match the input.\n");
+      bench_status = QZ_DATA_ERROR;
+    }
+  }
+
+  Java_com_intel_qat_InternalJNI_teardown(NULL, NULL, sess);
+  free(ns);
+  free(compressed_len);
+  free(decompressed);
+  free(compressed);
+  free(src);
+  return bench_status == QZ_OK ? 0 : 1;
+}
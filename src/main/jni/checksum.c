@@ -0,0 +1,65 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+#include "checksum.h"
+
+#include <zlib.h>
+
+// A gzip header with an extra field holding the QZ subfield: 'Q', 'Z', its
+// length, and the uncompressed and compressed sizes of the member.
+#define GZIP_EXT_HEADER_SIZE 24
+#define GZIP_EXT_COMPRESSED_SIZE_OFFSET 20
+#define GZIP_TRAILER_SIZE 8
+#define GZIP_FLAG_EXTRA 0x04
+
+static unsigned int get_le32(const unsigned char *p) {
+  return (unsigned int)p[0] | (unsigned int)p[1] << 8 |
+         (unsigned int)p[2] << 16 | (unsigned int)p[3] << 24;
+}
+
+unsigned long checksum_crc32(unsigned long crc, const unsigned char *buf,
+                             unsigned int len) {
+  return crc32(crc, buf, len);
+}
+
+unsigned long checksum_adler32(unsigned long adler, const unsigned char *buf,
+                               unsigned int len) {
+  return adler32(adler, buf, len);
+}
+
+unsigned long checksum_combine(unsigned long crc1, unsigned long crc2,
+                               long long len2) {
+  return crc32_combine(crc1, crc2, (z_off_t)len2);
+}
+
+int checksum_gzip_ext(const unsigned char *src, unsigned int len,
+                      unsigned long *crc) {
+  unsigned long result = crc32(0L, Z_NULL, 0);
+  unsigned int pos = 0;
+
+  while (pos < len) {
+    const unsigned char *member = src + pos;
+    unsigned int left = len - pos;
+    if (left < GZIP_EXT_HEADER_SIZE + GZIP_TRAILER_SIZE) return -1;
+    if (member[0] != 0x1f || member[1] != 0x8b ||
+        !(member[3] & GZIP_FLAG_EXTRA) || member[12] != 'Q' ||
+        member[13] != 'Z')
+      return -1;
+
+    unsigned int compressed =
+        get_le32(member + GZIP_EXT_COMPRESSED_SIZE_OFFSET);
+    if (compressed > left - GZIP_EXT_HEADER_SIZE - GZIP_TRAILER_SIZE)
+      return -1;
+
+    const unsigned char *trailer = member + GZIP_EXT_HEADER_SIZE + compressed;
+    result = crc32_combine(result, get_le32(trailer),
+                           (z_off_t)get_le32(trailer + 4));
+    pos += GZIP_EXT_HEADER_SIZE + compressed + GZIP_TRAILER_SIZE;
+  }
+
+  *crc = result;
+  return 0;
+}
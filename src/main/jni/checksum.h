@@ -0,0 +1,53 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+#ifndef CHECKSUM_H_
+#define CHECKSUM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Updates a CRC-32 (as computed by java.util.zip.CRC32) with the given bytes.
+ */
+unsigned long checksum_crc32(unsigned long crc, const unsigned char *buf,
+                             unsigned int len);
+
+/**
+ * Updates an Adler-32 (as computed by java.util.zip.Adler32) with the given
+ * bytes. The initial value is 1.
+ */
+unsigned long checksum_adler32(unsigned long adler, const unsigned char *buf,
+                               unsigned int len);
+
+/**
+ * Returns the CRC-32 of two consecutive blocks of data given the CRC-32 of
+ * each block and the length of the second one.
+ */
+unsigned long checksum_combine(unsigned long crc1, unsigned long crc2,
+                               long long len2);
+
+/**
+ * Combines the CRC-32 trailers of a sequence of gzip-ext members, the format
+ * of QZ_DEFLATE_GZIP_EXT sessions. The trailers are verified by QATzip during
+ * decompression, so their combination is the CRC-32 of the decompressed data
+ * and the data does not have to be read again.
+ *
+ * @param src the compressed members.
+ * @param len the length of the members.
+ * @param crc an out parameter that stores the CRC-32 of the uncompressed data.
+ * @return 0 if successful, or -1 if src is not a sequence of complete gzip-ext
+ * members.
+ */
+int checksum_gzip_ext(const unsigned char *src, unsigned int len,
+                      unsigned long *crc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,11 +4,24 @@
  * SPDX-License-Identifier: BSD
  ******************************************************************************/
 
+#define _GNU_SOURCE
+
 #include "com_intel_qat_InternalJNI.h"
 
+#include <pthread.h>
+#include <stdint.h>
 #include <stdlib.h>
-
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "checksum.h"
+#include "dictionary.h"
+#include "foreign.h"
+#include "inflater.h"
+#include "qat_zstd.h"
 #include "qatzip.h"
+#include "stats.h"
+#include "trace.h"
 #include "util.h"
 
 #ifndef CPA_DC_API_VERSION_AT_LEAST
@@ -25,35 +38,107 @@
 #endif
 
 #define DEFLATE_ALGORITHM 0
+#define ZSTD_ALGORITHM 2
+
+// The ordinals of QatZipper.Format, the formats of DEFLATE data.
+#define FORMAT_GZIP_EXT 0
+#define FORMAT_GZIP 1
+#define FORMAT_ZLIB 2
+#define FORMAT_RAW 3
+
+// The ordinals of QatZipper.PollingMode.
+#define POLLING_BUSY 0
+#define POLLING_PERIODICAL 1
+#define POLLING_ADAPTIVE 2
+
+// The defaults of adaptive polling: the time a request may be busy polled and
+// the initial estimate of the busy-polled time per KB of source (1 GB/s).
+#define DEFAULT_SPIN_BUDGET_NS 100000LL
+#define DEFAULT_BUSY_NS_PER_KB 1000LL
+
+// The smallest request whose time updates the estimate; below it the fixed
+// cost of a request dominates.
+#define POLLING_SAMPLE_MINIMUM 4096
+
+// A zlib stream wraps raw DEFLATE data in a 2 byte header and an Adler-32.
+#define ZLIB_HEADER_SIZE 2
+#define ZLIB_TRAILER_SIZE 4
+
+// The largest software threshold, the default QATzip hardware buffer size.
+#define SW_THRESHOLD_MAXIMUM (64 * 1024)
 
 /**
- * The fieldID for java.nio.ByteBuffer/position
+ * A QAT session, its counters, its preset dictionary, if any, and the checksum
+ * of the data of the most recent call if checksums are enabled. The QATzip
+ * session comes first, so a pointer to a qat_session is also a pointer to its
+ * QzSession_T. Zstandard and dictionary sessions use their own codec instead
+ * of QATzip and leave the QATzip session unset. Raw DEFLATE and zlib sessions
+ * decompress with their inflater. Adaptive polling sessions also hold a
+ * periodically polled QATzip session for requests expected to outlast the spin
+ * budget, and the busy-polled time per KB of source of each direction.
  */
-static jfieldID nio_bytebuffer_position_id;
+typedef struct {
+  QzSession_T qz_session;
+  qat_stats stats;
+  qat_dictionary *dict;
+  qat_zstd *zstd;
+  qat_inflater *inflater;
+  QzSession_T *periodical;
+  long long spin_budget_ns;
+  long long compress_ns_per_kb;
+  long long decompress_ns_per_kb;
+  int algorithm;
+  int level;
+  int format;
+  int checksum_enabled;
+  unsigned long checksum;
+} qat_session;
 
 /**
- * The fieldID for com.intel.qat.QatZipper/bytesRead
+ * The fieldIDs for java.nio.ByteBuffer/hb and java.nio.ByteBuffer/offset
  */
-static jfieldID qzip_bytes_read_id;
+static jfieldID nio_bytebuffer_hb_id;
+static jfieldID nio_bytebuffer_offset_id;
 
 /**
- * Sets up a QAT session for DEFLATE.
+ * Packs the number of bytes read and the number of bytes written into the
+ * value returned by the compress and decompress entry points, so that the Java
+ * layer can advance buffer positions without any field writes from here.
+ */
+static jlong pack_result(int bytes_read, int bytes_written) {
+  return (jlong)(((uint64_t)(uint32_t)bytes_read << 32) |
+                 (uint32_t)bytes_written);
+}
+
+/**
+ * Sets up a QAT session for DEFLATE. Zlib sessions produce raw DEFLATE data
+ * that session_compress() wraps.
  *
  * @param qz_session a pointer to the QzSession_T.
  * @param level the compression level to use.
+ * @param busy_polling non-zero for busy polling, zero for periodical polling.
+ * @param sw_threshold inputs smaller than this are compressed in software.
+ * @param format the FORMAT_* of the compressed data.
  */
 static int setup_deflate_session(QzSession_T *qz_session, int level,
-                                 unsigned char sw_backup, int polling_mode) {
+                                 unsigned char sw_backup, int busy_polling,
+                                 int sw_threshold, int format) {
   QzSessionParamsDeflate_T deflate_params;
 
   int status = qzGetDefaultsDeflate(&deflate_params);
   if (status != QZ_OK) return status;
 
-  deflate_params.data_fmt = QZ_DEFLATE_GZIP_EXT;
+  if (format == FORMAT_GZIP)
+    deflate_params.data_fmt = QZ_DEFLATE_GZIP;
+  else if (format == FORMAT_ZLIB || format == FORMAT_RAW)
+    deflate_params.data_fmt = QZ_DEFLATE_RAW;
+  else
+    deflate_params.data_fmt = QZ_DEFLATE_GZIP_EXT;
   deflate_params.common_params.comp_lvl = level;
   deflate_params.common_params.sw_backup = sw_backup;
+  deflate_params.common_params.input_sz_thrshold = sw_threshold;
   deflate_params.common_params.polling_mode =
-      polling_mode ? QZ_BUSY_POLLING : QZ_PERIODICAL_POLLING;
+      busy_polling ? QZ_BUSY_POLLING : QZ_PERIODICAL_POLLING;
 
   return qzSetupSessionDeflate(qz_session, &deflate_params);
 }
@@ -63,10 +148,13 @@ static int setup_deflate_session(QzSession_T *qz_session, int level,
  *
  * @param qz_session a pointer to the QzSession_T.
  * @param level the compression level to use.
+ * @param busy_polling non-zero for busy polling, zero for periodical polling.
+ * @param sw_threshold inputs smaller than this are compressed in software.
  * @return QZ_OK (0) if successful, non-zero otherwise.
  */
 static int setup_lz4_session(QzSession_T *qz_session, int level,
-                             unsigned char sw_backup, int polling_mode) {
+                             unsigned char sw_backup, int busy_polling,
+                             int sw_threshold) {
   QzSessionParamsLZ4_T lz4_params;
 
   int status = qzGetDefaultsLZ4(&lz4_params);
@@ -74,12 +162,242 @@ static int setup_lz4_session(QzSession_T *qz_session, int level,
 
   lz4_params.common_params.comp_lvl = level;
   lz4_params.common_params.sw_backup = sw_backup;
+  lz4_params.common_params.input_sz_thrshold = sw_threshold;
   lz4_params.common_params.polling_mode =
-      polling_mode ? QZ_BUSY_POLLING : QZ_PERIODICAL_POLLING;
+      busy_polling ? QZ_BUSY_POLLING : QZ_PERIODICAL_POLLING;
 
   return qzSetupSessionLZ4(qz_session, &lz4_params);
 }
 
+/**
+ * Sets up a QATzip session for the algorithm of the given session.
+ *
+ * @param session the session whose algorithm, level and format to use.
+ * @param qz_session the QzSession_T to set up.
+ * @param busy_polling non-zero for busy polling, zero for periodical polling.
+ * @param sw_threshold inputs smaller than this are compressed in software.
+ * @return QZ_OK (0) if successful, non-zero otherwise.
+ */
+static int setup_qatzip_session(qat_session *session, QzSession_T *qz_session,
+                                unsigned char sw_backup, int busy_polling,
+                                int sw_threshold) {
+  int status = qzInit(qz_session, sw_backup);
+  if (status != QZ_OK && status != QZ_DUPLICATE) return status;
+
+  if (session->algorithm == DEFLATE_ALGORITHM)
+    return setup_deflate_session(qz_session, session->level, sw_backup,
+                                 busy_polling, sw_threshold, session->format);
+  return setup_lz4_session(qz_session, session->level, sw_backup,
+                           busy_polling, sw_threshold);
+}
+
+/**
+ * Returns the QATzip session for a request with a source of the given size.
+ * Adaptive polling sessions busy poll requests expected to complete within
+ * the spin budget, judging by the time per KB of source of recent busy-polled
+ * requests in the same direction, and poll longer ones periodically, so that a
+ * waiting thread only spins for short jobs.
+ */
+static QzSession_T *polling_session(qat_session *session, unsigned int src_len,
+                                    long long ns_per_kb) {
+  if (!session->periodical) return &session->qz_session;
+  long long expected = (long long)src_len * ns_per_kb / 1024;
+  return expected <= session->spin_budget_ns ? &session->qz_session
+                                             : session->periodical;
+}
+
+/**
+ * Updates a busy-polled time per KB of source of an adaptive polling session
+ * with the time of a completed request. Compression and decompression keep
+ * separate estimates, since a KB of compressed input expands to several KB of
+ * output.
+ */
+static void polling_update(qat_session *session, QzSession_T *qz_session,
+                           unsigned int src_len, long long elapsed_ns,
+                           long long *estimate) {
+  if (qz_session != &session->qz_session || src_len < POLLING_SAMPLE_MINIMUM)
+    return;
+  long long ns_per_kb = elapsed_ns * 1024 / src_len;
+  *estimate += (ns_per_kb - *estimate) / 8;
+  if (*estimate < 1) *estimate = 1;
+}
+
+/**
+ * Returns non-zero if the session compresses on QAT: Zstandard sessions find
+ * matches on QAT if the device is available, dictionary sessions never use
+ * QAT, and QATzip sessions use it unless they failed over to software.
+ */
+static int session_hardware(qat_session *session) {
+  if (session->zstd) return qat_zstd_hardware(session->zstd);
+  return !session->dict && session->qz_session.hw_session_stat == QZ_OK;
+}
+
+/**
+ * Writes the zlib header for the given compression level (RFC 1950): DEFLATE
+ * with a 32K window, the level hint, and the check bits.
+ */
+static void zlib_header(unsigned char *dst, int level) {
+  unsigned int cmf = 0x78;
+  unsigned int flevel = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+  unsigned int flg = flevel << 6;
+  flg |= 31 - ((cmf << 8 | flg) % 31);
+  dst[0] = (unsigned char)cmf;
+  dst[1] = (unsigned char)flg;
+}
+
+/**
+ * Compresses into the session's DEFLATE format with QATzip. Zlib streams are
+ * raw DEFLATE data between a header and the Adler-32 of the source.
+ *
+ * @param session the session.
+ * @param sess the QATzip session to compress on.
+ * @param src the source buffer.
+ * @param src_len the size of the source; on return, the bytes read.
+ * @param dst the destination buffer.
+ * @param dst_len the size of the destination; on return, the bytes written.
+ * @return QZ_OK (0) if successful, non-zero otherwise.
+ */
+static int deflate_compress(qat_session *session, QzSession_T *sess,
+                            unsigned char *src, unsigned int *src_len,
+                            unsigned char *dst, unsigned int *dst_len) {
+  int zlib = session->format == FORMAT_ZLIB;
+  unsigned int header = zlib ? ZLIB_HEADER_SIZE : 0;
+  unsigned int framing = zlib ? ZLIB_HEADER_SIZE + ZLIB_TRAILER_SIZE : 0;
+  if (*dst_len < framing) return QZ_BUF_ERROR;
+
+  unsigned int out_len = *dst_len - framing;
+  int status;
+  if (session->checksum_enabled) {
+    unsigned long crc = 0;
+    status = qzCompressCrc(sess, src, src_len, dst + header, &out_len, 1, &crc);
+    session->checksum = crc;
+  } else {
+    status = qzCompress(sess, src, src_len, dst + header, &out_len, 1);
+  }
+  if (status != QZ_OK) return status;
+
+  if (zlib) {
+    zlib_header(dst, session->level);
+    unsigned long adler = checksum_adler32(1, src, *src_len);
+    unsigned char *trailer = dst + header + out_len;
+    trailer[0] = (unsigned char)(adler >> 24);
+    trailer[1] = (unsigned char)(adler >> 16);
+    trailer[2] = (unsigned char)(adler >> 8);
+    trailer[3] = (unsigned char)adler;
+  }
+  *dst_len = out_len + framing;
+  return QZ_OK;
+}
+
+/**
+ * Compresses with the session's Zstandard codec, its dictionary or QATzip. If
+ * checksums are enabled, also stores the CRC-32 of the consumed source in the
+ * session: QATzip computes it during DEFLATE compression, and it is computed
+ * in software otherwise.
+ *
+ * @param session the session.
+ * @param src the source buffer.
+ * @param src_len the size of the source; on return, the bytes read.
+ * @param dst the destination buffer.
+ * @param dst_len the size of the destination; on return, the bytes written.
+ * @return QZ_OK (0) if successful, non-zero otherwise.
+ */
+static int session_compress(qat_session *session, unsigned char *src,
+                            unsigned int *src_len, unsigned char *dst,
+                            unsigned int *dst_len) {
+  int status;
+  if (session->zstd) {
+    status = qat_zstd_compress(session->zstd, src, src_len, dst, dst_len);
+  } else if (session->dict) {
+    status = dict_compress(session->dict, src, src_len, dst, dst_len);
+  } else {
+    QzSession_T *qz_session =
+        polling_session(session, *src_len, session->compress_ns_per_kb);
+    long long start = session->periodical ? stats_now() : 0;
+    if (session->algorithm == DEFLATE_ALGORITHM) {
+      status =
+          deflate_compress(session, qz_session, src, src_len, dst, dst_len);
+      if (start && status == QZ_OK)
+        polling_update(session, qz_session, *src_len, stats_now() - start,
+                       &session->compress_ns_per_kb);
+      return status;
+    }
+    status = qzCompress(qz_session, src, src_len, dst, dst_len, 1);
+    if (start && status == QZ_OK)
+      polling_update(session, qz_session, *src_len, stats_now() - start,
+                     &session->compress_ns_per_kb);
+  }
+  if (session->checksum_enabled && status == QZ_OK)
+    session->checksum = checksum_crc32(0, src, *src_len);
+  return status;
+}
+
+/**
+ * Stores the CRC-32 of decompressed data in the session. For gzip-ext members
+ * it is combined from their verified trailers; otherwise it is computed over
+ * the decompressed bytes.
+ *
+ * @param session the session.
+ * @param src the consumed compressed data.
+ * @param src_len the number of bytes consumed.
+ * @param dst the decompressed data.
+ * @param dst_len the number of bytes decompressed.
+ */
+static void decompressed_checksum(qat_session *session,
+                                  const unsigned char *src,
+                                  unsigned int src_len,
+                                  const unsigned char *dst,
+                                  unsigned int dst_len) {
+  if (!session->dict && session->algorithm == DEFLATE_ALGORITHM &&
+      session->format == FORMAT_GZIP_EXT &&
+      checksum_gzip_ext(src, src_len, &session->checksum) == 0)
+    return;
+  session->checksum = checksum_crc32(0, dst, dst_len);
+}
+
+/**
+ * Compresses like compress(), but returns the status without throwing, so that
+ * it can be called without a JNI environment.
+ */
+static int compress_status(QzSession_T *sess, unsigned char *src_ptr,
+                           unsigned int src_len, unsigned char *dst_ptr,
+                           unsigned int dst_len, int *bytes_read,
+                           int *bytes_written, int retry_count) {
+  // Save src_len and dst_len
+  int src_len_l = src_len;
+  int dst_len_l = dst_len;
+  int retries = 0;
+  int record = atomic_load_explicit(&stats_enabled, memory_order_relaxed);
+  long long start = record ? stats_now() : 0;
+  TRACE_SUBMIT(sess, TRACE_COMPRESS, src_len);
+  int status = session_compress((qat_session *)sess, src_ptr, &src_len,
+                                dst_ptr, &dst_len);
+
+  if (status == QZ_NOSW_NO_INST_ATTACH && retry_count > 0) {
+    while (retry_count > 0 && QZ_OK != status) {
+      src_len = src_len_l;
+      dst_len = dst_len_l;
+      status = session_compress((qat_session *)sess, src_ptr, &src_len,
+                                dst_ptr, &dst_len);
+      retry_count--;
+      retries++;
+    }
+  }
+  TRACE_COMPLETE(sess, TRACE_COMPRESS, status);
+
+  if (record)
+    stats_record(&((qat_session *)sess)->stats, 0, status, src_len, dst_len,
+                 retries, session_hardware((qat_session *)sess),
+                 stats_now() - start);
+
+  if (status != QZ_OK) return status;
+
+  *bytes_read = src_len;
+  *bytes_written = dst_len;
+
+  return QZ_OK;
+}
+
 /**
  * Compresses a buffer pointed to by the given source pointer and writes it to
  * the destination buffer pointed to by the destination pointer. The read and
@@ -103,24 +421,76 @@ static int compress(JNIEnv *env, QzSession_T *sess, unsigned char *src_ptr,
                     unsigned int src_len, unsigned char *dst_ptr,
                     unsigned int dst_len, int *bytes_read, int *bytes_written,
                     int retry_count) {
+  int status = compress_status(sess, src_ptr, src_len, dst_ptr, dst_len,
+                               bytes_read, bytes_written, retry_count);
+  if (status != QZ_OK)
+    throw_exception(env, status, "Error occurred while compressing data.");
+  return status;
+}
+
+/**
+ * Decompresses like decompress(), but returns the status without throwing, so
+ * that it can be called without a JNI environment.
+ */
+static int decompress_status(QzSession_T *sess, unsigned char *src_ptr,
+                             unsigned int src_len, unsigned char *dst_ptr,
+                             unsigned int dst_len, int *bytes_read,
+                             int *bytes_written, int retry_count) {
   // Save src_len and dst_len
   int src_len_l = src_len;
   int dst_len_l = dst_len;
-  int status = qzCompress(sess, src_ptr, &src_len, dst_ptr, &dst_len, 1);
+  int retries = 0;
+  int record = atomic_load_explicit(&stats_enabled, memory_order_relaxed);
+  long long start = record ? stats_now() : 0;
+  qat_dictionary *dict = ((qat_session *)sess)->dict;
+  qat_zstd *zstd = ((qat_session *)sess)->zstd;
+  qat_inflater *inflater = ((qat_session *)sess)->inflater;
+  qat_session *session = (qat_session *)sess;
+  QzSession_T *qz_session =
+      polling_session(session, src_len, session->decompress_ns_per_kb);
+  long long polled = session->periodical ? stats_now() : 0;
+  int status;
+  TRACE_SUBMIT(sess, TRACE_DECOMPRESS, src_len);
+  if (zstd)
+    status = qat_zstd_decompress(zstd, src_ptr, &src_len, dst_ptr, &dst_len);
+  else if (inflater)
+    status =
+        inflater_decompress(inflater, src_ptr, &src_len, dst_ptr, &dst_len);
+  else if (dict)
+    status = dict_decompress(dict, src_ptr, &src_len, dst_ptr, &dst_len);
+  else
+    status = qzDecompress(qz_session, src_ptr, &src_len, dst_ptr, &dst_len);
 
   if (status == QZ_NOSW_NO_INST_ATTACH && retry_count > 0) {
-    while (retry_count > 0 && QZ_OK != status) {
+    while (retry_count > 0 && QZ_OK != status && status != QZ_BUF_ERROR &&
+           status != QZ_DATA_ERROR) {
       src_len = src_len_l;
       dst_len = dst_len_l;
-      status = qzCompress(sess, src_ptr, &src_len, dst_ptr, &dst_len, 1);
+      status = qzDecompress(qz_session, src_ptr, &src_len, dst_ptr, &dst_len);
       retry_count--;
+      retries++;
     }
   }
-
-  if (status != QZ_OK) {
-    throw_exception(env, status, "Error occurred while compressing data.");
+  if (polled && status == QZ_OK && !zstd && !inflater && !dict)
+    polling_update(session, qz_session, src_len, stats_now() - polled,
+                   &session->decompress_ns_per_kb);
+  TRACE_COMPLETE(sess, TRACE_DECOMPRESS, status);
+
+  // A buffer or data error only means the input ended mid-block.
+  if (record)
+    stats_record(&((qat_session *)sess)->stats, 1,
+                 status == QZ_BUF_ERROR || status == QZ_DATA_ERROR ? QZ_OK
+                                                                   : status,
+                 src_len, dst_len, retries,
+                 !inflater && session_hardware((qat_session *)sess),
+                 stats_now() - start);
+
+  if (status != QZ_OK && status != QZ_BUF_ERROR && status != QZ_DATA_ERROR)
     return status;
-  }
+
+  if (((qat_session *)sess)->checksum_enabled)
+    decompressed_checksum((qat_session *)sess, src_ptr, src_len, dst_ptr,
+                          dst_len);
 
   *bytes_read = src_len;
   *bytes_written = dst_len;
@@ -151,89 +521,414 @@ static int decompress(JNIEnv *env, QzSession_T *sess, unsigned char *src_ptr,
                       unsigned int src_len, unsigned char *dst_ptr,
                       unsigned int dst_len, int *bytes_read, int *bytes_written,
                       int retry_count) {
-  // Save src_len and dst_len
-  int src_len_l = src_len;
-  int dst_len_l = dst_len;
-  int status = qzDecompress(sess, src_ptr, &src_len, dst_ptr, &dst_len);
+  int status = decompress_status(sess, src_ptr, src_len, dst_ptr, dst_len,
+                                 bytes_read, bytes_written, retry_count);
+  if (status != QZ_OK)
+    throw_exception(env, status, "Error occurred while decompressing data.");
+  return status;
+}
 
-  if (status == QZ_NOSW_NO_INST_ATTACH && retry_count > 0) {
-    while (retry_count > 0 && QZ_OK != status && status != QZ_BUF_ERROR &&
-           status != QZ_DATA_ERROR) {
-      src_len = src_len_l;
-      dst_len = dst_len_l;
-      status = qzDecompress(sess, src_ptr, &src_len, dst_ptr, &dst_len);
-      retry_count--;
-    }
+/**
+ * The signature shared by compress_status() and decompress_status().
+ */
+typedef int (*codec_fn)(QzSession_T *, unsigned char *, unsigned int,
+                        unsigned char *, unsigned int, int *, int *, int);
+
+/**
+ * An element of a batch, which is either a direct ByteBuffer or a byte array.
+ */
+typedef struct {
+  jobject obj;
+  unsigned char *ptr;
+  int is_array;
+} batch_element;
+
+/**
+ * Resolves the address of a direct ByteBuffer element. A byte array element
+ * is left to pin_batch_element; since no other JNI call may be made while an
+ * array is pinned, every element of a call must be resolved before the first
+ * one is pinned.
+ *
+ * @param env a pointer to the JNI environment.
+ * @param obj a direct ByteBuffer or a byte array.
+ * @param e the element to initialize.
+ */
+static void resolve_batch_element(JNIEnv *env, jobject obj, batch_element *e) {
+  e->obj = obj;
+  e->ptr = (unsigned char *)(*env)->GetDirectBufferAddress(env, obj);
+  e->is_array = e->ptr == NULL;
+}
+
+/**
+ * Pins a byte array element resolved by resolve_batch_element.
+ *
+ * @return non-zero if the element's memory is accessible.
+ */
+static int pin_batch_element(JNIEnv *env, batch_element *e) {
+  if (e->is_array)
+    e->ptr = (unsigned char *)(*env)->GetPrimitiveArrayCritical(
+        env, (jarray)e->obj, NULL);
+  return e->ptr != NULL;
+}
+
+/**
+ * Unpins an element pinned by pin_batch_element, if it was pinned. Its local
+ * reference is deleted separately, once no array of the call is pinned.
+ */
+static void unpin_batch_element(JNIEnv *env, batch_element *e) {
+  if (e->is_array && e->ptr)
+    (*env)->ReleasePrimitiveArrayCritical(env, (jarray)e->obj, (jbyte *)e->ptr,
+                                          0);
+}
+
+/**
+ * Compresses or decompresses a batch of buffers with a single JNI transition.
+ * Processing stops at the first buffer that fails, leaving a pending
+ * QatException.
+ *
+ * @param env a pointer to the JNI environment.
+ * @param sess a pointer to the QzSession_T object.
+ * @param srcs the source buffers, each a direct ByteBuffer or a byte array.
+ * @param dsts the destination buffers, each a direct ByteBuffer or a byte
+ * array.
+ * @param params the source offset, source length, destination offset and
+ * destination length of each buffer pair, in that order.
+ * @param results an out array that receives the bytes read and the bytes
+ * written for each buffer pair, in that order.
+ * @param retry_count the number of retries before we give up.
+ * @param codec either compress_status or decompress_status.
+ * @param error the message of the exception thrown if a buffer fails.
+ * @return the number of buffer pairs processed successfully.
+ */
+static jint process_batch(JNIEnv *env, QzSession_T *sess, jobjectArray srcs,
+                          jobjectArray dsts, jintArray params,
+                          jintArray results, jint retry_count, codec_fn codec,
+                          const char *error) {
+  jsize count = (*env)->GetArrayLength(env, srcs);
+  jint *p = (*env)->GetIntArrayElements(env, params, NULL);
+  if (!p) return 0;
+  jint *r = (*env)->GetIntArrayElements(env, results, NULL);
+  if (!r) {
+    (*env)->ReleaseIntArrayElements(env, params, p, JNI_ABORT);
+    return 0;
   }
 
-  if (status != QZ_OK && status != QZ_BUF_ERROR && status != QZ_DATA_ERROR) {
-    throw_exception(env, status, "Error occurred while decompressing data.");
-    return status;
+  jint done = 0;
+  for (; done < count; done++) {
+    jint *e = p + 4 * done;
+    batch_element src, dst;
+    resolve_batch_element(env, (*env)->GetObjectArrayElement(env, srcs, done),
+                          &src);
+    resolve_batch_element(env, (*env)->GetObjectArrayElement(env, dsts, done),
+                          &dst);
+
+    int bytes_read = 0;
+    int bytes_written = 0;
+    int status = QZ_LOW_MEM;
+    if (pin_batch_element(env, &src) && pin_batch_element(env, &dst))
+      status = codec(sess, src.ptr + e[0], e[1], dst.ptr + e[2], e[3],
+                     &bytes_read, &bytes_written, retry_count);
+
+    unpin_batch_element(env, &dst);
+    unpin_batch_element(env, &src);
+    (*env)->DeleteLocalRef(env, dst.obj);
+    (*env)->DeleteLocalRef(env, src.obj);
+
+    if (status != QZ_OK) {
+      // A failed pin leaves an OutOfMemoryError pending.
+      if (!(*env)->ExceptionCheck(env)) throw_exception(env, status, error);
+      break;
+    }
+
+    r[2 * done] = bytes_read;
+    r[2 * done + 1] = bytes_written;
   }
 
-  *bytes_read = src_len;
-  *bytes_written = dst_len;
+  (*env)->ReleaseIntArrayElements(env, results, r, 0);
+  (*env)->ReleaseIntArrayElements(env, params, p, JNI_ABORT);
 
-  return QZ_OK;
+  return done;
 }
 
 /*
+ * Returns the backing array of a heap byte buffer. A NULL array means the
+ * buffer is a read-only heap buffer, whose array is not accessible from Java;
+ * its hb and offset fields are then read directly, and pos is adjusted by the
+ * array offset of the buffer.
+ */
+static jbyteArray heap_buffer_array(JNIEnv *env, jobject buf, jbyteArray arr,
+                                    jint *pos) {
+  if (arr) return arr;
+  *pos += (*env)->GetIntField(env, buf, nio_bytebuffer_offset_id);
+  return (jbyteArray)(*env)->GetObjectField(env, buf, nio_bytebuffer_hb_id);
+}
+
+/*
+ * Caches the classes and field IDs used by the entry points, so that no call
+ * has to look them up.
+ */
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *reserved) {
+  (void)reserved;
+
+  JNIEnv *env;
+  if ((*vm)->GetEnv(vm, (void **)&env, JNI_VERSION_1_8) != JNI_OK)
+    return JNI_ERR;
+
+  jclass byte_buffer_class = (*env)->FindClass(env, "java/nio/ByteBuffer");
+  if (!byte_buffer_class) return JNI_ERR;
+  nio_bytebuffer_hb_id = (*env)->GetFieldID(env, byte_buffer_class, "hb", "[B");
+  nio_bytebuffer_offset_id =
+      (*env)->GetFieldID(env, byte_buffer_class, "offset", "I");
+  (*env)->DeleteLocalRef(env, byte_buffer_class);
+  if (!nio_bytebuffer_hb_id || !nio_bytebuffer_offset_id) return JNI_ERR;
+
+  if (init_exceptions(env) != 0) return JNI_ERR;
+
+  return JNI_VERSION_1_8;
+}
+
+/*
+ * Releases the classes cached by JNI_OnLoad.
+ */
+JNIEXPORT void JNICALL JNI_OnUnload(JavaVM *vm, void *reserved) {
+  (void)reserved;
+
+  JNIEnv *env;
+  qat_zstd_shutdown();
+  if ((*vm)->GetEnv(vm, (void **)&env, JNI_VERSION_1_8) != JNI_OK) return;
+  release_exceptions(env);
+}
+
+/*
+ * Returns the NUMA node of the CPU the calling thread runs on, or -1 if it
+ * cannot be determined.
+ *
  * Class:     com_intel_qat_InternalJNI
- * Method:    initFieldIDs
- * Signature: ()V
+ * Method:    currentNumaNode
+ * Signature: ()I
  */
-JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_initFieldIDs(JNIEnv *env,
-                                                                   jclass clz) {
+JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_currentNumaNode(
+    JNIEnv *env, jclass clz) {
+  (void)env;
   (void)clz;
 
-  nio_bytebuffer_position_id = (*env)->GetFieldID(
-      env, (*env)->FindClass(env, "java/nio/ByteBuffer"), "position", "I");
+  unsigned int cpu, node;
+  if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0) return -1;
+  return (jint)node;
+}
+
+/*
+ * Returns true if the library was built with Zstandard support.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    isZstdAvailable
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_intel_qat_InternalJNI_isZstdAvailable(JNIEnv *env, jclass clz) {
+  (void)env;
+  (void)clz;
 
-  qzip_bytes_read_id = (*env)->GetFieldID(
-      env, (*env)->FindClass(env, "com/intel/qat/QatZipper"), "bytesRead", "I");
+  return qat_zstd_available() ? JNI_TRUE : JNI_FALSE;
 }
 
 /*
- * Sets up a QAT session.
+ * Sets up a QAT session. With software backup, QATzip compresses inputs
+ * smaller than sw_threshold in software, in the same format. The format
+ * applies to DEFLATE sessions only. Adaptive polling sets up a busy-polled and
+ * a periodically polled QATzip session.
  *
  * Class:     com_intel_qat_InternalJNI
  * Method:    setup
- * Signature: (Lcom/intel/qat/QatZipper;IIII)V
+ * Signature: (IIIIII)J
  */
-JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_setup(
-    JNIEnv *env, jclass clz, jobject qat_zipper, jint comp_algorithm,
-    jint level, jint sw_backup, jint polling_mode) {
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_setup(
+    JNIEnv *env, jclass clz, jint comp_algorithm, jint level, jint sw_backup,
+    jint polling_mode, jint sw_threshold, jint format) {
   (void)clz;
   // Check if compression level is valid
   if (level < 1 || level > COMP_LVL_MAXIMUM) {
     throw_exception(env, QZ_PARAMS, "Invalid compression level given.");
-    return;
+    return 0;
   }
 
-  QzSession_T *qz_session = (QzSession_T *)calloc(1, sizeof(QzSession_T));
-
-  int status = qzInit(qz_session, (unsigned char)sw_backup);
-  if (status != QZ_OK && status != QZ_DUPLICATE) {
-    throw_exception(env, status, "Initializing QAT HW failed.");
-    return;
+  if (sw_threshold < QZ_COMP_THRESHOLD_MINIMUM ||
+      sw_threshold > SW_THRESHOLD_MAXIMUM) {
+    throw_exception(env, QZ_PARAMS, "Invalid software threshold given.");
+    return 0;
   }
 
-  if (comp_algorithm == DEFLATE_ALGORITHM)
-    status = setup_deflate_session(qz_session, level, (unsigned char)sw_backup,
-                                   polling_mode);
-  else
-    status = setup_lz4_session(qz_session, level, (unsigned char)sw_backup,
-                               polling_mode);
+  QzSession_T *qz_session = (QzSession_T *)calloc(1, sizeof(qat_session));
+  int status = QZ_LOW_MEM;
+  const char *error = "Allocating a QAT session failed.";
+  if (qz_session && comp_algorithm == ZSTD_ALGORITHM) {
+    ((qat_session *)qz_session)->algorithm = comp_algorithm;
+    status = qat_zstd_create(level, sw_backup,
+                             &((qat_session *)qz_session)->zstd);
+    error = "Error occurred while setting up a Zstandard session.";
+  } else if (qz_session) {
+    qat_session *session = (qat_session *)qz_session;
+    session->algorithm = comp_algorithm;
+    session->level = level;
+    session->format = comp_algorithm == DEFLATE_ALGORITHM ? format : 0;
+    session->spin_budget_ns = DEFAULT_SPIN_BUDGET_NS;
+    session->compress_ns_per_kb = DEFAULT_BUSY_NS_PER_KB;
+    session->decompress_ns_per_kb = DEFAULT_BUSY_NS_PER_KB;
+    status = setup_qatzip_session(session, qz_session, (unsigned char)sw_backup,
+                                  polling_mode != POLLING_PERIODICAL,
+                                  sw_threshold);
+    if (status == QZ_OK && polling_mode == POLLING_ADAPTIVE) {
+      session->periodical = (QzSession_T *)calloc(1, sizeof(QzSession_T));
+      status = session->periodical
+                   ? setup_qatzip_session(session, session->periodical,
+                                          (unsigned char)sw_backup, 0,
+                                          sw_threshold)
+                   : QZ_LOW_MEM;
+      if (status != QZ_OK) {
+        free(session->periodical);
+        session->periodical = NULL;
+        qzTeardownSession(qz_session);
+      }
+    }
+    if (status == QZ_OK &&
+        (session->format == FORMAT_ZLIB || session->format == FORMAT_RAW)) {
+      session->inflater = inflater_create(session->format == FORMAT_RAW);
+      if (!session->inflater) {
+        if (session->periodical) qzTeardownSession(session->periodical);
+        free(session->periodical);
+        qzTeardownSession(qz_session);
+        status = QZ_LOW_MEM;
+      }
+    }
+    if (status != QZ_OK) {
+      qzClose(qz_session);
+      error = status == QZ_LOW_MEM
+                  ? "Allocating a QAT session failed."
+                  : "Error occurred while setting up a session.";
+    }
+  }
 
   if (status != QZ_OK) {
-    qzClose(qz_session);
-    throw_exception(env, status, "Error occurred while setting up a session.");
-    return;
+    free(qz_session);
+    throw_exception(env, status, error);
+    return 0;
   }
 
-  jclass qz_clz = (*env)->FindClass(env, "com/intel/qat/QatZipper");
-  jfieldID qz_session_field = (*env)->GetFieldID(env, qz_clz, "session", "J");
-  (*env)->SetLongField(env, qat_zipper, qz_session_field, (jlong)qz_session);
+  return (jlong)qz_session;
+}
+
+/*
+ * Sets up a session that compresses and decompresses in software with a preset
+ * dictionary. QAT has no support for preset dictionaries, so no QATzip session
+ * is set up; the QATzip session of the returned session stays unset.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    setupDictionary
+ * Signature: (II[B)J
+ */
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_setupDictionary(
+    JNIEnv *env, jclass clz, jint comp_algorithm, jint level,
+    jbyteArray data) {
+  (void)clz;
+  if (level < 1 || level > COMP_LVL_MAXIMUM) {
+    throw_exception(env, QZ_PARAMS, "Invalid compression level given.");
+    return 0;
+  }
+
+  qat_session *session = (qat_session *)calloc(1, sizeof(qat_session));
+  if (!session) {
+    throw_exception(env, QZ_LOW_MEM, "Allocating a QAT session failed.");
+    return 0;
+  }
+
+  jsize length = (*env)->GetArrayLength(env, data);
+  jbyte *bytes = (*env)->GetByteArrayElements(env, data, NULL);
+  if (!bytes) {
+    free(session);
+    return 0;
+  }
+  session->dict =
+      dict_create(comp_algorithm == DEFLATE_ALGORITHM ? DICT_DEFLATE : DICT_LZ4,
+                  level, (const unsigned char *)bytes, (unsigned int)length);
+  (*env)->ReleaseByteArrayElements(env, data, bytes, JNI_ABORT);
+  if (!session->dict) {
+    free(session);
+    throw_exception(env, QZ_LOW_MEM, "Allocating a dictionary failed.");
+    return 0;
+  }
+
+  session->algorithm = comp_algorithm;
+  session->level = level;
+  session->spin_budget_ns = DEFAULT_SPIN_BUDGET_NS;
+  session->compress_ns_per_kb = DEFAULT_BUSY_NS_PER_KB;
+  session->decompress_ns_per_kb = DEFAULT_BUSY_NS_PER_KB;
+  return (jlong)session;
+}
+
+/*
+ * Enables or disables the checksum of the data of each compress and
+ * decompress call.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    setChecksumEnabled
+ * Signature: (JZ)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_setChecksumEnabled(
+    JNIEnv *env, jclass clz, jlong sess, jboolean enabled) {
+  (void)env;
+  (void)clz;
+
+  qat_session *session = (qat_session *)sess;
+  session->checksum_enabled = enabled == JNI_TRUE;
+  session->checksum = 0;
+}
+
+/*
+ * Sets the time for which adaptive polling sessions busy poll a request.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    setSpinBudget
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_setSpinBudget(
+    JNIEnv *env, jclass clz, jlong sess, jlong spin_budget_ns) {
+  (void)env;
+  (void)clz;
+
+  ((qat_session *)sess)->spin_budget_ns = spin_budget_ns;
+}
+
+/*
+ * Returns the CRC-32 of the uncompressed data of the most recent compress or
+ * decompress call.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    checksum
+ * Signature: (J)J
+ */
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_checksum(JNIEnv *env,
+                                                               jclass clz,
+                                                               jlong sess) {
+  (void)env;
+  (void)clz;
+
+  return (jlong)((qat_session *)sess)->checksum;
+}
+
+/*
+ * Returns the CRC-32 of two consecutive blocks of data.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    crc32Combine
+ * Signature: (JJJ)J
+ */
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_crc32Combine(
+    JNIEnv *env, jclass clz, jlong crc1, jlong crc2, jlong len2) {
+  (void)env;
+  (void)clz;
+
+  return (jlong)checksum_combine((unsigned long)crc1, (unsigned long)crc2,
+                                 (long long)len2);
 }
 
 /*
@@ -241,15 +936,16 @@ JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_setup(
  *
  * Class:     com_intel_qat_InternalJNI
  * Method:    compressByteArray
- * Signature: (Lcom/intel/qat/QatZipper;J[BII[BIII)I
+ * Signature: (J[BII[BIII)J
  */
-JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_compressByteArray(
-    JNIEnv *env, jclass clz, jobject qat_zipper, jlong sess, jbyteArray src_arr,
-    jint src_pos, jint src_len, jbyteArray dst_arr, jint dst_pos, jint dst_len,
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_compressByteArray(
+    JNIEnv *env, jclass clz, jlong sess, jbyteArray src_arr, jint src_pos,
+    jint src_len, jbyteArray dst_arr, jint dst_pos, jint dst_len,
     jint retry_count) {
   (void)clz;
 
   QzSession_T *qz_session = (QzSession_T *)sess;
+  TRACE_PIN(qz_session, TRACE_COMPRESS);
 
   unsigned char *src_ptr =
       (unsigned char *)(*env)->GetPrimitiveArrayCritical(env, src_arr, NULL);
@@ -265,10 +961,8 @@ JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_compressByteArray(
   (*env)->ReleasePrimitiveArrayCritical(env, dst_arr, (jbyte *)dst_ptr, 0);
   (*env)->ReleasePrimitiveArrayCritical(env, src_arr, (jbyte *)src_ptr, 0);
 
-  // Update qatZipper.bytesRead
-  (*env)->SetIntField(env, qat_zipper, qzip_bytes_read_id, (jint)bytes_read);
-
-  return bytes_written;
+  TRACE_UNPIN(qz_session, TRACE_COMPRESS);
+  return pack_result(bytes_read, bytes_written);
 }
 
 /*
@@ -276,15 +970,16 @@ JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_compressByteArray(
  *
  * Class:     com_intel_qat_InternalJNI
  * Method:    decompressByteArray
- * Signature: (Lcom/intel/qat/QatZipper;J[BII[BIII)I
+ * Signature: (J[BII[BIII)J
  */
-JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_decompressByteArray(
-    JNIEnv *env, jclass clz, jobject qat_zipper, jlong sess, jbyteArray src_arr,
-    jint src_pos, jint src_len, jbyteArray dst_arr, jint dst_pos, jint dst_len,
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_decompressByteArray(
+    JNIEnv *env, jclass clz, jlong sess, jbyteArray src_arr, jint src_pos,
+    jint src_len, jbyteArray dst_arr, jint dst_pos, jint dst_len,
     jint retry_count) {
   (void)clz;
 
   QzSession_T *qz_session = (QzSession_T *)sess;
+  TRACE_PIN(qz_session, TRACE_DECOMPRESS);
   unsigned char *src_ptr =
       (unsigned char *)(*env)->GetPrimitiveArrayCritical(env, src_arr, NULL);
   unsigned char *dst_ptr =
@@ -299,10 +994,8 @@ JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_decompressByteArray(
   (*env)->ReleasePrimitiveArrayCritical(env, dst_arr, (jbyte *)dst_ptr, 0);
   (*env)->ReleasePrimitiveArrayCritical(env, src_arr, (jbyte *)src_ptr, 0);
 
-  // Update qat_zipper.bytesRead
-  (*env)->SetIntField(env, qat_zipper, qzip_bytes_read_id, (jint)bytes_read);
-
-  return bytes_written;
+  TRACE_UNPIN(qz_session, TRACE_DECOMPRESS);
+  return pack_result(bytes_read, bytes_written);
 }
 
 /*
@@ -310,15 +1003,19 @@ JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_decompressByteArray(
  *
  * Class:     com_intel_qat_InternalJNI
  * Method:    compressByteBuffer
- * Signature: (JLjava/nio/ByteBuffer;[BII[BIII)I
+ * Signature: (JLjava/nio/ByteBuffer;[BII[BIII)J
  */
-JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_compressByteBuffer(
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_compressByteBuffer(
     JNIEnv *env, jclass clz, jlong sess, jobject src_buf, jbyteArray src_arr,
     jint src_pos, jint src_len, jbyteArray dst_arr, jint dst_pos, jint dst_len,
     jint retry_count) {
   (void)clz;
 
   QzSession_T *qz_session = (QzSession_T *)sess;
+  TRACE_PIN(qz_session, TRACE_COMPRESS);
+
+  jint src_idx = src_pos;
+  src_arr = heap_buffer_array(env, src_buf, src_arr, &src_idx);
 
   unsigned char *src_ptr =
       (unsigned char *)(*env)->GetPrimitiveArrayCritical(env, src_arr, NULL);
@@ -328,16 +1025,14 @@ JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_compressByteBuffer(
   int bytes_read = 0;
   int bytes_written = 0;
 
-  compress(env, qz_session, src_ptr + src_pos, src_len, dst_ptr + dst_pos,
+  compress(env, qz_session, src_ptr + src_idx, src_len, dst_ptr + dst_pos,
            dst_len, &bytes_read, &bytes_written, retry_count);
 
   (*env)->ReleasePrimitiveArrayCritical(env, dst_arr, (jbyte *)dst_ptr, 0);
   (*env)->ReleasePrimitiveArrayCritical(env, src_arr, (jbyte *)src_ptr, 0);
 
-  (*env)->SetIntField(env, src_buf, nio_bytebuffer_position_id,
-                      src_pos + bytes_read);
-
-  return bytes_written;
+  TRACE_UNPIN(qz_session, TRACE_COMPRESS);
+  return pack_result(bytes_read, bytes_written);
 }
 
 /*
@@ -345,15 +1040,19 @@ JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_compressByteBuffer(
  *
  * Class:     com_intel_qat_InternalJNI
  * Method:    decompressByteBuffer
- * Signature: (JLjava/nio/ByteBuffer;[BII[BIII)I
+ * Signature: (JLjava/nio/ByteBuffer;[BII[BIII)J
  */
-JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_decompressByteBuffer(
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_decompressByteBuffer(
     JNIEnv *env, jclass clz, jlong sess, jobject src_buf, jbyteArray src_arr,
     jint src_pos, jint src_len, jbyteArray dst_arr, jint dst_pos, jint dst_len,
     jint retry_count) {
   (void)clz;
 
   QzSession_T *qz_session = (QzSession_T *)sess;
+  TRACE_PIN(qz_session, TRACE_DECOMPRESS);
+  jint src_idx = src_pos;
+  src_arr = heap_buffer_array(env, src_buf, src_arr, &src_idx);
+
   unsigned char *src_ptr =
       (unsigned char *)(*env)->GetPrimitiveArrayCritical(env, src_arr, NULL);
   unsigned char *dst_ptr =
@@ -362,16 +1061,14 @@ JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_decompressByteBuffer(
   int bytes_read = 0;
   int bytes_written = 0;
 
-  decompress(env, qz_session, src_ptr + src_pos, src_len, dst_ptr + dst_pos,
+  decompress(env, qz_session, src_ptr + src_idx, src_len, dst_ptr + dst_pos,
              dst_len, &bytes_read, &bytes_written, retry_count);
 
   (*env)->ReleasePrimitiveArrayCritical(env, dst_arr, (jbyte *)dst_ptr, 0);
   (*env)->ReleasePrimitiveArrayCritical(env, src_arr, (jbyte *)src_ptr, 0);
 
-  (*env)->SetIntField(env, src_buf, nio_bytebuffer_position_id,
-                      src_pos + bytes_read);
-
-  return bytes_written;
+  TRACE_UNPIN(qz_session, TRACE_DECOMPRESS);
+  return pack_result(bytes_read, bytes_written);
 }
 
 /*
@@ -379,15 +1076,16 @@ JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_decompressByteBuffer(
  *
  * Class:     com_intel_qat_InternalJNI
  * Method:    compressDirectByteBuffer
- * Signature: (JLjava/nio/ByteBuffer;IILjava/nio/ByteBuffer;III)I
+ * Signature: (JLjava/nio/ByteBuffer;IILjava/nio/ByteBuffer;III)J
  */
-jint JNICALL Java_com_intel_qat_InternalJNI_compressDirectByteBuffer(
+jlong JNICALL Java_com_intel_qat_InternalJNI_compressDirectByteBuffer(
     JNIEnv *env, jclass clz, jlong sess, jobject src_buf, jint src_pos,
     jint src_len, jobject dst_buf, jint dst_pos, jint dst_len,
     jint retry_count) {
   (void)clz;
 
   QzSession_T *qz_session = (QzSession_T *)sess;
+  TRACE_PIN(qz_session, TRACE_COMPRESS);
   unsigned char *src_ptr =
       (unsigned char *)(*env)->GetDirectBufferAddress(env, src_buf);
   unsigned char *dst_ptr =
@@ -399,13 +1097,8 @@ jint JNICALL Java_com_intel_qat_InternalJNI_compressDirectByteBuffer(
   compress(env, qz_session, src_ptr + src_pos, src_len, dst_ptr + dst_pos,
            dst_len, &bytes_read, &bytes_written, retry_count);
 
-  // set src and dest buffer positions
-  (*env)->SetIntField(env, src_buf, nio_bytebuffer_position_id,
-                      src_pos + bytes_read);
-  (*env)->SetIntField(env, dst_buf, nio_bytebuffer_position_id,
-                      dst_pos + bytes_written);
-
-  return bytes_written;
+  TRACE_UNPIN(qz_session, TRACE_COMPRESS);
+  return pack_result(bytes_read, bytes_written);
 }
 
 /*
@@ -413,9 +1106,9 @@ jint JNICALL Java_com_intel_qat_InternalJNI_compressDirectByteBuffer(
  *
  * Class:     com_intel_qat_InternalJNI
  * Method:    decompressDirectByteBuffer
- * Signature: (JLjava/nio/ByteBuffer;IILjava/nio/ByteBuffer;III)I
+ * Signature: (JLjava/nio/ByteBuffer;IILjava/nio/ByteBuffer;III)J
  */
-JNIEXPORT jint JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_intel_qat_InternalJNI_decompressDirectByteBuffer(
     JNIEnv *env, jclass clz, jlong sess, jobject src_buf, jint src_pos,
     jint src_len, jobject dst_buf, jint dst_pos, jint dst_len,
@@ -423,6 +1116,7 @@ Java_com_intel_qat_InternalJNI_decompressDirectByteBuffer(
   (void)clz;
 
   QzSession_T *qz_session = (QzSession_T *)sess;
+  TRACE_PIN(qz_session, TRACE_DECOMPRESS);
   unsigned char *src_ptr =
       (unsigned char *)(*env)->GetDirectBufferAddress(env, src_buf);
   unsigned char *dst_ptr =
@@ -434,21 +1128,16 @@ Java_com_intel_qat_InternalJNI_decompressDirectByteBuffer(
   decompress(env, qz_session, src_ptr + src_pos, src_len, dst_ptr + dst_pos,
              dst_len, &bytes_read, &bytes_written, retry_count);
 
-  // set src and dest buffer positions
-  (*env)->SetIntField(env, src_buf, nio_bytebuffer_position_id,
-                      src_pos + bytes_read);
-  (*env)->SetIntField(env, dst_buf, nio_bytebuffer_position_id,
-                      dst_pos + bytes_written);
-
-  return bytes_written;
+  TRACE_UNPIN(qz_session, TRACE_DECOMPRESS);
+  return pack_result(bytes_read, bytes_written);
 }
 
 /*
  * Class:     com_intel_qat_InternalJNI
  * Method:    compressDirectByteBufferSrc
- * Signature: (JLjava/nio/ByteBuffer;II[BIII)I
+ * Signature: (JLjava/nio/ByteBuffer;II[BIII)J
  */
-JNIEXPORT jint JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_intel_qat_InternalJNI_compressDirectByteBufferSrc(
     JNIEnv *env, jclass clz, jlong sess, jobject src_buf, jint src_pos,
     jint src_len, jbyteArray dst_arr, jint dst_pos, jint dst_len,
@@ -456,6 +1145,7 @@ Java_com_intel_qat_InternalJNI_compressDirectByteBufferSrc(
   (void)clz;
 
   QzSession_T *qz_session = (QzSession_T *)sess;
+  TRACE_PIN(qz_session, TRACE_COMPRESS);
   unsigned char *src_ptr =
       (unsigned char *)(*env)->GetDirectBufferAddress(env, src_buf);
   unsigned char *dst_ptr =
@@ -469,18 +1159,16 @@ Java_com_intel_qat_InternalJNI_compressDirectByteBufferSrc(
 
   (*env)->ReleasePrimitiveArrayCritical(env, dst_arr, (jbyte *)dst_ptr, 0);
 
-  (*env)->SetIntField(env, src_buf, nio_bytebuffer_position_id,
-                      src_pos + bytes_read);
-
-  return bytes_written;
+  TRACE_UNPIN(qz_session, TRACE_COMPRESS);
+  return pack_result(bytes_read, bytes_written);
 }
 
 /*
  * Class:     com_intel_qat_InternalJNI
  * Method:    decompressDirectByteBufferSrc
- * Signature: (JLjava/nio/ByteBuffer;II[BIII)I
+ * Signature: (JLjava/nio/ByteBuffer;II[BIII)J
  */
-JNIEXPORT jint JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_intel_qat_InternalJNI_decompressDirectByteBufferSrc(
     JNIEnv *env, jclass clz, jlong sess, jobject src_buf, jint src_pos,
     jint src_len, jbyteArray dst_arr, jint dst_pos, jint dst_len,
@@ -488,6 +1176,7 @@ Java_com_intel_qat_InternalJNI_decompressDirectByteBufferSrc(
   (void)clz;
 
   QzSession_T *qz_session = (QzSession_T *)sess;
+  TRACE_PIN(qz_session, TRACE_DECOMPRESS);
   unsigned char *src_ptr =
       (unsigned char *)(*env)->GetDirectBufferAddress(env, src_buf);
   unsigned char *dst_ptr =
@@ -501,18 +1190,16 @@ Java_com_intel_qat_InternalJNI_decompressDirectByteBufferSrc(
 
   (*env)->ReleasePrimitiveArrayCritical(env, dst_arr, (jbyte *)dst_ptr, 0);
 
-  (*env)->SetIntField(env, src_buf, nio_bytebuffer_position_id,
-                      src_pos + bytes_read);
-
-  return bytes_written;
+  TRACE_UNPIN(qz_session, TRACE_DECOMPRESS);
+  return pack_result(bytes_read, bytes_written);
 }
 
 /*
  * Class:     com_intel_qat_InternalJNI
  * Method:    compressDirectByteBufferDst
- * Signature: (JLjava/nio/ByteBuffer;[BIILjava/nio/ByteBuffer;III)I
+ * Signature: (JLjava/nio/ByteBuffer;[BIILjava/nio/ByteBuffer;III)J
  */
-JNIEXPORT jint JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_intel_qat_InternalJNI_compressDirectByteBufferDst(
     JNIEnv *env, jclass clz, jlong sess, jobject src_buf, jbyteArray src_arr,
     jint src_pos, jint src_len, jobject dst_buf, jint dst_pos, jint dst_len,
@@ -520,6 +1207,10 @@ Java_com_intel_qat_InternalJNI_compressDirectByteBufferDst(
   (void)clz;
 
   QzSession_T *qz_session = (QzSession_T *)sess;
+  TRACE_PIN(qz_session, TRACE_COMPRESS);
+  jint src_idx = src_pos;
+  src_arr = heap_buffer_array(env, src_buf, src_arr, &src_idx);
+
   unsigned char *src_ptr =
       (unsigned char *)(*env)->GetPrimitiveArrayCritical(env, src_arr, NULL);
   unsigned char *dst_ptr =
@@ -528,25 +1219,21 @@ Java_com_intel_qat_InternalJNI_compressDirectByteBufferDst(
   int bytes_read = 0;
   int bytes_written = 0;
 
-  compress(env, qz_session, src_ptr + src_pos, src_len, dst_ptr + dst_pos,
+  compress(env, qz_session, src_ptr + src_idx, src_len, dst_ptr + dst_pos,
            dst_len, &bytes_read, &bytes_written, retry_count);
 
   (*env)->ReleasePrimitiveArrayCritical(env, src_arr, (jbyte *)src_ptr, 0);
 
-  (*env)->SetIntField(env, src_buf, nio_bytebuffer_position_id,
-                      src_pos + bytes_read);
-  (*env)->SetIntField(env, dst_buf, nio_bytebuffer_position_id,
-                      dst_pos + bytes_written);
-
-  return bytes_written;
+  TRACE_UNPIN(qz_session, TRACE_COMPRESS);
+  return pack_result(bytes_read, bytes_written);
 }
 
 /*
  * Class:     com_intel_qat_InternalJNI
  * Method:    decompressDirectByteBufferDst
- * Signature: (JLjava/nio/ByteBuffer;[BIILjava/nio/ByteBuffer;III)I
+ * Signature: (JLjava/nio/ByteBuffer;[BIILjava/nio/ByteBuffer;III)J
  */
-JNIEXPORT jint JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_intel_qat_InternalJNI_decompressDirectByteBufferDst(
     JNIEnv *env, jclass clz, jlong sess, jobject src_buf, jbyteArray src_arr,
     jint src_pos, jint src_len, jobject dst_buf, jint dst_pos, jint dst_len,
@@ -554,6 +1241,10 @@ Java_com_intel_qat_InternalJNI_decompressDirectByteBufferDst(
   (void)clz;
 
   QzSession_T *qz_session = (QzSession_T *)sess;
+  TRACE_PIN(qz_session, TRACE_DECOMPRESS);
+  jint src_idx = src_pos;
+  src_arr = heap_buffer_array(env, src_buf, src_arr, &src_idx);
+
   unsigned char *src_ptr =
       (unsigned char *)(*env)->GetPrimitiveArrayCritical(env, src_arr, NULL);
   unsigned char *dst_ptr =
@@ -562,17 +1253,484 @@ Java_com_intel_qat_InternalJNI_decompressDirectByteBufferDst(
   int bytes_read = 0;
   int bytes_written = 0;
 
-  decompress(env, qz_session, src_ptr + src_pos, src_len, dst_ptr + dst_pos,
+  decompress(env, qz_session, src_ptr + src_idx, src_len, dst_ptr + dst_pos,
              dst_len, &bytes_read, &bytes_written, retry_count);
 
   (*env)->ReleasePrimitiveArrayCritical(env, src_arr, (jbyte *)src_ptr, 0);
 
-  (*env)->SetIntField(env, src_buf, nio_bytebuffer_position_id,
-                      src_pos + bytes_read);
-  (*env)->SetIntField(env, dst_buf, nio_bytebuffer_position_id,
-                      dst_pos + bytes_written);
+  TRACE_UNPIN(qz_session, TRACE_DECOMPRESS);
+  return pack_result(bytes_read, bytes_written);
+}
+
+/*
+ * Compresses a batch of buffers.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    compressBatch
+ * Signature: (J[Ljava/lang/Object;[Ljava/lang/Object;[I[II)I
+ */
+JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_compressBatch(
+    JNIEnv *env, jclass clz, jlong sess, jobjectArray srcs, jobjectArray dsts,
+    jintArray params, jintArray results, jint retry_count) {
+  (void)clz;
+
+  return process_batch(env, (QzSession_T *)sess, srcs, dsts, params, results,
+                       retry_count, compress_status,
+                       "Error occurred while compressing data.");
+}
+
+/*
+ * Decompresses a batch of buffers.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    decompressBatch
+ * Signature: (J[Ljava/lang/Object;[Ljava/lang/Object;[I[II)I
+ */
+JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_decompressBatch(
+    JNIEnv *env, jclass clz, jlong sess, jobjectArray srcs, jobjectArray dsts,
+    jintArray params, jintArray results, jint retry_count) {
+  (void)clz;
+
+  return process_batch(env, (QzSession_T *)sess, srcs, dsts, params, results,
+                       retry_count, decompress_status,
+                       "Error occurred while decompressing data.");
+}
+
+/**
+ * The compression of a shared source on one session of compressMulti.
+ */
+typedef struct multi_job {
+  QzSession_T *sess;
+  unsigned char *src;
+  unsigned int src_len;
+  batch_element out;
+  unsigned char *dst;
+  unsigned int dst_pos;
+  unsigned int dst_len;
+  int retry_count;
+  int status;
+  int bytes_read;
+  int bytes_written;
+  struct multi_job *next;
+  int finished;
+} multi_job;
+
+/**
+ * The most worker threads compressMulti keeps.
+ */
+#define MAX_MULTI_WORKERS 64
+
+/**
+ * The queue of compressMulti jobs and the persistent worker threads that run
+ * them. Workers are created on demand, up to MAX_MULTI_WORKERS, and wait for
+ * jobs while idle; a call whose jobs no worker takes runs them itself.
+ */
+static pthread_mutex_t multi_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t multi_queued = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t multi_finished = PTHREAD_COND_INITIALIZER;
+static multi_job *multi_head;
+static multi_job *multi_tail;
+static int multi_pending;
+static int multi_idle;
+static int multi_workers;
+
+/**
+ * Runs a multi_job.
+ */
+static void run_multi_job(multi_job *job) {
+  job->status =
+      compress_status(job->sess, job->src, job->src_len, job->dst,
+                      job->dst_len, &job->bytes_read, &job->bytes_written,
+                      job->retry_count);
+}
+
+/**
+ * Removes the first queued job, if any. Called with multi_lock held.
+ */
+static multi_job *dequeue_multi_job(void) {
+  multi_job *job = multi_head;
+  if (job) {
+    multi_head = job->next;
+    if (!multi_head) multi_tail = NULL;
+    multi_pending--;
+  }
+  return job;
+}
+
+/**
+ * Runs a dequeued job, and marks it finished. Called with multi_lock held,
+ * which is released while the job runs.
+ */
+static void finish_multi_job(multi_job *job) {
+  pthread_mutex_unlock(&multi_lock);
+  run_multi_job(job);
+  pthread_mutex_lock(&multi_lock);
+  job->finished = 1;
+  pthread_cond_broadcast(&multi_finished);
+}
+
+/**
+ * The loop of a worker thread; a worker is counted as idle while it waits.
+ */
+static void *multi_worker(void *arg) {
+  (void)arg;
+  pthread_mutex_lock(&multi_lock);
+  for (;;) {
+    multi_job *job;
+    while (!(job = dequeue_multi_job()))
+      pthread_cond_wait(&multi_queued, &multi_lock);
+    multi_idle--;
+    finish_multi_job(job);
+    multi_idle++;
+  }
+  return NULL;
+}
+
+/**
+ * Runs the jobs of a compressMulti call concurrently: the first on the
+ * calling thread and the others on the workers. Returns once all have
+ * finished.
+ */
+static void run_multi_jobs(multi_job *jobs, jsize count) {
+  pthread_mutex_lock(&multi_lock);
+  for (jsize i = 1; i < count; i++) {
+    jobs[i].next = NULL;
+    jobs[i].finished = 0;
+    if (multi_tail)
+      multi_tail->next = &jobs[i];
+    else
+      multi_head = &jobs[i];
+    multi_tail = &jobs[i];
+    multi_pending++;
+  }
+  while (multi_idle < multi_pending && multi_workers < MAX_MULTI_WORKERS) {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, multi_worker, NULL) != 0) break;
+    pthread_detach(thread);
+    multi_workers++;
+    multi_idle++;
+  }
+  pthread_cond_broadcast(&multi_queued);
+  pthread_mutex_unlock(&multi_lock);
+
+  run_multi_job(&jobs[0]);
+
+  // Help with the queued jobs, which may be this call's when the workers are
+  // busy, then wait for the rest.
+  pthread_mutex_lock(&multi_lock);
+  multi_job *job;
+  while ((job = dequeue_multi_job())) finish_multi_job(job);
+  for (jsize i = 1; i < count; i++)
+    while (!jobs[i].finished) pthread_cond_wait(&multi_finished, &multi_lock);
+  pthread_mutex_unlock(&multi_lock);
+}
+
+/*
+ * Compresses one source with several sessions at once. Each session but the
+ * first compresses the source on a worker thread while the calling thread runs
+ * the first, so the sessions submit their requests to QAT concurrently. The
+ * source is pinned once for all sessions; every buffer is resolved before the
+ * first byte array is pinned, and all stay pinned until the last session
+ * finishes. The results of a session that fails are -1 and its status; no
+ * exception is thrown for it.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    compressMulti
+ * Signature: ([JLjava/lang/Object;II[Ljava/lang/Object;[I[I)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_compressMulti(
+    JNIEnv *env, jclass clz, jlongArray sessions, jobject src, jint src_pos,
+    jint src_len, jobjectArray dsts, jintArray params, jintArray results) {
+  (void)clz;
+
+  jsize count = (*env)->GetArrayLength(env, sessions);
+  multi_job *jobs = (multi_job *)calloc(count, sizeof(multi_job));
+  jlong *s = jobs ? (*env)->GetLongArrayElements(env, sessions, NULL) : NULL;
+  jint *p = s ? (*env)->GetIntArrayElements(env, params, NULL) : NULL;
+  if (!p) {
+    if (s) (*env)->ReleaseLongArrayElements(env, sessions, s, JNI_ABORT);
+    free(jobs);
+    throw_exception(env, QZ_LOW_MEM, "Allocating compression jobs failed.");
+    return;
+  }
+
+  for (jsize i = 0; i < count; i++) {
+    jobs[i].sess = (QzSession_T *)s[i];
+    jobs[i].src_len = src_len;
+    jobs[i].dst_pos = p[3 * i];
+    jobs[i].dst_len = p[3 * i + 1];
+    jobs[i].retry_count = p[3 * i + 2];
+  }
+  (*env)->ReleaseLongArrayElements(env, sessions, s, JNI_ABORT);
+  (*env)->ReleaseIntArrayElements(env, params, p, JNI_ABORT);
+
+  batch_element in;
+  resolve_batch_element(env, src, &in);
+  for (jsize i = 0; i < count; i++)
+    resolve_batch_element(env, (*env)->GetObjectArrayElement(env, dsts, i),
+                          &jobs[i].out);
+
+  int ok = pin_batch_element(env, &in);
+  for (jsize i = 0; ok && i < count; i++) {
+    ok = pin_batch_element(env, &jobs[i].out);
+    if (ok) {
+      jobs[i].src = in.ptr + src_pos;
+      jobs[i].dst = jobs[i].out.ptr + jobs[i].dst_pos;
+    }
+  }
+
+  if (ok) run_multi_jobs(jobs, count);
+
+  for (jsize i = count - 1; i >= 0; i--)
+    unpin_batch_element(env, &jobs[i].out);
+  unpin_batch_element(env, &in);
+  for (jsize i = 0; i < count; i++)
+    (*env)->DeleteLocalRef(env, jobs[i].out.obj);
+  if (!ok) {
+    free(jobs);
+    if (!(*env)->ExceptionCheck(env))
+      throw_exception(env, QZ_LOW_MEM, "Pinning compression buffers failed.");
+    return;
+  }
+
+  // A failed job reports -1 and its status, so that the caller can retry it.
+  for (jsize i = 0; i < count; i++) {
+    jint r[2] = {jobs[i].bytes_read, jobs[i].bytes_written};
+    if (jobs[i].status != QZ_OK) {
+      r[0] = -1;
+      r[1] = jobs[i].status;
+    }
+    (*env)->SetIntArrayRegion(env, results, 2 * i, 2, r);
+  }
+  free(jobs);
+}
+
+/*
+ * Compresses native memory for the foreign function backend.
+ */
+JNIEXPORT int qat_java_compress(jlong sess, unsigned char *src, int src_len,
+                                unsigned char *dst, int dst_len,
+                                int retry_count, jlong *result) {
+  int bytes_read = 0;
+  int bytes_written = 0;
+  int status =
+      compress_status((QzSession_T *)sess, src, src_len, dst, dst_len,
+                      &bytes_read, &bytes_written, retry_count);
+  *result = pack_result(bytes_read, bytes_written);
+  return status;
+}
+
+/*
+ * Decompresses native memory for the foreign function backend.
+ */
+JNIEXPORT int qat_java_decompress(jlong sess, unsigned char *src, int src_len,
+                                  unsigned char *dst, int dst_len,
+                                  int retry_count, jlong *result) {
+  int bytes_read = 0;
+  int bytes_written = 0;
+  int status =
+      decompress_status((QzSession_T *)sess, src, src_len, dst, dst_len,
+                        &bytes_read, &bytes_written, retry_count);
+  *result = pack_result(bytes_read, bytes_written);
+  return status;
+}
+
+/**
+ * Feeds a chunk of compressed data in a byte array to a QATzip decompression
+ * stream and collects the output that is ready. QATzip buffers the input
+ * internally, so a compressed block may span any number of chunks.
+ *
+ * @param env a pointer to the JNI environment.
+ * @param sess a pointer to the QzSession_T object.
+ * @param strm a pointer to the QzStream_T object.
+ * @param src_arr the source array.
+ * @param src_pos the start offset of the source.
+ * @param src_len the number of source bytes to feed.
+ * @param dst_arr the destination array.
+ * @param dst_pos the start offset of the destination.
+ * @param dst_len the maximum number of bytes to write.
+ * @param last whether this is the last chunk of the compressed input.
+ * @param retry_count the number of retries before we give up.
+ * @return the bytes read and the bytes written, packed by pack_result.
+ */
+static jlong process_stream(JNIEnv *env, QzSession_T *sess, QzStream_T *strm,
+                            jbyteArray src_arr, jint src_pos, jint src_len,
+                            jbyteArray dst_arr, jint dst_pos, jint dst_len,
+                            jboolean last, jint retry_count) {
+  unsigned char *src_ptr =
+      (unsigned char *)(*env)->GetPrimitiveArrayCritical(env, src_arr, NULL);
+  unsigned char *dst_ptr =
+      (unsigned char *)(*env)->GetPrimitiveArrayCritical(env, dst_arr, NULL);
+
+  int retries = 0;
+  int record = atomic_load_explicit(&stats_enabled, memory_order_relaxed);
+  long long start = record ? stats_now() : 0;
+  int status;
+  do {
+    strm->in = src_ptr + src_pos;
+    strm->in_sz = src_len;
+    strm->out = dst_ptr + dst_pos;
+    strm->out_sz = dst_len;
+    status = qzDecompressStream(sess, strm, last);
+  } while (status == QZ_NOSW_NO_INST_ATTACH && retries++ < retry_count);
+
+  (*env)->ReleasePrimitiveArrayCritical(env, dst_arr, (jbyte *)dst_ptr, 0);
+  (*env)->ReleasePrimitiveArrayCritical(env, src_arr, (jbyte *)src_ptr, 0);
+
+  if (record)
+    stats_record(&((qat_session *)sess)->stats, 1, status,
+                 strm->in_sz, strm->out_sz, retries,
+                 sess->hw_session_stat == QZ_OK, stats_now() - start);
+
+  if (status != QZ_OK) {
+    throw_exception(env, status, "Error occurred while decompressing stream.");
+    return 0;
+  }
+
+  return pack_result(strm->in_sz, strm->out_sz);
+}
+
+/*
+ * Allocates the state of a decompression stream.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    createStream
+ * Signature: ()J
+ */
+JNIEXPORT jlong JNICALL
+Java_com_intel_qat_InternalJNI_createStream(JNIEnv *env, jclass clz) {
+  (void)clz;
+
+  QzStream_T *strm = (QzStream_T *)calloc(1, sizeof(QzStream_T));
+  if (!strm) {
+    throw_exception(env, QZ_LOW_MEM, "Allocating a QAT stream failed.");
+    return 0;
+  }
 
-  return bytes_written;
+  return (jlong)strm;
+}
+
+/*
+ * Decompresses a chunk of a byte array through a stream.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    decompressStream
+ * Signature: (JJ[BII[BIIZI)J
+ */
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_decompressStream(
+    JNIEnv *env, jclass clz, jlong sess, jlong strm, jbyteArray src_arr,
+    jint src_pos, jint src_len, jbyteArray dst_arr, jint dst_pos, jint dst_len,
+    jboolean last, jint retry_count) {
+  (void)clz;
+
+  return process_stream(env, (QzSession_T *)sess, (QzStream_T *)strm, src_arr,
+                        src_pos, src_len, dst_arr, dst_pos, dst_len, last,
+                        retry_count);
+}
+
+/*
+ * Returns the number of bytes a stream holds that have not been returned yet,
+ * either input not yet processed or output not yet copied out.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    streamPending
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_streamPending(
+    JNIEnv *env, jclass clz, jlong strm) {
+  (void)env;
+  (void)clz;
+
+  QzStream_T *qz_stream = (QzStream_T *)strm;
+  return (jint)(qz_stream->pending_in + qz_stream->pending_out);
+}
+
+/*
+ * Releases the buffers QATzip holds for a stream and frees the stream.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    endStream
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_endStream(JNIEnv *env,
+                                                               jclass clz,
+                                                               jlong sess,
+                                                               jlong strm) {
+  (void)clz;
+
+  QzStream_T *qz_stream = (QzStream_T *)strm;
+  if (!qz_stream) return;
+
+  int status = qzEndStream((QzSession_T *)sess, qz_stream);
+  free(qz_stream);
+  if (status != QZ_OK)
+    throw_exception(env, status, "Error occurred while ending stream.");
+}
+
+/*
+ * Allocates native memory with qzMalloc on the given NUMA node. Unless
+ * force_pinned is set, QATzip falls back to ordinary memory when no pinned
+ * memory is available.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    allocateNativeBuffer
+ * Signature: (JIZ)J
+ */
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_allocateNativeBuffer(
+    JNIEnv *env, jclass clz, jlong size, jint numa, jboolean force_pinned) {
+  (void)clz;
+
+  void *mem =
+      qzMalloc((size_t)size, numa, force_pinned ? PINNED_MEM : COMMON_MEM);
+  if (!mem) {
+    throw_exception(env, QZ_LOW_MEM, "Unable to allocate native buffer.");
+    return 0;
+  }
+
+  return (jlong)(intptr_t)mem;
+}
+
+/*
+ * Wraps native memory allocated by allocateNativeBuffer in a direct ByteBuffer.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    wrapNativeBuffer
+ * Signature: (JI)Ljava/nio/ByteBuffer;
+ */
+JNIEXPORT jobject JNICALL Java_com_intel_qat_InternalJNI_wrapNativeBuffer(
+    JNIEnv *env, jclass clz, jlong address, jint capacity) {
+  (void)clz;
+
+  return (*env)->NewDirectByteBuffer(env, (void *)(intptr_t)address, capacity);
+}
+
+/*
+ * Returns the address of the given direct buffer.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    bufferAddress
+ * Signature: (Ljava/nio/ByteBuffer;)J
+ */
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_bufferAddress(
+    JNIEnv *env, jclass clz, jobject buffer) {
+  (void)clz;
+
+  return (jlong)(intptr_t)(*env)->GetDirectBufferAddress(env, buffer);
+}
+
+/*
+ * Frees native memory allocated by allocateNativeBuffer.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    freeNativeBuffer
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_freeNativeBuffer(
+    JNIEnv *env, jclass clz, jlong address) {
+  (void)env;
+  (void)clz;
+
+  qzFree((void *)(intptr_t)address);
 }
 
 /*
@@ -587,7 +1745,13 @@ JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_maxCompressedSize(
   (void)env;
   (void)clz;
 
-  return qzMaxCompressedLength(src_size, (QzSession_T *)sess);
+  qat_session *session = (qat_session *)sess;
+  if (session->zstd) return qat_zstd_max_compressed_length(src_size);
+  if (session->dict) return dict_max_compressed_length(session->dict, src_size);
+  int framing = session->format == FORMAT_ZLIB
+                    ? ZLIB_HEADER_SIZE + ZLIB_TRAILER_SIZE
+                    : 0;
+  return qzMaxCompressedLength(src_size, (QzSession_T *)sess) + framing;
 }
 
 /*
@@ -605,7 +1769,18 @@ JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_teardown(JNIEnv *env,
   QzSession_T *qz_session = (QzSession_T *)sess;
   if (!qz_session) return QZ_OK;
 
-  int status = qzTeardownSession(qz_session);
+  qat_zstd *zstd = ((qat_session *)qz_session)->zstd;
+  QzSession_T *periodical = ((qat_session *)qz_session)->periodical;
+  if (periodical) {
+    qzTeardownSession(periodical);
+    free(periodical);
+  }
+  qat_dictionary *dict = ((qat_session *)qz_session)->dict;
+  int status = zstd || dict ? QZ_OK : qzTeardownSession(qz_session);
+  qat_zstd_free(zstd);
+  inflater_free(((qat_session *)qz_session)->inflater);
+  dict_free(dict);
+  free(qz_session);
   if (status != QZ_OK) {
     throw_exception(env, status, "Error occurred while tearing down session.");
     return 0;
@@ -613,3 +1788,93 @@ JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_teardown(JNIEnv *env,
 
   return QZ_OK;
 }
+
+/*
+ * Enables or disables the counters of all sessions.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    setStatsEnabled
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_setStatsEnabled(
+    JNIEnv *env, jclass clz, jboolean enabled) {
+  (void)env;
+  (void)clz;
+
+  atomic_store_explicit(&stats_enabled, enabled ? 1 : 0, memory_order_relaxed);
+}
+
+/*
+ * Tells whether the counters of all sessions are enabled.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    isStatsEnabled
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_intel_qat_InternalJNI_isStatsEnabled(JNIEnv *env, jclass clz) {
+  (void)env;
+  (void)clz;
+
+  return atomic_load_explicit(&stats_enabled, memory_order_relaxed) ? JNI_TRUE
+                                                                    : JNI_FALSE;
+}
+
+/*
+ * Copies the counters of the given session, or the global counters if the
+ * session is 0, into the given array.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    readStats
+ * Signature: (J[J)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_readStats(
+    JNIEnv *env, jclass clz, jlong sess, jlongArray out) {
+  (void)clz;
+
+  long long counters[STATS_LENGTH];
+  stats_snapshot(sess ? &((qat_session *)sess)->stats : &global_stats,
+                 counters);
+
+  jlong values[STATS_LENGTH];
+  for (int i = 0; i < STATS_LENGTH; i++) values[i] = (jlong)counters[i];
+  (*env)->SetLongArrayRegion(env, out, 0, STATS_LENGTH, values);
+}
+
+/*
+ * Resets the counters of the given session, or the global counters if the
+ * session is 0.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    resetStats
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_resetStats(JNIEnv *env,
+                                                                 jclass clz,
+                                                                 jlong sess) {
+  (void)env;
+  (void)clz;
+
+  stats_reset(sess ? &((qat_session *)sess)->stats : &global_stats);
+}
+
+/*
+ * Returns the QATzip status codes whose errors are counted individually, in
+ * the order of their counters.
+ *
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    statsErrorCodes
+ * Signature: ()[I
+ */
+JNIEXPORT jintArray JNICALL
+Java_com_intel_qat_InternalJNI_statsErrorCodes(JNIEnv *env, jclass clz) {
+  (void)clz;
+
+  jintArray codes = (*env)->NewIntArray(env, STATS_ERROR_CODES);
+  if (!codes) return NULL;
+
+  jint values[STATS_ERROR_CODES];
+  for (int i = 0; i < STATS_ERROR_CODES; i++) values[i] = stats_error_codes[i];
+  (*env)->SetIntArrayRegion(env, codes, 0, STATS_ERROR_CODES, values);
+  return codes;
+}
@@ -9,20 +9,28 @@ extern "C" {
 #endif
 /*
  * Class:     com_intel_qat_InternalJNI
- * Method:    initFieldIDs
- * Signature: ()V
+ * Method:    setup
+ * Signature: (IIIIII)J
  */
-JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_initFieldIDs(JNIEnv *,
-                                                                   jclass);
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_setup(JNIEnv *, jclass,
+                                                             jint, jint, jint,
+                                                             jint, jint, jint);
 
 /*
  * Class:     com_intel_qat_InternalJNI
- * Method:    setup
- * Signature: (Lcom/intel/qat/QatZipper;IIII)V
+ * Method:    isZstdAvailable
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_intel_qat_InternalJNI_isZstdAvailable(JNIEnv *, jclass);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    currentNumaNode
+ * Signature: ()I
  */
-JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_setup(JNIEnv *, jclass,
-                                                            jobject, jint, jint,
-                                                            jint, jint);
+JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_currentNumaNode(JNIEnv *,
+                                                                      jclass);
 
 /*
  * Class:     com_intel_qat_InternalJNI
@@ -32,56 +40,101 @@ JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_setup(JNIEnv *, jclass,
 JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_maxCompressedSize(
     JNIEnv *, jclass, jlong, jlong);
 
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    setupDictionary
+ * Signature: (II[B)J
+ */
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_setupDictionary(
+    JNIEnv *, jclass, jint, jint, jbyteArray);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    setChecksumEnabled
+ * Signature: (JZ)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_setChecksumEnabled(
+    JNIEnv *, jclass, jlong, jboolean);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    setSpinBudget
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_setSpinBudget(JNIEnv *,
+                                                                    jclass,
+                                                                    jlong,
+                                                                    jlong);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    checksum
+ * Signature: (J)J
+ */
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_checksum(JNIEnv *,
+                                                               jclass, jlong);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    crc32Combine
+ * Signature: (JJJ)J
+ */
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_crc32Combine(
+    JNIEnv *, jclass, jlong, jlong, jlong);
+
 /*
  * Class:     com_intel_qat_InternalJNI
  * Method:    compressByteArray
- * Signature: (Lcom/intel/qat/QatZipper;J[BII[BIII)I
+ * Signature: (J[BII[BIII)J
  */
-JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_compressByteArray(
-    JNIEnv *, jclass, jobject, jlong, jbyteArray, jint, jint, jbyteArray, jint,
-    jint, jint);
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_compressByteArray(
+    JNIEnv *, jclass, jlong, jbyteArray, jint, jint, jbyteArray, jint, jint,
+    jint);
 
 /*
  * Class:     com_intel_qat_InternalJNI
  * Method:    decompressByteArray
- * Signature: (Lcom/intel/qat/QatZipper;J[BII[BIII)I
+ * Signature: (J[BII[BIII)J
  */
-JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_decompressByteArray(
-    JNIEnv *, jclass, jobject, jlong, jbyteArray, jint, jint, jbyteArray, jint,
-    jint, jint);
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_decompressByteArray(
+    JNIEnv *, jclass, jlong, jbyteArray, jint, jint, jbyteArray, jint, jint,
+    jint);
 
 /*
  * Class:     com_intel_qat_InternalJNI
  * Method:    compressByteBuffer
- * Signature: (JLjava/nio/ByteBuffer;[BII[BIII)I
+ * Signature: (JLjava/nio/ByteBuffer;[BII[BIII)J
  */
-JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_compressByteBuffer(
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_compressByteBuffer(
     JNIEnv *, jclass, jlong, jobject, jbyteArray, jint, jint, jbyteArray, jint,
     jint, jint);
 
 /*
  * Class:     com_intel_qat_InternalJNI
  * Method:    decompressByteBuffer
- * Signature: (JLjava/nio/ByteBuffer;[BII[BIII)I
+ * Signature: (JLjava/nio/ByteBuffer;[BII[BIII)J
  */
-JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_decompressByteBuffer(
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_decompressByteBuffer(
     JNIEnv *, jclass, jlong, jobject, jbyteArray, jint, jint, jbyteArray, jint,
     jint, jint);
 
 /*
  * Class:     com_intel_qat_InternalJNI
  * Method:    compressDirectByteBuffer
- * Signature: (JLjava/nio/ByteBuffer;IILjava/nio/ByteBuffer;III)I
+ * Signature: (JLjava/nio/ByteBuffer;IILjava/nio/ByteBuffer;III)J
  */
-JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_compressDirectByteBuffer(
-    JNIEnv *, jclass, jlong, jobject, jint, jint, jobject, jint, jint, jint);
+JNIEXPORT jlong JNICALL
+Java_com_intel_qat_InternalJNI_compressDirectByteBuffer(JNIEnv *, jclass, jlong,
+                                                        jobject, jint, jint,
+                                                        jobject, jint, jint,
+                                                        jint);
 
 /*
  * Class:     com_intel_qat_InternalJNI
  * Method:    decompressDirectByteBuffer
- * Signature: (JLjava/nio/ByteBuffer;IILjava/nio/ByteBuffer;III)I
+ * Signature: (JLjava/nio/ByteBuffer;IILjava/nio/ByteBuffer;III)J
  */
-JNIEXPORT jint JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_intel_qat_InternalJNI_decompressDirectByteBuffer(JNIEnv *, jclass,
                                                           jlong, jobject, jint,
                                                           jint, jobject, jint,
@@ -90,9 +143,9 @@ Java_com_intel_qat_InternalJNI_decompressDirectByteBuffer(JNIEnv *, jclass,
 /*
  * Class:     com_intel_qat_InternalJNI
  * Method:    compressDirectByteBufferSrc
- * Signature: (JLjava/nio/ByteBuffer;II[BIII)I
+ * Signature: (JLjava/nio/ByteBuffer;II[BIII)J
  */
-JNIEXPORT jint JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_intel_qat_InternalJNI_compressDirectByteBufferSrc(JNIEnv *, jclass,
                                                            jlong, jobject, jint,
                                                            jint, jbyteArray,
@@ -101,18 +154,18 @@ Java_com_intel_qat_InternalJNI_compressDirectByteBufferSrc(JNIEnv *, jclass,
 /*
  * Class:     com_intel_qat_InternalJNI
  * Method:    decompressDirectByteBufferSrc
- * Signature: (JLjava/nio/ByteBuffer;II[BIII)I
+ * Signature: (JLjava/nio/ByteBuffer;II[BIII)J
  */
-JNIEXPORT jint JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_intel_qat_InternalJNI_decompressDirectByteBufferSrc(
     JNIEnv *, jclass, jlong, jobject, jint, jint, jbyteArray, jint, jint, jint);
 
 /*
  * Class:     com_intel_qat_InternalJNI
  * Method:    compressDirectByteBufferDst
- * Signature: (JLjava/nio/ByteBuffer;[BIILjava/nio/ByteBuffer;III)I
+ * Signature: (JLjava/nio/ByteBuffer;[BIILjava/nio/ByteBuffer;III)J
  */
-JNIEXPORT jint JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_intel_qat_InternalJNI_compressDirectByteBufferDst(JNIEnv *, jclass,
                                                            jlong, jobject,
                                                            jbyteArray, jint,
@@ -122,15 +175,111 @@ Java_com_intel_qat_InternalJNI_compressDirectByteBufferDst(JNIEnv *, jclass,
 /*
  * Class:     com_intel_qat_InternalJNI
  * Method:    decompressDirectByteBufferDst
- * Signature: (JLjava/nio/ByteBuffer;[BIILjava/nio/ByteBuffer;III)I
+ * Signature: (JLjava/nio/ByteBuffer;[BIILjava/nio/ByteBuffer;III)J
  */
-JNIEXPORT jint JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_intel_qat_InternalJNI_decompressDirectByteBufferDst(JNIEnv *, jclass,
                                                              jlong, jobject,
                                                              jbyteArray, jint,
                                                              jint, jobject,
                                                              jint, jint, jint);
 
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    compressBatch
+ * Signature: (J[Ljava/lang/Object;[Ljava/lang/Object;[I[II)I
+ */
+JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_compressBatch(
+    JNIEnv *, jclass, jlong, jobjectArray, jobjectArray, jintArray, jintArray,
+    jint);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    decompressBatch
+ * Signature: (J[Ljava/lang/Object;[Ljava/lang/Object;[I[II)I
+ */
+JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_decompressBatch(
+    JNIEnv *, jclass, jlong, jobjectArray, jobjectArray, jintArray, jintArray,
+    jint);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    compressMulti
+ * Signature: ([JLjava/lang/Object;II[Ljava/lang/Object;[I[I)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_compressMulti(
+    JNIEnv *, jclass, jlongArray, jobject, jint, jint, jobjectArray, jintArray,
+    jintArray);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    createStream
+ * Signature: ()J
+ */
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_createStream(JNIEnv *,
+                                                                    jclass);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    decompressStream
+ * Signature: (JJ[BII[BIIZI)J
+ */
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_decompressStream(
+    JNIEnv *, jclass, jlong, jlong, jbyteArray, jint, jint, jbyteArray, jint,
+    jint, jboolean, jint);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    streamPending
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_streamPending(JNIEnv *,
+                                                                    jclass,
+                                                                    jlong);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    endStream
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_endStream(JNIEnv *,
+                                                               jclass, jlong,
+                                                               jlong);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    allocateNativeBuffer
+ * Signature: (JIZ)J
+ */
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_allocateNativeBuffer(
+    JNIEnv *, jclass, jlong, jint, jboolean);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    wrapNativeBuffer
+ * Signature: (JI)Ljava/nio/ByteBuffer;
+ */
+JNIEXPORT jobject JNICALL Java_com_intel_qat_InternalJNI_wrapNativeBuffer(
+    JNIEnv *, jclass, jlong, jint);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    bufferAddress
+ * Signature: (Ljava/nio/ByteBuffer;)J
+ */
+JNIEXPORT jlong JNICALL Java_com_intel_qat_InternalJNI_bufferAddress(JNIEnv *,
+                                                                    jclass,
+                                                                    jobject);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    freeNativeBuffer
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_freeNativeBuffer(JNIEnv *,
+                                                                      jclass,
+                                                                      jlong);
+
 /*
  * Class:     com_intel_qat_InternalJNI
  * Method:    teardown
@@ -139,6 +288,48 @@ Java_com_intel_qat_InternalJNI_decompressDirectByteBufferDst(JNIEnv *, jclass,
 JNIEXPORT jint JNICALL Java_com_intel_qat_InternalJNI_teardown(JNIEnv *, jclass,
                                                                jlong);
 
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    setStatsEnabled
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_setStatsEnabled(
+    JNIEnv *, jclass, jboolean);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    isStatsEnabled
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_intel_qat_InternalJNI_isStatsEnabled(
+    JNIEnv *, jclass);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    readStats
+ * Signature: (J[J)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_readStats(JNIEnv *,
+                                                                jclass, jlong,
+                                                                jlongArray);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    resetStats
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_com_intel_qat_InternalJNI_resetStats(JNIEnv *,
+                                                                 jclass,
+                                                                 jlong);
+
+/*
+ * Class:     com_intel_qat_InternalJNI
+ * Method:    statsErrorCodes
+ * Signature: ()[I
+ */
+JNIEXPORT jintArray JNICALL
+Java_com_intel_qat_InternalJNI_statsErrorCodes(JNIEnv *, jclass);
+
 #ifdef __cplusplus
 }
 #endif
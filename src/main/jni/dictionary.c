@@ -0,0 +1,197 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+#include "dictionary.h"
+
+#include <lz4.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "qatzip.h"
+
+/**
+ * The size of the header in front of each LZ4 block.
+ */
+#define LZ4_HEADER_SIZE 8
+
+struct qat_dictionary {
+  int algorithm;
+  unsigned char *data;
+  unsigned int length;
+  z_stream deflater;
+  z_stream inflater;
+  // The dictionary is loaded into lz4_dict once; each call compresses with a
+  // copy of it, which is much cheaper than loading the dictionary again.
+  LZ4_stream_t *lz4_dict;
+  LZ4_stream_t *lz4_work;
+};
+
+static void put_le32(unsigned char *p, unsigned int v) {
+  p[0] = (unsigned char)v;
+  p[1] = (unsigned char)(v >> 8);
+  p[2] = (unsigned char)(v >> 16);
+  p[3] = (unsigned char)(v >> 24);
+}
+
+static unsigned int get_le32(const unsigned char *p) {
+  return (unsigned int)p[0] | (unsigned int)p[1] << 8 |
+         (unsigned int)p[2] << 16 | (unsigned int)p[3] << 24;
+}
+
+qat_dictionary *dict_create(int algorithm, int level,
+                            const unsigned char *data, unsigned int length) {
+  qat_dictionary *dict = (qat_dictionary *)calloc(1, sizeof(qat_dictionary));
+  if (!dict) return NULL;
+
+  dict->algorithm = algorithm;
+  dict->length = length;
+  dict->data = (unsigned char *)malloc(length ? length : 1);
+  int ok = dict->data != NULL;
+  if (ok) memcpy(dict->data, data, length);
+
+  if (ok && algorithm == DICT_DEFLATE) {
+    // QAT levels go beyond the zlib maximum.
+    int zlib_level = level > Z_BEST_COMPRESSION ? Z_BEST_COMPRESSION : level;
+    ok = deflateInit2(&dict->deflater, zlib_level, Z_DEFLATED, MAX_WBITS,
+                      8, Z_DEFAULT_STRATEGY) == Z_OK &&
+         inflateInit(&dict->inflater) == Z_OK;
+  } else if (ok) {
+    dict->lz4_dict = LZ4_createStream();
+    dict->lz4_work = LZ4_createStream();
+    ok = dict->lz4_dict && dict->lz4_work;
+    if (ok) LZ4_loadDict(dict->lz4_dict, (const char *)dict->data, length);
+  }
+
+  if (!ok) {
+    dict_free(dict);
+    return NULL;
+  }
+  return dict;
+}
+
+void dict_free(qat_dictionary *dict) {
+  if (!dict) return;
+  // Ending a stream that was never initialized is a no-op.
+  deflateEnd(&dict->deflater);
+  inflateEnd(&dict->inflater);
+  LZ4_freeStream(dict->lz4_dict);
+  LZ4_freeStream(dict->lz4_work);
+  free(dict->data);
+  free(dict);
+}
+
+unsigned int dict_max_compressed_length(qat_dictionary *dict,
+                                        unsigned int src_len) {
+  if (dict->algorithm == DICT_DEFLATE)
+    return (unsigned int)deflateBound(&dict->deflater, src_len);
+  return (unsigned int)LZ4_compressBound((int)src_len) + LZ4_HEADER_SIZE;
+}
+
+static int deflate_compress(qat_dictionary *dict, unsigned char *src,
+                            unsigned int *src_len, unsigned char *dst,
+                            unsigned int *dst_len) {
+  z_stream *strm = &dict->deflater;
+  if (deflateReset(strm) != Z_OK ||
+      deflateSetDictionary(strm, dict->data, dict->length) != Z_OK)
+    return QZ_FAIL;
+
+  strm->next_in = src;
+  strm->avail_in = *src_len;
+  strm->next_out = dst;
+  strm->avail_out = *dst_len;
+  if (deflate(strm, Z_FINISH) != Z_STREAM_END) return QZ_BUF_ERROR;
+
+  *src_len = (unsigned int)strm->total_in;
+  *dst_len = (unsigned int)strm->total_out;
+  return QZ_OK;
+}
+
+static int deflate_decompress(qat_dictionary *dict, unsigned char *src,
+                              unsigned int *src_len, unsigned char *dst,
+                              unsigned int *dst_len) {
+  z_stream *strm = &dict->inflater;
+  if (inflateReset(strm) != Z_OK) return QZ_FAIL;
+
+  strm->next_in = src;
+  strm->avail_in = *src_len;
+  strm->next_out = dst;
+  strm->avail_out = *dst_len;
+  int ret = inflate(strm, Z_NO_FLUSH);
+  if (ret == Z_NEED_DICT) {
+    // A wrong dictionary fails here or with Z_DATA_ERROR below.
+    if (inflateSetDictionary(strm, dict->data, dict->length) != Z_OK)
+      return QZ_FAIL;
+    ret = inflate(strm, Z_NO_FLUSH);
+  }
+
+  if (ret == Z_STREAM_END) {
+    *src_len = (unsigned int)strm->total_in;
+    *dst_len = (unsigned int)strm->total_out;
+    return QZ_OK;
+  }
+
+  *src_len = *dst_len = 0;
+  return ret == Z_OK || ret == Z_BUF_ERROR ? QZ_BUF_ERROR : QZ_FAIL;
+}
+
+static int lz4_compress(qat_dictionary *dict, unsigned char *src,
+                        unsigned int *src_len, unsigned char *dst,
+                        unsigned int *dst_len) {
+  if (*dst_len <= LZ4_HEADER_SIZE) return QZ_BUF_ERROR;
+
+  memcpy(dict->lz4_work, dict->lz4_dict, sizeof(LZ4_stream_t));
+  int n = LZ4_compress_fast_continue(
+      dict->lz4_work, (const char *)src, (char *)dst + LZ4_HEADER_SIZE,
+      (int)*src_len, (int)(*dst_len - LZ4_HEADER_SIZE), 1);
+  if (n <= 0) return QZ_BUF_ERROR;
+
+  put_le32(dst, (unsigned int)n);
+  put_le32(dst + 4, *src_len);
+  *dst_len = (unsigned int)n + LZ4_HEADER_SIZE;
+  return QZ_OK;
+}
+
+static int lz4_decompress(qat_dictionary *dict, unsigned char *src,
+                          unsigned int *src_len, unsigned char *dst,
+                          unsigned int *dst_len) {
+  unsigned int compressed = 0;
+  unsigned int original = 0;
+  if (*src_len >= LZ4_HEADER_SIZE) {
+    compressed = get_le32(src);
+    original = get_le32(src + 4);
+  }
+  if (*src_len < LZ4_HEADER_SIZE ||
+      compressed > *src_len - LZ4_HEADER_SIZE || original > *dst_len) {
+    *src_len = *dst_len = 0;
+    return QZ_BUF_ERROR;
+  }
+
+  int n = LZ4_decompress_safe_usingDict(
+      (const char *)src + LZ4_HEADER_SIZE, (char *)dst, (int)compressed,
+      (int)original, (const char *)dict->data, (int)dict->length);
+  if (n < 0 || (unsigned int)n != original) return QZ_FAIL;
+
+  *src_len = compressed + LZ4_HEADER_SIZE;
+  *dst_len = original;
+  return QZ_OK;
+}
+
+int dict_compress(qat_dictionary *dict, unsigned char *src,
+                  unsigned int *src_len, unsigned char *dst,
+                  unsigned int *dst_len) {
+  return dict->algorithm == DICT_DEFLATE
+             ? deflate_compress(dict, src, src_len, dst, dst_len)
+             : lz4_compress(dict, src, src_len, dst, dst_len);
+}
+
+int dict_decompress(qat_dictionary *dict, unsigned char *src,
+                    unsigned int *src_len, unsigned char *dst,
+                    unsigned int *dst_len) {
+  return dict->algorithm == DICT_DEFLATE
+             ? deflate_decompress(dict, src, src_len, dst, dst_len)
+             : lz4_decompress(dict, src, src_len, dst, dst_len);
+}
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+#ifndef DICTIONARY_H_
+#define DICTIONARY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The algorithm of a dictionary, matching com.intel.qat.QatZipper.Algorithm.
+ */
+#define DICT_DEFLATE 0
+#define DICT_LZ4 1
+
+/**
+ * A preset dictionary and the software codec state that uses it. QAT has no
+ * support for preset dictionaries, so compression with a dictionary runs in
+ * software: DEFLATE produces zlib streams through zlib, and LZ4 produces
+ * blocks through liblz4, each preceded by an 8-byte header holding the
+ * compressed and the uncompressed size in little-endian order.
+ */
+typedef struct qat_dictionary qat_dictionary;
+
+/**
+ * Creates a dictionary from a copy of the given data.
+ *
+ * @param algorithm DICT_DEFLATE or DICT_LZ4.
+ * @param level the compression level.
+ * @param data the dictionary content.
+ * @param length the length of the dictionary content.
+ * @return the dictionary, or NULL if it cannot be allocated.
+ */
+qat_dictionary *dict_create(int algorithm, int level,
+                            const unsigned char *data, unsigned int length);
+
+/**
+ * Frees a dictionary created by dict_create.
+ */
+void dict_free(qat_dictionary *dict);
+
+/**
+ * Returns the maximum compressed size of a source of the given size.
+ */
+unsigned int dict_max_compressed_length(qat_dictionary *dict,
+                                        unsigned int src_len);
+
+/**
+ * Compresses a buffer with the dictionary. On return src_len and dst_len hold
+ * the number of bytes read and written.
+ *
+ * @return QZ_OK, or QZ_BUF_ERROR if the destination is too small.
+ */
+int dict_compress(qat_dictionary *dict, unsigned char *src,
+                  unsigned int *src_len, unsigned char *dst,
+                  unsigned int *dst_len);
+
+/**
+ * Decompresses one compressed record with the dictionary. On return src_len
+ * and dst_len hold the number of bytes read and written; both are 0 if the
+ * source holds no complete record or the destination is too small for it.
+ *
+ * @return QZ_OK, QZ_BUF_ERROR if nothing could be decompressed, or QZ_FAIL if
+ * the data is corrupt or was compressed with another dictionary.
+ */
+int dict_decompress(qat_dictionary *dict, unsigned char *src,
+                    unsigned int *src_len, unsigned char *dst,
+                    unsigned int *dst_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,38 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+#ifndef FOREIGN_H_
+#define FOREIGN_H_
+
+#include <jni.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Entry points for the foreign function backend of JDK 22 and later, which
+ * calls them through java.lang.foreign downcall handles on sessions set up by
+ * InternalJNI.setup. They take native memory instead of Java arrays, so no
+ * array is pinned and no JNI environment is needed; the Java side copies heap
+ * data to and from native segments.
+ *
+ * Each returns QZ_OK (0) and stores the bytes read and written, packed as by
+ * the JNI entry points, in result; or returns the QATzip status of the error.
+ */
+JNIEXPORT int qat_java_compress(jlong sess, unsigned char *src, int src_len,
+                                unsigned char *dst, int dst_len,
+                                int retry_count, jlong *result);
+
+JNIEXPORT int qat_java_decompress(jlong sess, unsigned char *src, int src_len,
+                                  unsigned char *dst, int dst_len,
+                                  int retry_count, jlong *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
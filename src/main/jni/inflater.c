@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+#include "inflater.h"
+
+#include <stdlib.h>
+#include <zlib.h>
+
+#include "qatzip.h"
+
+struct qat_inflater {
+  z_stream strm;
+};
+
+qat_inflater *inflater_create(int raw) {
+  qat_inflater *inflater = (qat_inflater *)calloc(1, sizeof(qat_inflater));
+  if (!inflater) return NULL;
+
+  if (inflateInit2(&inflater->strm, raw ? -MAX_WBITS : MAX_WBITS) != Z_OK) {
+    free(inflater);
+    return NULL;
+  }
+  return inflater;
+}
+
+void inflater_free(qat_inflater *inflater) {
+  if (!inflater) return;
+  inflateEnd(&inflater->strm);
+  free(inflater);
+}
+
+int inflater_decompress(qat_inflater *inflater, const unsigned char *src,
+                        unsigned int *src_len, unsigned char *dst,
+                        unsigned int *dst_len) {
+  z_stream *strm = &inflater->strm;
+  unsigned int in = 0;
+  unsigned int out = 0;
+
+  while (in < *src_len) {
+    if (inflateReset(strm) != Z_OK) return QZ_FAIL;
+    strm->next_in = (unsigned char *)src + in;
+    strm->avail_in = *src_len - in;
+    strm->next_out = dst + out;
+    strm->avail_out = *dst_len - out;
+
+    // A stream that does not end within the source or the destination is
+    // left for the next call.
+    int ret = inflate(strm, Z_FINISH);
+    if (ret != Z_STREAM_END) {
+      if (ret == Z_DATA_ERROR || ret == Z_NEED_DICT || ret == Z_MEM_ERROR)
+        return QZ_FAIL;
+      break;
+    }
+    in += (unsigned int)strm->total_in;
+    out += (unsigned int)strm->total_out;
+  }
+
+  *src_len = in;
+  *dst_len = out;
+  return in ? QZ_OK : QZ_BUF_ERROR;
+}
@@ -0,0 +1,50 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+#ifndef INFLATER_H_
+#define INFLATER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A zlib inflater for the DEFLATE formats QATzip cannot decompress: zlib
+ * streams and raw DEFLATE streams. Both lack the member sizes QATzip needs to
+ * split the input into requests, so they are decompressed in software.
+ */
+typedef struct qat_inflater qat_inflater;
+
+/**
+ * Creates an inflater.
+ *
+ * @param raw non-zero for raw DEFLATE streams, zero for zlib streams.
+ * @return the inflater, or NULL if it cannot be allocated.
+ */
+qat_inflater *inflater_create(int raw);
+
+/**
+ * Frees an inflater created by inflater_create.
+ */
+void inflater_free(qat_inflater *inflater);
+
+/**
+ * Decompresses as many complete streams as the source holds and the
+ * destination has room for. On return src_len and dst_len hold the number of
+ * bytes read and written; both are 0 if no stream could be decompressed.
+ *
+ * @return QZ_OK, QZ_BUF_ERROR if nothing could be decompressed, or QZ_FAIL if
+ * the data is corrupt.
+ */
+int inflater_decompress(qat_inflater *inflater, const unsigned char *src,
+                        unsigned int *src_len, unsigned char *dst,
+                        unsigned int *dst_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,196 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+#define _GNU_SOURCE
+#define ZSTD_STATIC_LINKING_ONLY
+
+#include "qat_zstd.h"
+
+#include <stdlib.h>
+
+#include "qatzip.h"
+
+#ifdef HAVE_QAT_ZSTD
+
+#include <pthread.h>
+#include <zstd.h>
+
+#include "qatseqprod.h"
+
+struct qat_zstd {
+  ZSTD_CCtx *cctx;
+  ZSTD_DCtx *dctx;
+  void *seq_prod_state;
+};
+
+// The QAT device is shared by all codecs; it is started on first use.
+static pthread_once_t device_once = PTHREAD_ONCE_INIT;
+static int device_started;
+
+static void start_device(void) {
+  int status = QZSTD_startQatDevice();
+  device_started = status == QZSTD_OK || status == QZSTD_STARTED;
+}
+
+int qat_zstd_create(int level, int sw_backup, qat_zstd **zstd) {
+  pthread_once(&device_once, start_device);
+  if (!device_started && !sw_backup) return QZ_NOSW_NO_HW;
+
+  qat_zstd *z = (qat_zstd *)calloc(1, sizeof(qat_zstd));
+  if (!z) return QZ_LOW_MEM;
+
+  z->cctx = ZSTD_createCCtx();
+  z->dctx = ZSTD_createDCtx();
+  int ok = z->cctx && z->dctx &&
+           !ZSTD_isError(ZSTD_CCtx_setParameter(
+               z->cctx, ZSTD_c_compressionLevel, level));
+
+  if (ok && device_started) {
+    z->seq_prod_state = QZSTD_createSeqProdState();
+    ok = z->seq_prod_state != NULL;
+    if (ok) {
+      ZSTD_registerSequenceProducer(z->cctx, z->seq_prod_state,
+                                    qatSequenceProducer);
+      // Without a fallback, a block the accelerator cannot process fails
+      // the whole call.
+      ok = !ZSTD_isError(ZSTD_CCtx_setParameter(
+          z->cctx, ZSTD_c_enableSeqProducerFallback, sw_backup ? 1 : 0));
+    }
+  }
+
+  if (!ok) {
+    qat_zstd_free(z);
+    return QZ_LOW_MEM;
+  }
+  *zstd = z;
+  return QZ_OK;
+}
+
+void qat_zstd_free(qat_zstd *zstd) {
+  if (!zstd) return;
+  ZSTD_freeCCtx(zstd->cctx);
+  ZSTD_freeDCtx(zstd->dctx);
+  if (zstd->seq_prod_state) QZSTD_freeSeqProdState(zstd->seq_prod_state);
+  free(zstd);
+}
+
+int qat_zstd_hardware(qat_zstd *zstd) { return zstd->seq_prod_state != NULL; }
+
+unsigned int qat_zstd_max_compressed_length(unsigned int src_len) {
+  return (unsigned int)ZSTD_compressBound(src_len);
+}
+
+int qat_zstd_compress(qat_zstd *zstd, const unsigned char *src,
+                      unsigned int *src_len, unsigned char *dst,
+                      unsigned int *dst_len) {
+  size_t n = ZSTD_compress2(zstd->cctx, dst, *dst_len, src, *src_len);
+  if (ZSTD_isError(n)) {
+    // Drop whatever state the failed call left behind.
+    ZSTD_CCtx_reset(zstd->cctx, ZSTD_reset_session_only);
+    return ZSTD_getErrorCode(n) == ZSTD_error_dstSize_tooSmall ? QZ_BUF_ERROR
+                                                                : QZ_FAIL;
+  }
+
+  *dst_len = (unsigned int)n;
+  return QZ_OK;
+}
+
+int qat_zstd_decompress(qat_zstd *zstd, const unsigned char *src,
+                        unsigned int *src_len, unsigned char *dst,
+                        unsigned int *dst_len) {
+  unsigned int in = 0;
+  unsigned int out = 0;
+  int status = QZ_OK;
+
+  while (in < *src_len) {
+    size_t frame = ZSTD_findFrameCompressedSize(src + in, *src_len - in);
+    if (ZSTD_isError(frame)) {
+      if (ZSTD_getErrorCode(frame) != ZSTD_error_srcSize_wrong)
+        status = QZ_FAIL;
+      break;
+    }
+
+    // Frames from qat_zstd_compress record their size; check it first so
+    // that a frame that does not fit is left for the next call.
+    unsigned long long size = ZSTD_getFrameContentSize(src + in, frame);
+    if (size == ZSTD_CONTENTSIZE_ERROR) {
+      status = QZ_FAIL;
+      break;
+    }
+    if (size != ZSTD_CONTENTSIZE_UNKNOWN && size > *dst_len - out) break;
+
+    size_t n = ZSTD_decompressDCtx(zstd->dctx, dst + out, *dst_len - out,
+                                   src + in, frame);
+    if (ZSTD_isError(n)) {
+      if (ZSTD_getErrorCode(n) != ZSTD_error_dstSize_tooSmall)
+        status = QZ_FAIL;
+      break;
+    }
+    in += (unsigned int)frame;
+    out += (unsigned int)n;
+  }
+
+  if (status == QZ_FAIL) return QZ_FAIL;
+  *src_len = in;
+  *dst_len = out;
+  return in ? QZ_OK : QZ_BUF_ERROR;
+}
+
+void qat_zstd_shutdown(void) {
+  if (device_started) QZSTD_stopQatDevice();
+}
+
+int qat_zstd_available(void) { return 1; }
+
+#else
+
+// Built without the QAT-ZSTD plugin: no codec can be created.
+
+int qat_zstd_create(int level, int sw_backup, qat_zstd **zstd) {
+  (void)level;
+  (void)sw_backup;
+  (void)zstd;
+  return QZ_NOT_SUPPORTED;
+}
+
+void qat_zstd_free(qat_zstd *zstd) { (void)zstd; }
+
+int qat_zstd_hardware(qat_zstd *zstd) {
+  (void)zstd;
+  return 0;
+}
+
+unsigned int qat_zstd_max_compressed_length(unsigned int src_len) {
+  return src_len;
+}
+
+int qat_zstd_compress(qat_zstd *zstd, const unsigned char *src,
+                      unsigned int *src_len, unsigned char *dst,
+                      unsigned int *dst_len) {
+  (void)zstd;
+  (void)src;
+  (void)src_len;
+  (void)dst;
+  (void)dst_len;
+  return QZ_NOT_SUPPORTED;
+}
+
+int qat_zstd_decompress(qat_zstd *zstd, const unsigned char *src,
+                        unsigned int *src_len, unsigned char *dst,
+                        unsigned int *dst_len) {
+  (void)zstd;
+  (void)src;
+  (void)src_len;
+  (void)dst;
+  (void)dst_len;
+  return QZ_NOT_SUPPORTED;
+}
+
+void qat_zstd_shutdown(void) {}
+
+int qat_zstd_available(void) { return 0; }
+
+#endif
@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+#ifndef QAT_ZSTD_H_
+#define QAT_ZSTD_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A Zstandard codec whose match finding runs on QAT. The QAT-ZSTD plugin
+ * registers a sequence producer with libzstd: the accelerator finds the
+ * matches and libzstd entropy codes them in software. Decompression runs in
+ * software. Each compress call produces one Zstandard frame.
+ */
+typedef struct qat_zstd qat_zstd;
+
+/**
+ * Creates a codec.
+ *
+ * @param level the compression level.
+ * @param sw_backup if non-zero, compress in software when QAT is unavailable.
+ * @param zstd an out parameter that stores the codec.
+ * @return QZ_OK, QZ_LOW_MEM, or QZ_NOSW_NO_HW if QAT is unavailable and
+ * sw_backup is zero.
+ */
+int qat_zstd_create(int level, int sw_backup, qat_zstd **zstd);
+
+/**
+ * Frees a codec created by qat_zstd_create.
+ */
+void qat_zstd_free(qat_zstd *zstd);
+
+/**
+ * Returns non-zero if the codec finds matches on QAT.
+ */
+int qat_zstd_hardware(qat_zstd *zstd);
+
+/**
+ * Returns the maximum compressed size of a source of the given size.
+ */
+unsigned int qat_zstd_max_compressed_length(unsigned int src_len);
+
+/**
+ * Compresses a buffer into one frame. On return src_len and dst_len hold the
+ * number of bytes read and written.
+ *
+ * @return QZ_OK, QZ_BUF_ERROR if the destination is too small, or QZ_FAIL.
+ */
+int qat_zstd_compress(qat_zstd *zstd, const unsigned char *src,
+                      unsigned int *src_len, unsigned char *dst,
+                      unsigned int *dst_len);
+
+/**
+ * Decompresses as many complete frames as the source holds and the
+ * destination has room for. On return src_len and dst_len hold the number of
+ * bytes read and written; both are 0 if no frame could be decompressed.
+ *
+ * @return QZ_OK, QZ_BUF_ERROR if nothing could be decompressed, or QZ_FAIL if
+ * the data is corrupt.
+ */
+int qat_zstd_decompress(qat_zstd *zstd, const unsigned char *src,
+                        unsigned int *src_len, unsigned char *dst,
+                        unsigned int *dst_len);
+
+/**
+ * Releases the QAT device if a codec started it.
+ */
+void qat_zstd_shutdown(void);
+
+/**
+ * Returns non-zero if the library was built with the QAT-ZSTD plugin. Without
+ * it, qat_zstd_create fails with QZ_NOT_SUPPORTED.
+ */
+int qat_zstd_available(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
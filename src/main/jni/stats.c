@@ -0,0 +1,74 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include "stats.h"
+
+#include <time.h>
+
+qat_stats global_stats;
+
+atomic_int stats_enabled;
+
+const int stats_error_codes[STATS_ERROR_CODES] = {
+    -1,   -2,   -3,   -4,   -5,   -100, 11,   12,   13,   14,   15,
+    16,   -101, -102, -103, -104, -105, -116, -117, -118, -119, -200};
+
+long long stats_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * Adds the given value to a counter of the session and to the same global
+ * counter.
+ */
+static void add(qat_stats *stats, int counter, long long value) {
+  atomic_fetch_add_explicit(&stats->counters[counter], value,
+                            memory_order_relaxed);
+  atomic_fetch_add_explicit(&global_stats.counters[counter], value,
+                            memory_order_relaxed);
+}
+
+void stats_record(qat_stats *stats, int decompress, int status,
+                  unsigned int bytes_in, unsigned int bytes_out, int retries,
+                  int hw, long long nanos) {
+  int base = decompress ? STATS_DECOMPRESS_CALLS : STATS_COMPRESS_CALLS;
+  add(stats, base, 1);
+  add(stats, hw ? STATS_HW_CALLS : STATS_SW_CALLS, 1);
+  if (retries > 0) add(stats, STATS_RETRIES, retries);
+
+  if (status != 0) {
+    add(stats, STATS_ERRORS, 1);
+    for (int i = 0; i < STATS_ERROR_CODES; i++) {
+      if (stats_error_codes[i] == status) {
+        add(stats, STATS_ERROR_COUNTS + i, 1);
+        break;
+      }
+    }
+    return;
+  }
+
+  add(stats, base + 1, bytes_in);
+  add(stats, base + 2, bytes_out);
+
+  int bucket = 0;
+  if (nanos > 1) bucket = 63 - __builtin_clzll((unsigned long long)nanos);
+  if (bucket >= STATS_LATENCY_BUCKETS) bucket = STATS_LATENCY_BUCKETS - 1;
+  add(stats, STATS_LATENCY + bucket, 1);
+}
+
+void stats_snapshot(qat_stats *stats, long long *out) {
+  for (int i = 0; i < STATS_LENGTH; i++)
+    out[i] =
+        atomic_load_explicit(&stats->counters[i], memory_order_relaxed);
+}
+
+void stats_reset(qat_stats *stats) {
+  for (int i = 0; i < STATS_LENGTH; i++)
+    atomic_store_explicit(&stats->counters[i], 0, memory_order_relaxed);
+}
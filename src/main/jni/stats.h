@@ -0,0 +1,104 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+#ifndef STATS_H_
+#define STATS_H_
+
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The number of latency histogram buckets. Bucket i counts calls that took
+ * [2^i, 2^(i+1)) nanoseconds; the last bucket also counts slower calls.
+ */
+#define STATS_LATENCY_BUCKETS 32
+
+/**
+ * The number of QATzip status codes counted individually.
+ */
+#define STATS_ERROR_CODES 22
+
+/**
+ * The layout of a counter array, mirrored by com.intel.qat.QatStats.
+ */
+enum {
+  STATS_COMPRESS_CALLS,
+  STATS_COMPRESS_BYTES_IN,
+  STATS_COMPRESS_BYTES_OUT,
+  STATS_DECOMPRESS_CALLS,
+  STATS_DECOMPRESS_BYTES_IN,
+  STATS_DECOMPRESS_BYTES_OUT,
+  STATS_HW_CALLS,
+  STATS_SW_CALLS,
+  STATS_RETRIES,
+  STATS_ERRORS,
+  STATS_LATENCY,
+  STATS_ERROR_COUNTS = STATS_LATENCY + STATS_LATENCY_BUCKETS,
+  STATS_LENGTH = STATS_ERROR_COUNTS + STATS_ERROR_CODES
+};
+
+/**
+ * A set of counters, updated with relaxed atomic operations.
+ */
+typedef struct {
+  atomic_llong counters[STATS_LENGTH];
+} qat_stats;
+
+/**
+ * The counters of all sessions.
+ */
+extern qat_stats global_stats;
+
+/**
+ * Non-zero if counters are updated.
+ */
+extern atomic_int stats_enabled;
+
+/**
+ * The QATzip status codes counted individually, in counter order.
+ */
+extern const int stats_error_codes[STATS_ERROR_CODES];
+
+/**
+ * Returns the current monotonic time in nanoseconds.
+ */
+long long stats_now(void);
+
+/**
+ * Records a compress or decompress call in the given session counters and in
+ * the global counters.
+ *
+ * @param stats the counters of the session.
+ * @param decompress zero for a compress call, non-zero for a decompress call.
+ * @param status the status the call ended with.
+ * @param bytes_in the number of bytes read from the source.
+ * @param bytes_out the number of bytes written to the destination.
+ * @param retries the number of retries the call made.
+ * @param hw non-zero if the session runs on hardware.
+ * @param nanos the duration of the call.
+ */
+void stats_record(qat_stats *stats, int decompress, int status,
+                  unsigned int bytes_in, unsigned int bytes_out, int retries,
+                  int hw, long long nanos);
+
+/**
+ * Copies the given counters into an array of STATS_LENGTH elements.
+ */
+void stats_snapshot(qat_stats *stats, long long *out);
+
+/**
+ * Resets the given counters to zero.
+ */
+void stats_reset(qat_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,44 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+/**
+ * Tracepoints that mark the phases of a compress or decompress call: pin,
+ * before the source and destination are pinned or their addresses looked up;
+ * submit, before the request is handed to the codec; complete, when the codec
+ * returns; and unpin, after the buffers are released. The time between pin and
+ * submit is JNI overhead, between submit and complete the codec itself.
+ *
+ * Built with ENABLE_USDT, they are USDT probes of the qat_java provider that
+ * perf and bpftrace attach to, for example
+ * usdt:libqat-java.so:qat_java:submit. Every probe passes the session and the
+ * operation (0 compress, 1 decompress); submit also passes the source length
+ * and complete the status. Otherwise they compile to nothing.
+ */
+#define TRACE_COMPRESS 0
+#define TRACE_DECOMPRESS 1
+
+#ifdef HAVE_USDT
+#include <sys/sdt.h>
+
+#define TRACE_PIN(sess, op) DTRACE_PROBE2(qat_java, pin, sess, op)
+#define TRACE_SUBMIT(sess, op, src_len) \
+  DTRACE_PROBE3(qat_java, submit, sess, op, src_len)
+#define TRACE_COMPLETE(sess, op, status) \
+  DTRACE_PROBE3(qat_java, complete, sess, op, status)
+#define TRACE_UNPIN(sess, op) DTRACE_PROBE2(qat_java, unpin, sess, op)
+#else
+#define TRACE_PIN(sess, op) ((void)(sess), (void)(op))
+#define TRACE_SUBMIT(sess, op, src_len) \
+  ((void)(sess), (void)(op), (void)(src_len))
+#define TRACE_COMPLETE(sess, op, status) \
+  ((void)(sess), (void)(op), (void)(status))
+#define TRACE_UNPIN(sess, op) ((void)(sess), (void)(op))
+#endif
+
+#endif
@@ -5,7 +5,7 @@
  ******************************************************************************/
 #include "util.h"
 
-#include <stdio.h>
+#include <string.h>
 
 /**
  * Gets the QAT string for the given error code.
@@ -73,7 +73,54 @@ static char *get_error_msg(int err_code) {
 }
 
 /**
- * Throws a QatException with the given error code and message.
+ * A global reference to com.intel.qat.QatException and its (String, int)
+ * constructor.
+ */
+static jclass qat_exception_class;
+static jmethodID qat_exception_init;
+
+/**
+ * Caches the classes used by throw_exception. Called from JNI_OnLoad.
+ *
+ * @param env a pointer to the JNI environment.
+ * @return 0 if successful, -1 otherwise.
+ */
+int init_exceptions(JNIEnv *env) {
+  jclass clz = (*env)->FindClass(env, "com/intel/qat/QatException");
+  if (!clz) return -1;
+  qat_exception_init =
+      (*env)->GetMethodID(env, clz, "<init>", "(Ljava/lang/String;I)V");
+  qat_exception_class = (jclass)(*env)->NewGlobalRef(env, clz);
+  (*env)->DeleteLocalRef(env, clz);
+  return qat_exception_class && qat_exception_init ? 0 : -1;
+}
+
+/**
+ * Releases the classes cached by init_exceptions. Called from JNI_OnUnload.
+ *
+ * @param env a pointer to the JNI environment.
+ */
+void release_exceptions(JNIEnv *env) {
+  if (qat_exception_class) (*env)->DeleteGlobalRef(env, qat_exception_class);
+  qat_exception_class = NULL;
+}
+
+/**
+ * Appends a string to a buffer, truncating it to fit.
+ *
+ * @return the new length of the buffer's contents.
+ */
+static size_t append(char *buff, size_t len, size_t size, const char *str) {
+  size_t n = strlen(str);
+  if (n > size - 1 - len) n = size - 1 - len;
+  memcpy(buff + len, str, n);
+  buff[len + n] = '\0';
+  return len + n;
+}
+
+/**
+ * Throws a QatException with the given error code and message. The code is
+ * also available from QatException.getErrorCode().
  *
  * @param env a pointer to the JNI environment.
  * @param err_code the error code for this exception.
@@ -82,7 +129,14 @@ static char *get_error_msg(int err_code) {
  */
 void throw_exception(JNIEnv *env, jlong err_code, const char *err_msg) {
   char buff[256];
-  jclass Exception = (*env)->FindClass(env, "com/intel/qat/QatException");
-  snprintf(buff, sizeof(buff), "%s: %s", get_error_msg(err_code), err_msg);
-  (*env)->ThrowNew(env, Exception, buff);
+  size_t len = append(buff, 0, sizeof(buff), get_error_msg(err_code));
+  len = append(buff, len, sizeof(buff), ": ");
+  append(buff, len, sizeof(buff), err_msg);
+
+  jstring message = (*env)->NewStringUTF(env, buff);
+  if (!message) return;
+  jthrowable exception = (jthrowable)(*env)->NewObject(
+      env, qat_exception_class, qat_exception_init, message, (jint)err_code);
+  if (exception) (*env)->Throw(env, exception);
+  (*env)->DeleteLocalRef(env, message);
 }
@@ -15,6 +15,10 @@ extern "C" {
 
 void throw_exception(JNIEnv *env, jlong err_code, const char *msg);
 
+int init_exceptions(JNIEnv *env);
+
+void release_exceptions(JNIEnv *env);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,108 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Format;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+
+import java.io.ByteArrayInputStream;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.Arrays;
+import java.util.Random;
+import java.util.zip.DataFormatException;
+import java.util.zip.GZIPInputStream;
+import java.util.zip.Inflater;
+import org.junit.jupiter.api.Test;
+import org.junit.jupiter.params.ParameterizedTest;
+import org.junit.jupiter.params.provider.EnumSource;
+import org.junit.jupiter.params.provider.ValueSource;
+
+public class QatAdaptiveTests {
+  private static final String SAMPLE_TEXT_PATH = "src/test/resources/sample.txt";
+
+  private static byte[] random(int len) {
+    byte[] bytes = new byte[len];
+    new Random(len).nextBytes(bytes);
+    return bytes;
+  }
+
+  @Test
+  public void testEntropy() throws IOException {
+    assertEquals(0.0, QatAdaptive.entropy(ByteBuffer.allocate(8192)), 1e-9);
+    assertTrue(QatAdaptive.entropy(ByteBuffer.wrap(random(8192))) > 7.9);
+
+    byte[] text = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+    assertTrue(QatAdaptive.entropy(ByteBuffer.wrap(text)) < QatAdaptive.FAST_ENTROPY);
+  }
+
+  @Test
+  public void testEntropyKeepsPosition() {
+    ByteBuffer buf = ByteBuffer.wrap(random(100));
+    buf.position(10);
+    QatAdaptive.entropy(buf);
+    assertEquals(10, buf.position());
+    assertEquals(100, buf.limit());
+  }
+
+  @ParameterizedTest
+  @ValueSource(ints = {1, 65535, 65536, 200_000})
+  public void testStoredGzip(int len) throws IOException {
+    byte[] src = random(len);
+    for (Format format : new Format[] {Format.GZIP_EXT, Format.GZIP}) {
+      byte[] stored = store(format, src);
+      try (GZIPInputStream in = new GZIPInputStream(new ByteArrayInputStream(stored))) {
+        assertTrue(Arrays.equals(src, in.readAllBytes()));
+      }
+    }
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Format.class, names = {"ZLIB", "RAW"})
+  public void testStoredInflater(Format format) throws DataFormatException {
+    byte[] src = random(200_000);
+    byte[] stored = store(format, src);
+    Inflater inflater = new Inflater(format == Format.RAW);
+    try {
+      inflater.setInput(stored);
+      byte[] dec = new byte[src.length];
+      assertEquals(src.length, inflater.inflate(dec));
+      assertTrue(inflater.finished());
+      assertEquals(0, inflater.getRemaining());
+      assertTrue(Arrays.equals(src, dec));
+    } finally {
+      inflater.end();
+    }
+  }
+
+  @Test
+  public void testStoredGzipExtHeader() {
+    byte[] src = random(1000);
+    ByteBuffer stored = ByteBuffer.wrap(store(Format.GZIP_EXT, src));
+    // The QZ extra field holds the source and compressed sizes of the member.
+    assertEquals('Q', stored.get(12));
+    assertEquals('Z', stored.get(13));
+    stored.order(ByteOrder.LITTLE_ENDIAN);
+    assertEquals(src.length, stored.getInt(16));
+    assertEquals(src.length + 5, stored.getInt(20));
+  }
+
+  /** Stores the source, checking the size against {@link QatAdaptive#storedLength}. */
+  private static byte[] store(Format format, byte[] src) {
+    int len = (int) QatAdaptive.storedLength(format, src.length);
+    ByteBuffer dst = ByteBuffer.allocate(len + 16);
+    ByteBuffer in = ByteBuffer.wrap(src);
+    assertEquals(len, QatAdaptive.writeStored(format, 6, in, dst));
+    assertEquals(src.length, in.position());
+    assertEquals(len, dst.position());
+    return Arrays.copyOf(dst.array(), len);
+  }
+}
@@ -0,0 +1,153 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+import static org.junit.jupiter.api.Assertions.fail;
+import static org.junit.jupiter.api.Assumptions.assumeTrue;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.Arrays;
+import java.util.stream.Stream;
+import org.junit.jupiter.api.AfterEach;
+import org.junit.jupiter.api.Test;
+import org.junit.jupiter.params.ParameterizedTest;
+import org.junit.jupiter.params.provider.Arguments;
+import org.junit.jupiter.params.provider.MethodSource;
+
+public class QatBufferAllocatorTests {
+  private static final String SAMPLE_TEXT_PATH = "src/test/resources/sample.txt";
+
+  public static Stream<Arguments> provideModeAlgorithmParams() {
+    return QatTestSuite.FORCE_HARDWARE
+        ? Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE),
+            Arguments.of(Mode.AUTO, Algorithm.LZ4),
+            Arguments.of(Mode.HARDWARE, Algorithm.DEFLATE),
+            Arguments.of(Mode.HARDWARE, Algorithm.LZ4))
+        : Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE), Arguments.of(Mode.AUTO, Algorithm.LZ4));
+  }
+
+  @AfterEach
+  public void resetAllocator() {
+    QatBufferAllocator.setMaxPooledBytes(QatBufferAllocator.DEFAULT_MAX_POOLED_BYTES);
+    QatBufferAllocator.clear();
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testCompressDecompress(Mode mode, Algorithm algo) {
+    try {
+      QatZipper qzip = new QatZipper(algo, mode);
+      byte[] data = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+
+      ByteBuffer src = QatBufferAllocator.allocate(data.length);
+      ByteBuffer dst = QatBufferAllocator.allocate(qzip.maxCompressedLength(data.length));
+      ByteBuffer dec = QatBufferAllocator.allocate(data.length);
+      src.put(data).flip();
+
+      qzip.compress(src, dst);
+      dst.flip();
+      qzip.decompress(dst, dec);
+      qzip.end();
+
+      byte[] result = new byte[data.length];
+      dec.flip().get(result);
+      assertTrue(Arrays.equals(data, result));
+
+      QatBufferAllocator.release(src);
+      QatBufferAllocator.release(dst);
+      QatBufferAllocator.release(dec);
+    } catch (QatException | IOException e) {
+      fail(e.getMessage());
+    }
+  }
+
+  @Test
+  public void testExactCapacity() {
+    ByteBuffer buf = QatBufferAllocator.allocate(5000);
+    assertTrue(buf.isDirect());
+    assertEquals(5000, buf.capacity());
+    assertEquals(0, buf.position());
+    assertEquals(5000, buf.limit());
+    QatBufferAllocator.release(buf);
+  }
+
+  @Test
+  public void testReleaseReusesMemory() {
+    ByteBuffer buf = QatBufferAllocator.allocate(5000);
+    QatBufferAllocator.release(buf);
+    assertEquals(1, QatBufferAllocator.pooledCount(8192));
+
+    ByteBuffer reused = QatBufferAllocator.allocate(8000);
+    assertEquals(0, QatBufferAllocator.pooledCount(8192));
+    assertEquals(8000, reused.capacity());
+    QatBufferAllocator.release(reused);
+  }
+
+  @Test
+  public void testMaxPooledBytes() {
+    QatBufferAllocator.setMaxPooledBytes(4096);
+    ByteBuffer first = QatBufferAllocator.allocate(4096);
+    ByteBuffer second = QatBufferAllocator.allocate(4096);
+    QatBufferAllocator.release(first);
+    QatBufferAllocator.release(second);
+    assertEquals(1, QatBufferAllocator.pooledCount(4096));
+    assertEquals(4096, QatBufferAllocator.pooledBytes());
+  }
+
+  @Test
+  public void testLargeBufferNotPooled() {
+    ByteBuffer buf = QatBufferAllocator.allocate(QatBufferAllocator.MAX_SIZE_CLASS + 1);
+    assertEquals(QatBufferAllocator.MAX_SIZE_CLASS + 1, buf.capacity());
+    QatBufferAllocator.release(buf);
+    assertEquals(0, QatBufferAllocator.pooledBytes());
+  }
+
+  @Test
+  public void testPinned() {
+    ByteBuffer buf;
+    try {
+      buf = QatBufferAllocator.allocate(4096, true);
+    } catch (QatException e) {
+      assumeTrue(false, "No pinned memory available.");
+      return;
+    }
+    assertTrue(buf.isDirect());
+    QatBufferAllocator.release(buf);
+    assertEquals(1, QatBufferAllocator.pooledCount(4096));
+  }
+
+  @Test
+  public void testDoubleRelease() {
+    ByteBuffer buf = QatBufferAllocator.allocate(4096);
+    QatBufferAllocator.release(buf);
+    assertThrows(IllegalArgumentException.class, () -> QatBufferAllocator.release(buf));
+  }
+
+  @Test
+  public void testReleaseForeignBuffer() {
+    assertThrows(
+        IllegalArgumentException.class,
+        () -> QatBufferAllocator.release(ByteBuffer.allocateDirect(4096)));
+    assertThrows(
+        IllegalArgumentException.class, () -> QatBufferAllocator.release(ByteBuffer.allocate(16)));
+  }
+
+  @Test
+  public void testNegativeCapacity() {
+    assertThrows(IllegalArgumentException.class, () -> QatBufferAllocator.allocate(-1));
+  }
+}
@@ -0,0 +1,134 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertFalse;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+
+import java.io.ByteArrayOutputStream;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.channels.Channels;
+import java.nio.channels.ClosedChannelException;
+import java.nio.channels.FileChannel;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.nio.file.StandardOpenOption;
+import java.util.Arrays;
+import java.util.Random;
+import java.util.stream.Stream;
+import org.junit.jupiter.api.BeforeAll;
+import org.junit.jupiter.api.Test;
+import org.junit.jupiter.api.io.TempDir;
+import org.junit.jupiter.params.ParameterizedTest;
+import org.junit.jupiter.params.provider.Arguments;
+import org.junit.jupiter.params.provider.MethodSource;
+
+public class QatCompressorChannelTests {
+  private static final String SAMPLE_TEXT_PATH = "src/test/resources/sample.txt";
+  private static byte[] src;
+
+  private Random rnd = new Random();
+
+  @TempDir Path tempDir;
+
+  @BeforeAll
+  public static void setup() throws IOException {
+    src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+  }
+
+  public static Stream<Arguments> provideModeAlgorithmLengthParams() {
+    return QatTestSuite.FORCE_HARDWARE
+        ? Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE, 16384),
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE, 524288),
+            Arguments.of(Mode.AUTO, Algorithm.LZ4, 16384),
+            Arguments.of(Mode.AUTO, Algorithm.LZ4, 524288),
+            Arguments.of(Mode.HARDWARE, Algorithm.DEFLATE, 16384),
+            Arguments.of(Mode.HARDWARE, Algorithm.DEFLATE, 524288),
+            Arguments.of(Mode.HARDWARE, Algorithm.LZ4, 16384),
+            Arguments.of(Mode.HARDWARE, Algorithm.LZ4, 524288))
+        : Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE, 16384),
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE, 524288),
+            Arguments.of(Mode.AUTO, Algorithm.LZ4, 16384),
+            Arguments.of(Mode.AUTO, Algorithm.LZ4, 524288));
+  }
+
+  private static byte[] decompress(Algorithm algo, Mode mode, byte[] compressed) {
+    QatZipper qzip = new QatZipper(algo, mode);
+    byte[] result = new byte[src.length];
+    qzip.decompress(compressed, 0, compressed.length, result, 0, result.length);
+    qzip.end();
+    return result;
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmLengthParams")
+  public void testWriteHeapBuffers(Mode mode, Algorithm algo, int size) throws IOException {
+    ByteArrayOutputStream outputStream = new ByteArrayOutputStream();
+    try (QatCompressorChannel channel =
+        new QatCompressorChannel(
+            Channels.newChannel(outputStream),
+            size,
+            algo,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            mode,
+            PollingMode.BUSY)) {
+      int len = 0;
+      for (int i = 0; i < src.length; i += len) {
+        len = Math.min(rnd.nextInt(20 * 1024), src.length - i);
+        assertEquals(len, channel.write(ByteBuffer.wrap(src, i, len)));
+      }
+    }
+    assertTrue(Arrays.equals(src, decompress(algo, mode, outputStream.toByteArray())));
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmLengthParams")
+  public void testWriteDirectBufferToFile(Mode mode, Algorithm algo, int size)
+      throws IOException {
+    Path file = tempDir.resolve("sample.qat");
+    ByteBuffer direct = ByteBuffer.allocateDirect(src.length);
+    direct.put(src).flip();
+    try (QatCompressorChannel channel =
+        new QatCompressorChannel(
+            FileChannel.open(file, StandardOpenOption.CREATE, StandardOpenOption.WRITE),
+            size,
+            algo,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            mode,
+            PollingMode.BUSY)) {
+      channel.write(direct);
+      assertFalse(direct.hasRemaining());
+    }
+    assertTrue(Arrays.equals(src, decompress(algo, mode, Files.readAllBytes(file))));
+  }
+
+  @Test
+  public void testWriteAfterClose() throws IOException {
+    QatCompressorChannel channel =
+        new QatCompressorChannel(Channels.newChannel(new ByteArrayOutputStream()));
+    channel.close();
+    assertFalse(channel.isOpen());
+    assertThrows(ClosedChannelException.class, () -> channel.write(ByteBuffer.wrap(src)));
+    channel.close();
+  }
+
+  @Test
+  public void testBadBufferSize() {
+    assertThrows(
+        IllegalArgumentException.class,
+        () -> new QatCompressorChannel(Channels.newChannel(new ByteArrayOutputStream()), 0));
+  }
+}
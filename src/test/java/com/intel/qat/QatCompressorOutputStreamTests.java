@@ -7,20 +7,28 @@
 package com.intel.qat;
 
 import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Format;
 import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
 import static org.junit.jupiter.api.Assertions.assertEquals;
 import static org.junit.jupiter.api.Assertions.assertFalse;
+import static org.junit.jupiter.api.Assertions.assertThrows;
 import static org.junit.jupiter.api.Assertions.assertTrue;
 import static org.junit.jupiter.api.Assertions.fail;
 import static org.junit.jupiter.api.Assumptions.assumeTrue;
 
+import java.io.ByteArrayInputStream;
 import java.io.ByteArrayOutputStream;
 import java.io.IOException;
+import java.io.OutputStream;
 import java.nio.file.Files;
 import java.nio.file.Paths;
 import java.util.Arrays;
 import java.util.Random;
 import java.util.stream.Stream;
+import java.util.zip.DataFormatException;
+import java.util.zip.GZIPInputStream;
+import java.util.zip.Inflater;
 import org.junit.jupiter.api.AfterEach;
 import org.junit.jupiter.api.BeforeAll;
 import org.junit.jupiter.api.Test;
@@ -150,6 +158,7 @@ public class QatCompressorOutputStreamTests {
   @EnumSource(Algorithm.class)
   public void testOutputStreamConstructor1(Algorithm algo) throws IOException {
     assumeTrue(QatTestSuite.FORCE_HARDWARE);
+    assumeTrue(QatZipper.isSupported(algo));
     ByteArrayOutputStream outputStream = new ByteArrayOutputStream();
     try {
       try (QatCompressorOutputStream compressedStream =
@@ -437,4 +446,188 @@ public class QatCompressorOutputStreamTests {
       }
     }
   }
+
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmLengthParams")
+  public void testOutputStreamPipelined(Mode mode, Algorithm algo, int size) throws IOException {
+    qzip = new QatZipper(algo, mode);
+    ByteArrayOutputStream outputStream = new ByteArrayOutputStream();
+    try (QatCompressorOutputStream compressedStream =
+        new QatCompressorOutputStream(
+            outputStream,
+            size,
+            algo,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            mode,
+            PollingMode.BUSY,
+            3)) {
+      int i;
+      int len = 0;
+      for (i = 0; i < src.length; i += len) {
+        if (i > 0 && i % 10 == 0) { // doFlush
+          compressedStream.flush();
+        }
+        len = Math.min(rnd.nextInt(20 * 1024), src.length - i);
+        compressedStream.write(src, i, len);
+      }
+      assertEquals(src.length, i);
+    }
+    byte[] outputStreamBuf = outputStream.toByteArray();
+    byte[] result = new byte[src.length];
+    qzip.decompress(outputStreamBuf, 0, outputStreamBuf.length, result, 0, result.length);
+
+    assertTrue(Arrays.equals(src, result));
+  }
+
+  @Test
+  public void testOutputStreamPipelinedWriteFailure() throws IOException {
+    OutputStream failing =
+        new OutputStream() {
+          @Override
+          public void write(int b) throws IOException {
+            throw new IOException("downstream failure");
+          }
+        };
+    QatCompressorOutputStream compressedStream =
+        new QatCompressorOutputStream(
+            failing,
+            1024,
+            Algorithm.DEFLATE,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            QatZipper.DEFAULT_MODE,
+            PollingMode.BUSY,
+            2);
+    assertThrows(
+        IOException.class,
+        () -> {
+          for (int i = 0; i < 8; i++) compressedStream.write(src, 0, 1024);
+          compressedStream.flush();
+        });
+    assertThrows(IOException.class, () -> compressedStream.close());
+  }
+
+  @Test
+  public void testOutputStreamGzipFormat() throws IOException {
+    ByteArrayOutputStream outputStream = new ByteArrayOutputStream();
+    try (QatCompressorOutputStream compressedStream =
+        new QatCompressorOutputStream(
+            outputStream,
+            16 * 1024,
+            Format.GZIP,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            Mode.AUTO,
+            PollingMode.BUSY)) {
+      compressedStream.write(src);
+    }
+
+    // The members of a standard gzip stream are read by any gzip decoder as one file.
+    try (GZIPInputStream in =
+        new GZIPInputStream(new ByteArrayInputStream(outputStream.toByteArray()))) {
+      assertTrue(Arrays.equals(src, in.readAllBytes()));
+    }
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Format.class, names = {"ZLIB", "RAW"})
+  public void testOutputStreamUnsupportedFormat(Format format) {
+    assertThrows(
+        IllegalArgumentException.class,
+        () ->
+            new QatCompressorOutputStream(
+                new ByteArrayOutputStream(),
+                16 * 1024,
+                format,
+                QatZipper.DEFAULT_COMPRESS_LEVEL,
+                Mode.AUTO,
+                PollingMode.BUSY));
+  }
+
+  @Test
+  public void testOutputStreamAdaptive() throws IOException {
+    byte[] random = new byte[256 * 1024];
+    rnd.nextBytes(random);
+    ByteArrayOutputStream outputStream = new ByteArrayOutputStream();
+    try (QatCompressorOutputStream compressedStream =
+        new QatCompressorOutputStream(
+            outputStream,
+            16 * 1024,
+            Algorithm.DEFLATE,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            Mode.AUTO,
+            PollingMode.BUSY,
+            1)) {
+      compressedStream.setAdaptive(true);
+      assertTrue(compressedStream.isAdaptive());
+      compressedStream.write(random);
+      compressedStream.write(src);
+    }
+
+    // Stored and compressed members alike are read by any gzip decoder.
+    try (GZIPInputStream in =
+        new GZIPInputStream(new ByteArrayInputStream(outputStream.toByteArray()))) {
+      assertTrue(Arrays.equals(random, in.readNBytes(random.length)));
+      assertTrue(Arrays.equals(src, in.readAllBytes()));
+    }
+  }
+
+  @Test
+  public void testOutputStreamSyncFlush() throws IOException, DataFormatException {
+    ByteArrayOutputStream syncOutput = new ByteArrayOutputStream();
+    ByteArrayOutputStream memberOutput = new ByteArrayOutputStream();
+    ByteArrayOutputStream written = new ByteArrayOutputStream();
+    try (QatCompressorOutputStream syncStream =
+            new QatCompressorOutputStream(
+                syncOutput, 16 * 1024, Format.GZIP, QatZipper.DEFAULT_COMPRESS_LEVEL, true);
+        QatCompressorOutputStream memberStream =
+            new QatCompressorOutputStream(
+                memberOutput, 16 * 1024, Format.GZIP, QatZipper.DEFAULT_COMPRESS_LEVEL, false)) {
+      assertFalse(syncStream.isAdaptive());
+      assertThrows(IllegalStateException.class, () -> syncStream.setAdaptive(true));
+      for (int off = 0; off < src.length; off += 100) {
+        int len = Math.min(100, src.length - off);
+        syncStream.write(src, off, len);
+        syncStream.flush();
+        memberStream.write(src, off, len);
+        memberStream.flush();
+        written.write(src, off, len);
+
+        // Everything written before a flush can be decoded from the single member so far.
+        byte[] sofar = syncOutput.toByteArray();
+        Inflater inflater = new Inflater(true);
+        inflater.setInput(sofar, 10, sofar.length - 10);
+        byte[] decoded = new byte[written.size()];
+        int n = 0;
+        while (n < decoded.length && !inflater.needsInput())
+          n += inflater.inflate(decoded, n, decoded.length - n);
+        inflater.end();
+        assertTrue(Arrays.equals(written.toByteArray(), Arrays.copyOf(decoded, n)));
+      }
+    }
+
+    // Keeping the history across flushes beats starting a new member at each flush.
+    assertTrue(syncOutput.size() < memberOutput.size());
+    try (GZIPInputStream in =
+        new GZIPInputStream(new ByteArrayInputStream(syncOutput.toByteArray()))) {
+      assertTrue(Arrays.equals(src, in.readAllBytes()));
+    }
+  }
+
+  @Test
+  public void testOutputStreamSyncFlushEmpty() throws IOException {
+    ByteArrayOutputStream outputStream = new ByteArrayOutputStream();
+    new QatCompressorOutputStream(outputStream, 1024, Format.GZIP, 6, true).close();
+    try (GZIPInputStream in =
+        new GZIPInputStream(new ByteArrayInputStream(outputStream.toByteArray()))) {
+      assertEquals(0, in.readAllBytes().length);
+    }
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Format.class, names = {"GZIP_EXT", "ZLIB", "RAW"})
+  public void testOutputStreamSyncFlushUnsupportedFormat(Format format) {
+    assertThrows(
+        IllegalArgumentException.class,
+        () -> new QatCompressorOutputStream(new ByteArrayOutputStream(), 1024, format, 6, true));
+  }
 }
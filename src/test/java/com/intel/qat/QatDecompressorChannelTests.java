@@ -0,0 +1,143 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+
+import java.io.ByteArrayInputStream;
+import java.io.ByteArrayOutputStream;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.channels.Channels;
+import java.nio.channels.ClosedChannelException;
+import java.nio.channels.FileChannel;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.Arrays;
+import java.util.stream.Stream;
+import org.junit.jupiter.api.BeforeAll;
+import org.junit.jupiter.api.Test;
+import org.junit.jupiter.api.io.TempDir;
+import org.junit.jupiter.params.ParameterizedTest;
+import org.junit.jupiter.params.provider.Arguments;
+import org.junit.jupiter.params.provider.MethodSource;
+
+public class QatDecompressorChannelTests {
+  private static final String SAMPLE_TEXT_PATH = "src/test/resources/sample.txt";
+  private static byte[] src;
+  private static byte[] deflateBytes;
+  private static byte[] lz4Bytes;
+
+  @TempDir Path tempDir;
+
+  @BeforeAll
+  public static void setup() throws IOException {
+    src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+    ByteArrayOutputStream outputStream = new ByteArrayOutputStream();
+    try (QatCompressorOutputStream compressedStream =
+        new QatCompressorOutputStream(outputStream, 16 * 1024, Algorithm.LZ4, Mode.AUTO)) {
+      compressedStream.write(src);
+    }
+    lz4Bytes = outputStream.toByteArray();
+    ByteArrayOutputStream outputStream2 = new ByteArrayOutputStream();
+    try (QatCompressorOutputStream compressedStream =
+        new QatCompressorOutputStream(outputStream2, 16 * 1024, Algorithm.DEFLATE, Mode.AUTO)) {
+      compressedStream.write(src);
+    }
+    deflateBytes = outputStream2.toByteArray();
+  }
+
+  public static Stream<Arguments> provideModeAlgorithmLengthParams() {
+    return QatTestSuite.FORCE_HARDWARE
+        ? Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE, 16384),
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE, 524288),
+            Arguments.of(Mode.AUTO, Algorithm.LZ4, 16384),
+            Arguments.of(Mode.AUTO, Algorithm.LZ4, 524288),
+            Arguments.of(Mode.HARDWARE, Algorithm.DEFLATE, 16384),
+            Arguments.of(Mode.HARDWARE, Algorithm.DEFLATE, 524288),
+            Arguments.of(Mode.HARDWARE, Algorithm.LZ4, 16384),
+            Arguments.of(Mode.HARDWARE, Algorithm.LZ4, 524288))
+        : Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE, 16384),
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE, 524288),
+            Arguments.of(Mode.AUTO, Algorithm.LZ4, 16384),
+            Arguments.of(Mode.AUTO, Algorithm.LZ4, 524288));
+  }
+
+  private static byte[] compressed(Algorithm algo) {
+    return algo.equals(Algorithm.LZ4) ? lz4Bytes : deflateBytes;
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmLengthParams")
+  public void testReadHeapBuffer(Mode mode, Algorithm algo, int size) throws IOException {
+    ByteBuffer result = ByteBuffer.allocate(src.length);
+    try (QatDecompressorChannel channel =
+        new QatDecompressorChannel(
+            Channels.newChannel(new ByteArrayInputStream(compressed(algo))),
+            size,
+            algo,
+            mode,
+            PollingMode.BUSY)) {
+      ByteBuffer chunk = ByteBuffer.allocate(1000);
+      while (channel.read(chunk) >= 0) {
+        chunk.flip();
+        result.put(chunk);
+        chunk.clear();
+      }
+    }
+    assertEquals(src.length, result.position());
+    assertTrue(Arrays.equals(src, result.array()));
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmLengthParams")
+  public void testReadFileIntoDirectBuffer(Mode mode, Algorithm algo, int size)
+      throws IOException {
+    Path file = tempDir.resolve("sample.qat");
+    Files.write(file, compressed(algo));
+    ByteBuffer result = ByteBuffer.allocateDirect(src.length + size);
+    try (QatDecompressorChannel channel =
+        new QatDecompressorChannel(FileChannel.open(file), size, algo, mode, PollingMode.BUSY)) {
+      while (channel.read(result) >= 0) {}
+    }
+    assertEquals(src.length, result.position());
+    byte[] dec = new byte[src.length];
+    result.flip().get(dec);
+    assertTrue(Arrays.equals(src, dec));
+  }
+
+  @Test
+  public void testReadAfterClose() throws IOException {
+    QatDecompressorChannel channel =
+        new QatDecompressorChannel(Channels.newChannel(new ByteArrayInputStream(deflateBytes)));
+    channel.close();
+    assertThrows(ClosedChannelException.class, () -> channel.read(ByteBuffer.allocate(16)));
+    channel.close();
+  }
+
+  @Test
+  public void testTruncatedInput() throws IOException {
+    byte[] truncated = Arrays.copyOf(deflateBytes, deflateBytes.length - 16);
+    try (QatDecompressorChannel channel =
+        new QatDecompressorChannel(Channels.newChannel(new ByteArrayInputStream(truncated)))) {
+      ByteBuffer result = ByteBuffer.allocate(src.length);
+      assertThrows(
+          Exception.class,
+          () -> {
+            while (channel.read(result) >= 0) {}
+          });
+    }
+  }
+}
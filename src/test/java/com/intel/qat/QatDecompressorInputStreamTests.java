@@ -7,7 +7,9 @@
 package com.intel.qat;
 
 import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Format;
 import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
 import static org.junit.jupiter.api.Assertions.assertEquals;
 import static org.junit.jupiter.api.Assertions.assertFalse;
 import static org.junit.jupiter.api.Assertions.assertTrue;
@@ -28,6 +30,7 @@ import org.junit.jupiter.params.ParameterizedTest;
 import org.junit.jupiter.params.provider.Arguments;
 import org.junit.jupiter.params.provider.EnumSource;
 import org.junit.jupiter.params.provider.MethodSource;
+import org.junit.jupiter.params.provider.ValueSource;
 
 public class QatDecompressorInputStreamTests {
   private static final String SAMPLE_TEXT_PATH = "src/test/resources/sample.txt";
@@ -158,6 +161,7 @@ public class QatDecompressorInputStreamTests {
   @EnumSource(Algorithm.class)
   public void testConstructor1(Algorithm algo) {
     assumeTrue(QatTestSuite.FORCE_HARDWARE);
+    assumeTrue(QatZipper.isSupported(algo));
     ByteArrayInputStream inputStream =
         new ByteArrayInputStream(algo.equals(Algorithm.LZ4) ? lz4Bytes : deflateBytes);
     try {
@@ -184,6 +188,7 @@ public class QatDecompressorInputStreamTests {
   @ParameterizedTest
   @EnumSource(Algorithm.class)
   public void testReset(Algorithm algo) throws IOException {
+    assumeTrue(QatZipper.isSupported(algo));
     ByteArrayInputStream inputStream =
         new ByteArrayInputStream(algo.equals(Algorithm.LZ4) ? lz4Bytes : deflateBytes);
     try (QatDecompressorInputStream decompressedStream =
@@ -200,6 +205,7 @@ public class QatDecompressorInputStreamTests {
   @ParameterizedTest
   @EnumSource(Algorithm.class)
   public void testMarkSupported(Algorithm algo) throws IOException {
+    assumeTrue(QatZipper.isSupported(algo));
     ByteArrayInputStream inputStream =
         new ByteArrayInputStream(algo.equals(Algorithm.LZ4) ? lz4Bytes : deflateBytes);
     try (QatDecompressorInputStream decompressedStream =
@@ -432,6 +438,20 @@ public class QatDecompressorInputStreamTests {
     assertTrue(Arrays.equals(src, result2));
   }
 
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testInputStreamSkipPastEnd(Mode mode, Algorithm algo) throws IOException {
+    ByteArrayInputStream inputStream =
+        new ByteArrayInputStream(algo.equals(Algorithm.LZ4) ? lz4Bytes : deflateBytes);
+    try (QatDecompressorInputStream decompressedStream =
+        new QatDecompressorInputStream(inputStream, 16 * 1024, algo, mode)) {
+      // More than an int can hold, which must not be allocated.
+      assertEquals(src.length, decompressedStream.skip(Long.MAX_VALUE));
+      assertEquals(0, decompressedStream.skip(1));
+      assertEquals(-1, decompressedStream.read());
+    }
+  }
+
   @ParameterizedTest
   @MethodSource("provideModeAlgorithmParams")
   public void testInputStreamSkipNegative(Mode mode, Algorithm algo) throws IOException {
@@ -552,4 +572,131 @@ public class QatDecompressorInputStreamTests {
     }
     assertTrue(Arrays.equals(src, result));
   }
+
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmLengthParams")
+  public void testInputStreamReadAhead(Mode mode, Algorithm algo, int bufferSize)
+      throws IOException {
+    ByteArrayInputStream inputStream =
+        new ByteArrayInputStream(algo.equals(Algorithm.LZ4) ? lz4Bytes : deflateBytes);
+    byte[] result = new byte[src.length];
+    try (QatDecompressorInputStream decompressedStream =
+        new QatDecompressorInputStream(inputStream, bufferSize, algo, mode, PollingMode.BUSY, 4)) {
+      int i;
+      int len = 0;
+      for (i = 0; i < result.length; i += len) {
+        if (i % 10 == 0) { // doReadByte
+          len = 1;
+          result[i] = (byte) decompressedStream.read();
+        } else {
+          len = Math.min(RANDOM.nextInt(20 * 1024), result.length - i);
+          assertEquals(len, decompressedStream.read(result, i, len));
+        }
+      }
+      assertEquals(result.length, i);
+      assertEquals(-1, decompressedStream.read());
+    }
+    assertTrue(Arrays.equals(src, result));
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testInputStreamStreaming(Mode mode, Algorithm algo) throws IOException {
+    // The input buffer is much smaller than a compressed block.
+    ByteArrayInputStream inputStream =
+        new ByteArrayInputStream(algo.equals(Algorithm.LZ4) ? lz4Bytes : deflateBytes);
+    byte[] result = new byte[src.length];
+    try (QatDecompressorInputStream decompressedStream =
+        new QatDecompressorInputStream(inputStream, 512, algo, mode, PollingMode.BUSY, true)) {
+      int i;
+      int len = 0;
+      for (i = 0; i < result.length; i += len) {
+        len = decompressedStream.read(result, i, Math.min(4096, result.length - i));
+        assertTrue(len > 0);
+      }
+      assertEquals(result.length, i);
+      assertEquals(-1, decompressedStream.read());
+    }
+    assertTrue(Arrays.equals(src, result));
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testInputStreamReadAheadEarlyClose(Mode mode, Algorithm algo) throws IOException {
+    ByteArrayInputStream inputStream =
+        new ByteArrayInputStream(algo.equals(Algorithm.LZ4) ? lz4Bytes : deflateBytes);
+    QatDecompressorInputStream decompressedStream =
+        new QatDecompressorInputStream(inputStream, 1024, algo, mode, PollingMode.BUSY, 2);
+    assertTrue(decompressedStream.read() >= 0);
+    decompressedStream.close();
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testInputStreamTruncated(Mode mode, Algorithm algo) throws IOException {
+    byte[] compressed = algo.equals(Algorithm.LZ4) ? lz4Bytes : deflateBytes;
+    ByteArrayInputStream inputStream =
+        new ByteArrayInputStream(Arrays.copyOf(compressed, compressed.length - 16));
+    try (QatDecompressorInputStream decompressedStream =
+        new QatDecompressorInputStream(inputStream, 16 * 1024, algo, mode)) {
+      decompressedStream.readAllBytes();
+      fail("Failed to detect truncated input");
+    } catch (IOException | QatException e) {
+      assertTrue(true);
+    }
+  }
+
+  @ParameterizedTest
+  @ValueSource(ints = {512, 16 * 1024, 128 * 1024})
+  public void testInputStreamZstd(int bufferSize) throws IOException {
+    assumeTrue(QatZipper.isSupported(Algorithm.ZSTD));
+    ByteArrayOutputStream outStream = new ByteArrayOutputStream();
+    try (QatCompressorOutputStream outputStream =
+        new QatCompressorOutputStream(outStream, bufferSize, Algorithm.ZSTD, Mode.AUTO)) {
+      outputStream.write(src);
+    }
+
+    byte[] result = new byte[src.length];
+    try (QatDecompressorInputStream decompressedStream =
+        new QatDecompressorInputStream(
+            new ByteArrayInputStream(outStream.toByteArray()),
+            bufferSize,
+            Algorithm.ZSTD,
+            Mode.AUTO)) {
+      assertEquals(result.length, decompressedStream.readNBytes(result, 0, result.length));
+      assertEquals(-1, decompressedStream.read());
+    }
+    assertTrue(Arrays.equals(src, result));
+  }
+
+  @ParameterizedTest
+  @ValueSource(booleans = {false, true})
+  public void testInputStreamGzipFormat(boolean streaming) throws IOException {
+    ByteArrayOutputStream outStream = new ByteArrayOutputStream();
+    try (QatCompressorOutputStream outputStream =
+        new QatCompressorOutputStream(
+            outStream,
+            16 * 1024,
+            Format.GZIP,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            Mode.AUTO,
+            PollingMode.BUSY)) {
+      outputStream.write(src);
+    }
+
+    byte[] result = new byte[src.length];
+    try (QatDecompressorInputStream decompressedStream =
+        new QatDecompressorInputStream(
+            new ByteArrayInputStream(outStream.toByteArray()),
+            16 * 1024,
+            Format.GZIP,
+            Mode.AUTO,
+            PollingMode.BUSY,
+            streaming)) {
+      assertEquals(result.length, decompressedStream.readNBytes(result, 0, result.length));
+      assertEquals(-1, decompressedStream.read());
+    }
+    assertTrue(Arrays.equals(src, result));
+  }
 }
@@ -0,0 +1,253 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static org.junit.jupiter.api.Assertions.assertArrayEquals;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertSame;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.List;
+import java.util.Random;
+import java.util.concurrent.CompletableFuture;
+import java.util.zip.Inflater;
+import org.junit.jupiter.api.AfterEach;
+import org.junit.jupiter.api.BeforeAll;
+import org.junit.jupiter.api.Test;
+import org.junit.jupiter.params.ParameterizedTest;
+import org.junit.jupiter.params.provider.EnumSource;
+
+public class QatDictionaryTests {
+  private static List<byte[]> samples;
+  private static byte[] record;
+
+  private QatZipper qzip;
+
+  @BeforeAll
+  public static void setup() {
+    Random rnd = new Random(42);
+    samples = new ArrayList<>();
+    for (int i = 0; i < 500; i++) samples.add(jsonRecord(rnd));
+    record = jsonRecord(rnd);
+  }
+
+  @AfterEach
+  public void cleanup() {
+    if (qzip != null) qzip.end();
+  }
+
+  private static byte[] jsonRecord(Random rnd) {
+    String json =
+        "{\"requestId\":\""
+            + Long.toHexString(rnd.nextLong())
+            + "\",\"timestamp\":"
+            + (1700000000000L + rnd.nextInt(1000000))
+            + ",\"user\":{\"id\":"
+            + rnd.nextInt(100000)
+            + ",\"region\":\"eu-west-"
+            + rnd.nextInt(3)
+            + "\",\"tier\":\"premium\"},\"status\":\"OK\",\"latencyMillis\":"
+            + rnd.nextInt(500)
+            + ",\"tags\":[\"checkout\",\"mobile\",\"v2\"]}";
+    return json.getBytes(StandardCharsets.UTF_8);
+  }
+
+  @Test
+  public void testTrain() {
+    QatDictionary dict = QatDictionary.train(samples, 1024);
+    assertTrue(dict.size() > 0 && dict.size() <= 1024);
+
+    String content = new String(dict.getBytes(), StandardCharsets.UTF_8);
+    assertTrue(content.contains("\"tier\":\"premium\""));
+  }
+
+  @Test
+  public void testTrainNothingInCommon() {
+    assertThrows(
+        IllegalArgumentException.class,
+        () -> QatDictionary.train(Collections.singletonList(record), 1024));
+  }
+
+  @Test
+  public void testInvalidSize() {
+    assertThrows(IllegalArgumentException.class, () -> QatDictionary.train(samples, 0));
+    assertThrows(
+        IllegalArgumentException.class,
+        () -> QatDictionary.train(samples, QatDictionary.MAX_SIZE + 1));
+    assertThrows(IllegalArgumentException.class, () -> new QatDictionary(new byte[0]));
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Algorithm.class, names = {"DEFLATE", "LZ4"})
+  public void testRoundTrip(Algorithm algo) {
+    QatDictionary dict = QatDictionary.train(samples, 1024);
+    qzip = new QatZipper(algo, QatZipper.DEFAULT_COMPRESS_LEVEL, Mode.AUTO, dict);
+    assertSame(dict, qzip.getDictionary());
+
+    byte[] compressed = new byte[qzip.maxCompressedLength(record.length)];
+    int compressedSize = qzip.compress(record, compressed);
+    assertEquals(record.length, qzip.getBytesRead());
+
+    byte[] decompressed = new byte[record.length];
+    int decompressedSize =
+        qzip.decompress(compressed, 0, compressedSize, decompressed, 0, decompressed.length);
+    assertEquals(record.length, decompressedSize);
+    assertEquals(compressedSize, qzip.getBytesRead());
+    assertArrayEquals(record, decompressed);
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Algorithm.class, names = {"DEFLATE", "LZ4"})
+  public void testDirectBuffers(Algorithm algo) {
+    qzip =
+        new QatZipper(
+            algo,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            Mode.AUTO,
+            QatDictionary.train(samples, 1024));
+
+    ByteBuffer src = ByteBuffer.allocateDirect(record.length);
+    src.put(record).flip();
+    ByteBuffer compressed = ByteBuffer.allocateDirect(qzip.maxCompressedLength(record.length));
+    qzip.compress(src, compressed);
+    compressed.flip();
+
+    ByteBuffer decompressed = ByteBuffer.allocateDirect(record.length);
+    qzip.decompress(compressed, decompressed);
+    decompressed.flip();
+    assertEquals(ByteBuffer.wrap(record), decompressed);
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Algorithm.class, names = {"DEFLATE", "LZ4"})
+  public void testBetterRatio(Algorithm algo) {
+    QatZipper plain = new QatZipper(algo, Mode.AUTO);
+    byte[] buf = new byte[plain.maxCompressedLength(record.length)];
+    int plainSize = plain.compress(record, buf);
+    plain.end();
+
+    qzip =
+        new QatZipper(
+            algo,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            Mode.AUTO,
+            QatDictionary.train(samples, 4096));
+    buf = new byte[qzip.maxCompressedLength(record.length)];
+    int dictSize = qzip.compress(record, buf);
+    assertTrue(dictSize < plainSize, dictSize + " >= " + plainSize);
+  }
+
+  @Test
+  public void testInflaterInterop() throws Exception {
+    QatDictionary dict = QatDictionary.train(samples, 1024);
+    qzip = new QatZipper(Algorithm.DEFLATE, QatZipper.DEFAULT_COMPRESS_LEVEL, Mode.AUTO, dict);
+    byte[] compressed = new byte[qzip.maxCompressedLength(record.length)];
+    int compressedSize = qzip.compress(record, compressed);
+
+    Inflater inflater = new Inflater();
+    inflater.setInput(compressed, 0, compressedSize);
+    byte[] decompressed = new byte[record.length];
+    assertEquals(0, inflater.inflate(decompressed));
+    assertTrue(inflater.needsDictionary());
+    assertEquals(dict.getId(), inflater.getAdler());
+    inflater.setDictionary(dict.getBytes());
+    assertEquals(record.length, inflater.inflate(decompressed));
+    assertTrue(inflater.finished());
+    inflater.end();
+    assertArrayEquals(record, decompressed);
+  }
+
+  @Test
+  public void testWrongDictionary() {
+    qzip =
+        new QatZipper(
+            Algorithm.DEFLATE,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            Mode.AUTO,
+            QatDictionary.train(samples, 1024));
+    byte[] compressed = new byte[qzip.maxCompressedLength(record.length)];
+    int compressedSize = qzip.compress(record, compressed);
+
+    byte[] other = qzip.getDictionary().getBytes();
+    other[other.length - 1]++;
+    QatZipper wrong =
+        new QatZipper(
+            Algorithm.DEFLATE,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            Mode.AUTO,
+            new QatDictionary(other));
+    try {
+      byte[] decompressed = new byte[record.length];
+      assertThrows(
+          QatException.class,
+          () ->
+              wrong.decompress(
+                  compressed, 0, compressedSize, decompressed, 0, decompressed.length));
+    } finally {
+      wrong.end();
+    }
+  }
+
+  @Test
+  public void testHardwareModeRejected() {
+    assertThrows(
+        IllegalArgumentException.class,
+        () ->
+            new QatZipper(
+                Algorithm.DEFLATE,
+                QatZipper.DEFAULT_COMPRESS_LEVEL,
+                Mode.HARDWARE,
+                QatDictionary.train(samples, 1024)));
+  }
+
+  @Test
+  public void testGetFormatRejected() {
+    qzip =
+        new QatZipper(
+            Algorithm.DEFLATE,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            Mode.AUTO,
+            QatDictionary.train(samples, 1024));
+    assertThrows(IllegalStateException.class, () -> qzip.getFormat());
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Algorithm.class, names = {"DEFLATE", "LZ4"})
+  public void testAsync(Algorithm algo) {
+    qzip =
+        new QatZipper(
+            algo,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            Mode.AUTO,
+            QatDictionary.train(samples, 1024));
+
+    // Requests reuse the dictionary sessions that earlier requests set up.
+    for (int round = 0; round < 4; round++) {
+      List<ByteBuffer> dsts = new ArrayList<>();
+      List<CompletableFuture<Integer>> futures = new ArrayList<>();
+      for (int i = 0; i < 8; i++) {
+        ByteBuffer dst = ByteBuffer.allocate(qzip.maxCompressedLength(record.length));
+        dsts.add(dst);
+        futures.add(qzip.compressAsync(ByteBuffer.wrap(record), dst));
+      }
+      for (int i = 0; i < 8; i++) {
+        futures.get(i).join();
+        ByteBuffer compressed = dsts.get(i).flip();
+        ByteBuffer decompressed = ByteBuffer.allocate(record.length);
+        assertEquals(record.length, (int) qzip.decompressAsync(compressed, decompressed).join());
+        assertArrayEquals(record, decompressed.array());
+      }
+    }
+  }
+}
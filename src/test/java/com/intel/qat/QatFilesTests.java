@@ -0,0 +1,223 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+import static org.junit.jupiter.api.Assertions.fail;
+
+import java.io.IOException;
+import java.io.InputStream;
+import java.io.OutputStream;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.Arrays;
+import java.util.Random;
+import java.util.stream.Stream;
+import org.junit.jupiter.api.BeforeAll;
+import org.junit.jupiter.api.Test;
+import org.junit.jupiter.api.io.TempDir;
+import org.junit.jupiter.params.ParameterizedTest;
+import org.junit.jupiter.params.provider.Arguments;
+import org.junit.jupiter.params.provider.MethodSource;
+
+public class QatFilesTests {
+  private static final String SAMPLE_TEXT_PATH = "src/test/resources/sample.txt";
+  private static final int SMALL_WINDOW = 1 << 16;
+  private static byte[] src;
+
+  @TempDir Path tempDir;
+
+  @BeforeAll
+  public static void setup() throws IOException {
+    // About 2.5MB of mixed text and random data, so small windows split it many times.
+    byte[] sample = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+    byte[] noise = new byte[sample.length];
+    new Random(42).nextBytes(noise);
+    src = new byte[256 * 2 * sample.length];
+    for (int i = 0; i < src.length; i += 2 * sample.length) {
+      System.arraycopy(sample, 0, src, i, sample.length);
+      System.arraycopy(noise, 0, src, i + sample.length, noise.length);
+    }
+  }
+
+  public static Stream<Arguments> provideModeAlgorithmParams() {
+    return QatTestSuite.FORCE_HARDWARE
+        ? Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE),
+            Arguments.of(Mode.AUTO, Algorithm.LZ4),
+            Arguments.of(Mode.HARDWARE, Algorithm.DEFLATE),
+            Arguments.of(Mode.HARDWARE, Algorithm.LZ4))
+        : Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE), Arguments.of(Mode.AUTO, Algorithm.LZ4));
+  }
+
+  public static Stream<Arguments> provideModeAlgorithmParallelismParams() {
+    return provideModeAlgorithmParams()
+        .flatMap(args -> Stream.of(1, 4).map(p -> Arguments.of(args.get()[0], args.get()[1], p)));
+  }
+
+  private Path writeSource() throws IOException {
+    Path file = tempDir.resolve("source");
+    Files.write(file, src);
+    return file;
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParallelismParams")
+  public void testRoundTrip(Mode mode, Algorithm algo, int parallelism) throws IOException {
+    Path source = writeSource();
+    Path compressed = tempDir.resolve("compressed");
+    Path decompressed = tempDir.resolve("decompressed");
+
+    long compressedSize =
+        QatFiles.compress(
+            source,
+            compressed,
+            algo,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            mode,
+            PollingMode.BUSY,
+            parallelism);
+    assertEquals(Files.size(compressed), compressedSize);
+
+    assertEquals(
+        src.length, QatFiles.decompress(compressed, decompressed, algo, mode, PollingMode.BUSY));
+    assertTrue(Arrays.equals(src, Files.readAllBytes(decompressed)));
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParallelismParams")
+  public void testRoundTripSmallWindows(Mode mode, Algorithm algo, int parallelism)
+      throws IOException {
+    Path source = writeSource();
+    Path compressed = tempDir.resolve("compressed");
+    Path decompressed = tempDir.resolve("decompressed");
+
+    QatFiles.compress(
+        source,
+        compressed,
+        algo,
+        QatZipper.DEFAULT_COMPRESS_LEVEL,
+        mode,
+        PollingMode.BUSY,
+        parallelism,
+        SMALL_WINDOW);
+    QatFiles.decompress(compressed, decompressed, algo, mode, PollingMode.BUSY, SMALL_WINDOW);
+    assertTrue(Arrays.equals(src, Files.readAllBytes(decompressed)));
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testDecompressStreamOutput(Mode mode, Algorithm algo) throws IOException {
+    Path compressed = tempDir.resolve("compressed");
+    Path decompressed = tempDir.resolve("decompressed");
+    try (OutputStream out =
+        new QatCompressorOutputStream(
+            Files.newOutputStream(compressed),
+            16 * 1024,
+            algo,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            mode,
+            PollingMode.BUSY)) {
+      out.write(src);
+    }
+
+    QatFiles.decompress(compressed, decompressed, algo, mode, PollingMode.BUSY);
+    assertTrue(Arrays.equals(src, Files.readAllBytes(decompressed)));
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testCompressForInputStream(Mode mode, Algorithm algo) throws IOException {
+    Path compressed = tempDir.resolve("compressed");
+    QatFiles.compress(
+        writeSource(),
+        compressed,
+        algo,
+        QatZipper.DEFAULT_COMPRESS_LEVEL,
+        mode,
+        PollingMode.BUSY,
+        1,
+        SMALL_WINDOW);
+
+    try (InputStream in =
+        new QatDecompressorInputStream(
+            Files.newInputStream(compressed), 2 * SMALL_WINDOW, algo, mode, PollingMode.BUSY)) {
+      assertTrue(Arrays.equals(src, in.readAllBytes()));
+    }
+  }
+
+  @Test
+  public void testEmptyFile() throws IOException {
+    Path source = tempDir.resolve("empty");
+    Path compressed = tempDir.resolve("compressed");
+    Path decompressed = tempDir.resolve("decompressed");
+    Files.write(source, new byte[0]);
+
+    assertEquals(
+        0,
+        QatFiles.compress(
+            source,
+            compressed,
+            Algorithm.DEFLATE,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            Mode.AUTO,
+            PollingMode.BUSY,
+            1));
+    assertEquals(
+        0,
+        QatFiles.decompress(
+            compressed, decompressed, Algorithm.DEFLATE, Mode.AUTO, PollingMode.BUSY));
+    assertEquals(0, Files.size(decompressed));
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testTruncated(Mode mode, Algorithm algo) throws IOException {
+    Path compressed = tempDir.resolve("compressed");
+    QatFiles.compress(
+        writeSource(),
+        compressed,
+        algo,
+        QatZipper.DEFAULT_COMPRESS_LEVEL,
+        mode,
+        PollingMode.BUSY,
+        1);
+    byte[] bytes = Files.readAllBytes(compressed);
+    Files.write(compressed, Arrays.copyOf(bytes, bytes.length - 16));
+
+    try {
+      Path decompressed = tempDir.resolve("decompressed");
+      QatFiles.decompress(compressed, decompressed, algo, mode, PollingMode.BUSY);
+      fail("Failed to detect truncated input");
+    } catch (IOException | QatException e) {
+      assertTrue(true);
+    }
+  }
+
+  @Test
+  public void testBadParallelism() throws IOException {
+    Path source = writeSource();
+    assertThrows(
+        IllegalArgumentException.class,
+        () ->
+            QatFiles.compress(
+                source,
+                tempDir.resolve("compressed"),
+                Algorithm.DEFLATE,
+                QatZipper.DEFAULT_COMPRESS_LEVEL,
+                Mode.AUTO,
+                PollingMode.BUSY,
+                0));
+  }
+}
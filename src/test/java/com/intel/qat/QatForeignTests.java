@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static org.junit.jupiter.api.Assertions.assertArrayEquals;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertFalse;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.Arrays;
+import org.junit.jupiter.api.AfterEach;
+import org.junit.jupiter.api.Test;
+import org.junit.jupiter.params.ParameterizedTest;
+import org.junit.jupiter.params.provider.EnumSource;
+
+// Byte array requests take the foreign function backend on JDK 22 and later if qat.backend is set
+// to foreign, and JNI otherwise, so these tests run the same requests on whichever backend is
+// selected.
+public class QatForeignTests {
+  private static final String SAMPLE_TEXT_PATH = "src/test/resources/sample.txt";
+
+  private QatZipper qzip;
+
+  @AfterEach
+  public void cleanupSession() {
+    if (qzip != null) qzip.end();
+  }
+
+  @Test
+  public void testDisabledBeforeJdk22() {
+    if (Runtime.version().feature() < 22) assertFalse(QatForeign.isEnabled());
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Algorithm.class, names = {"DEFLATE", "LZ4"})
+  public void testByteArrayWithOffsets(Algorithm algo) throws IOException {
+    qzip = new QatZipper(algo, Mode.AUTO);
+    byte[] src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+    int offset = 7;
+    byte[] padded = new byte[src.length + 2 * offset];
+    System.arraycopy(src, 0, padded, offset, src.length);
+
+    byte[] compressed = new byte[qzip.maxCompressedLength(src.length) + offset];
+    int compressedSize =
+        qzip.compress(padded, offset, src.length, compressed, offset, compressed.length - offset);
+    assertEquals(src.length, qzip.getBytesRead());
+    assertEquals(compressedSize, qzip.getBytesWritten());
+
+    byte[] dec = new byte[src.length + offset];
+    int decompressedSize =
+        qzip.decompress(compressed, offset, compressedSize, dec, offset, src.length);
+    assertEquals(src.length, decompressedSize);
+    assertEquals(compressedSize, qzip.getBytesRead());
+    assertArrayEquals(src, Arrays.copyOfRange(dec, offset, offset + src.length));
+  }
+
+  @Test
+  public void testHeapByteBuffers() throws IOException {
+    qzip = new QatZipper(Algorithm.DEFLATE, Mode.AUTO);
+    byte[] src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+    ByteBuffer srcBuf = ByteBuffer.wrap(src);
+    ByteBuffer compressed = ByteBuffer.allocate(qzip.maxCompressedLength(src.length));
+    qzip.compress(srcBuf, compressed);
+    assertFalse(srcBuf.hasRemaining());
+
+    compressed.flip();
+    ByteBuffer dec = ByteBuffer.allocate(src.length);
+    qzip.decompress(compressed, dec);
+    assertFalse(compressed.hasRemaining());
+    assertArrayEquals(src, dec.array());
+  }
+}
@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+
+import java.io.ByteArrayInputStream;
+import java.io.ByteArrayOutputStream;
+import java.io.EOFException;
+import java.io.IOException;
+import java.util.Arrays;
+import org.junit.jupiter.api.Test;
+
+public class QatIndexTests {
+  private static QatIndex index(int... lengths) {
+    QatIndex index = new QatIndex();
+    for (int i = 0; i < lengths.length; i += 2) index.add(lengths[i], lengths[i + 1]);
+    return index;
+  }
+
+  private static byte[] serialize(QatIndex index) throws IOException {
+    ByteArrayOutputStream out = new ByteArrayOutputStream();
+    index.writeTo(out);
+    return out.toByteArray();
+  }
+
+  @Test
+  public void testOffsets() {
+    QatIndex index = index(10, 100, 20, 200, 30, 300);
+    assertEquals(3, index.size());
+    assertEquals(0, index.compressedOffset(0));
+    assertEquals(30, index.compressedOffset(2));
+    assertEquals(20, index.compressedLength(1));
+    assertEquals(100, index.uncompressedOffset(1));
+    assertEquals(300, index.uncompressedLength(2));
+    assertEquals(60, index.compressedSize());
+    assertEquals(600, index.uncompressedSize());
+    assertThrows(IndexOutOfBoundsException.class, () -> index.compressedOffset(3));
+    assertThrows(IndexOutOfBoundsException.class, () -> index.uncompressedLength(-1));
+  }
+
+  @Test
+  public void testGrows() {
+    QatIndex index = new QatIndex();
+    for (int i = 0; i < 1000; i++) index.add(i + 1, 2 * i);
+    assertEquals(1000, index.size());
+    assertEquals(999L * 1000 / 2 + 1000, index.compressedSize());
+    assertEquals(999L * 1000, index.uncompressedSize());
+  }
+
+  @Test
+  public void testMemberAt() {
+    QatIndex index = index(10, 100, 5, 0, 20, 200);
+    assertEquals(0, index.memberAt(0));
+    assertEquals(0, index.memberAt(99));
+    // The empty second member contains no offset.
+    assertEquals(2, index.memberAt(100));
+    assertEquals(2, index.memberAt(299));
+    assertThrows(IndexOutOfBoundsException.class, () -> index.memberAt(300));
+    assertThrows(IndexOutOfBoundsException.class, () -> index.memberAt(-1));
+  }
+
+  @Test
+  public void testSerialization() throws IOException {
+    QatIndex index = index(10, 100, 20, 200, 30, 300);
+    QatIndex read = QatIndex.readFrom(new ByteArrayInputStream(serialize(index)));
+    assertEquals(index.size(), read.size());
+    for (int i = 0; i < index.size(); i++) {
+      assertEquals(index.compressedLength(i), read.compressedLength(i));
+      assertEquals(index.uncompressedLength(i), read.uncompressedLength(i));
+    }
+
+    QatIndex empty = QatIndex.readFrom(new ByteArrayInputStream(serialize(new QatIndex())));
+    assertEquals(0, empty.size());
+  }
+
+  @Test
+  public void testCorrupt() throws IOException {
+    byte[] data = serialize(index(10, 100, 20, 200));
+
+    byte[] badMagic = data.clone();
+    badMagic[0]++;
+    assertThrows(IOException.class, () -> QatIndex.readFrom(new ByteArrayInputStream(badMagic)));
+
+    byte[] badEntry = data.clone();
+    badEntry[15]++;
+    assertThrows(IOException.class, () -> QatIndex.readFrom(new ByteArrayInputStream(badEntry)));
+
+    byte[] truncated = Arrays.copyOf(data, data.length - 1);
+    assertThrows(
+        EOFException.class, () -> QatIndex.readFrom(new ByteArrayInputStream(truncated)));
+  }
+}
@@ -0,0 +1,256 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+import static org.junit.jupiter.api.Assertions.fail;
+
+import java.io.ByteArrayInputStream;
+import java.io.ByteArrayOutputStream;
+import java.io.EOFException;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.Random;
+import java.util.concurrent.CompletableFuture;
+import java.util.concurrent.TimeUnit;
+import java.util.stream.Stream;
+import org.junit.jupiter.api.Test;
+import org.junit.jupiter.params.ParameterizedTest;
+import org.junit.jupiter.params.provider.Arguments;
+import org.junit.jupiter.params.provider.MethodSource;
+
+public class QatParallelZipperTests {
+  private static final String SAMPLE_TEXT_PATH = "src/test/resources/sample.txt";
+  private static final int BLOCK_SIZE = 4096;
+
+  private final Random rnd = new Random();
+
+  public static Stream<Arguments> provideModeAlgorithmParams() {
+    return QatTestSuite.FORCE_HARDWARE
+        ? Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE),
+            Arguments.of(Mode.AUTO, Algorithm.LZ4),
+            Arguments.of(Mode.HARDWARE, Algorithm.DEFLATE),
+            Arguments.of(Mode.HARDWARE, Algorithm.LZ4))
+        : Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE), Arguments.of(Mode.AUTO, Algorithm.LZ4));
+  }
+
+  private static QatParallelZipper parallelZipper(Algorithm algo, Mode mode) {
+    return new QatParallelZipper(
+        algo,
+        QatZipper.DEFAULT_COMPRESS_LEVEL,
+        mode,
+        PollingMode.BUSY,
+        BLOCK_SIZE,
+        4,
+        QatParallelZipper.BlockExecutor.INSTANCE);
+  }
+
+  private byte[] getRandomBytes(int len) {
+    byte[] data = new byte[len];
+    rnd.nextBytes(data);
+    return data;
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testCompressByteArray(Mode mode, Algorithm algo) {
+    try {
+      QatParallelZipper pzip = parallelZipper(algo, mode);
+      QatZipper qzip = new QatZipper(algo, mode);
+
+      byte[] src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+      byte[] dst = new byte[(int) pzip.maxCompressedLength(src.length)];
+      byte[] dec = new byte[src.length];
+
+      int compressedSize = pzip.compress(src, dst);
+      int decompressedSize = qzip.decompress(dst, 0, compressedSize, dec, 0, dec.length);
+      qzip.end();
+
+      assertEquals(src.length, decompressedSize);
+      assertTrue(Arrays.equals(src, dec));
+    } catch (QatException | IOException e) {
+      fail(e.getMessage());
+    }
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testCompressDirectByteBuffer(Mode mode, Algorithm algo) {
+    try {
+      QatParallelZipper pzip = parallelZipper(algo, mode);
+      QatZipper qzip = new QatZipper(algo, mode);
+
+      byte[] data = getRandomBytes(10 * BLOCK_SIZE + 123);
+      ByteBuffer src = ByteBuffer.allocateDirect(data.length);
+      ByteBuffer dst = ByteBuffer.allocateDirect((int) pzip.maxCompressedLength(data.length));
+      ByteBuffer dec = ByteBuffer.allocateDirect(data.length);
+      src.put(data).flip();
+
+      int compressedSize = pzip.compress(src, dst);
+      assertEquals(compressedSize, dst.position());
+      assertEquals(src.limit(), src.position());
+
+      dst.flip();
+      qzip.decompress(dst, dec);
+      qzip.end();
+
+      byte[] result = new byte[data.length];
+      dec.flip().get(result);
+      assertTrue(Arrays.equals(data, result));
+    } catch (QatException e) {
+      fail(e.getMessage());
+    }
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testCompressStream(Mode mode, Algorithm algo) {
+    try {
+      QatParallelZipper pzip = parallelZipper(algo, mode);
+
+      byte[] src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+      ByteArrayOutputStream out = new ByteArrayOutputStream();
+      long compressedSize = pzip.compress(new ByteArrayInputStream(src), out);
+      assertEquals(out.size(), compressedSize);
+
+      try (QatDecompressorInputStream in =
+          new QatDecompressorInputStream(
+              new ByteArrayInputStream(out.toByteArray()),
+              16 * 1024,
+              algo,
+              mode,
+              PollingMode.BUSY)) {
+        byte[] dec = in.readAllBytes();
+        assertTrue(Arrays.equals(src, dec));
+      }
+    } catch (QatException | IOException e) {
+      fail(e.getMessage());
+    }
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testIndexedRoundTrip(Mode mode, Algorithm algo) throws IOException {
+    QatParallelZipper pzip = parallelZipper(algo, mode);
+
+    byte[] src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+    ByteArrayOutputStream out = new ByteArrayOutputStream();
+    QatIndex index = pzip.compressIndexed(new ByteArrayInputStream(src), out);
+    assertEquals((src.length + BLOCK_SIZE - 1) / BLOCK_SIZE, index.size());
+    assertEquals(out.size(), index.compressedSize());
+    assertEquals(src.length, index.uncompressedSize());
+
+    // Round trip the index through its serialized form, as a sidecar would.
+    ByteArrayOutputStream sidecar = new ByteArrayOutputStream();
+    index.writeTo(sidecar);
+    index = QatIndex.readFrom(new ByteArrayInputStream(sidecar.toByteArray()));
+
+    ByteArrayOutputStream dec = new ByteArrayOutputStream();
+    long decompressedSize =
+        pzip.decompress(new ByteArrayInputStream(out.toByteArray()), index, dec);
+    assertEquals(src.length, decompressedSize);
+    assertTrue(Arrays.equals(src, dec.toByteArray()));
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testDecompressTruncated(Mode mode, Algorithm algo) throws IOException {
+    QatParallelZipper pzip = parallelZipper(algo, mode);
+    byte[] src = getRandomBytes(4 * BLOCK_SIZE);
+    ByteArrayOutputStream out = new ByteArrayOutputStream();
+    QatIndex index = pzip.compressIndexed(new ByteArrayInputStream(src), out);
+
+    byte[] truncated = Arrays.copyOf(out.toByteArray(), out.size() - 1);
+    assertThrows(
+        EOFException.class,
+        () ->
+            pzip.decompress(
+                new ByteArrayInputStream(truncated), index, new ByteArrayOutputStream()));
+  }
+
+  @Test
+  public void testDecompressIndexMismatch() throws IOException {
+    QatParallelZipper pzip = parallelZipper(Algorithm.DEFLATE, Mode.AUTO);
+    byte[] src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+    ByteArrayOutputStream out = new ByteArrayOutputStream();
+    QatIndex index = pzip.compressIndexed(new ByteArrayInputStream(src), out);
+
+    // An index that claims the first member decompresses to less than it does.
+    QatIndex wrong = new QatIndex();
+    wrong.add(index.compressedLength(0), index.uncompressedLength(0) - 1);
+    assertThrows(
+        QatException.class,
+        () ->
+            pzip.decompress(
+                new ByteArrayInputStream(out.toByteArray()), wrong, new ByteArrayOutputStream()));
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testInsufficientDestination(Mode mode, Algorithm algo) {
+    QatParallelZipper pzip = parallelZipper(algo, mode);
+    byte[] src = getRandomBytes(8 * BLOCK_SIZE);
+    byte[] dst = new byte[BLOCK_SIZE];
+    assertThrows(QatException.class, () -> pzip.compress(src, dst));
+  }
+
+  @Test
+  public void testInvalidBlockSize() {
+    assertThrows(
+        IllegalArgumentException.class,
+        () ->
+            new QatParallelZipper(
+                Algorithm.DEFLATE,
+                QatZipper.DEFAULT_COMPRESS_LEVEL,
+                Mode.AUTO,
+                PollingMode.BUSY,
+                0,
+                1,
+                Runnable::run));
+  }
+
+  @Test
+  public void testNestedCalls() throws Exception {
+    QatParallelZipper pzip = parallelZipper(Algorithm.DEFLATE, Mode.AUTO);
+    byte[] src = getRandomBytes(8 * BLOCK_SIZE);
+
+    // Calls from every thread of the block executor at once must not wait for the executor.
+    List<CompletableFuture<Integer>> futures = new ArrayList<>();
+    for (int i = 0; i < 2 * QatParallelZipper.DEFAULT_PARALLELISM; i++)
+      futures.add(
+          CompletableFuture.supplyAsync(
+              () -> pzip.compress(src, new byte[(int) pzip.maxCompressedLength(src.length)]),
+              QatParallelZipper.BlockExecutor.INSTANCE));
+
+    // Nor may continuations of asynchronous requests, which run on the asynchronous executor.
+    QatZipper qzip = new QatZipper(Algorithm.DEFLATE, Mode.AUTO);
+    try {
+      for (int i = 0; i < 2 * QatZipper.DEFAULT_ASYNC_THREADS; i++)
+        futures.add(
+            qzip.compressAsync(
+                    ByteBuffer.wrap(src),
+                    ByteBuffer.allocate(qzip.maxCompressedLength(src.length)))
+                .thenApply(
+                    n -> pzip.compress(src, new byte[(int) pzip.maxCompressedLength(src.length)])));
+      for (CompletableFuture<Integer> f : futures) assertTrue(f.get(60, TimeUnit.SECONDS) > 0);
+    } finally {
+      qzip.end();
+    }
+  }
+}
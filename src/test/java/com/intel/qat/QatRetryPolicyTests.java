@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertFalse;
+import static org.junit.jupiter.api.Assertions.assertNull;
+import static org.junit.jupiter.api.Assertions.assertSame;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+import java.util.Arrays;
+import java.util.concurrent.TimeUnit;
+import org.junit.jupiter.api.Test;
+
+public class QatRetryPolicyTests {
+  @Test
+  public void testGetters() {
+    QatRetryPolicy policy = new QatRetryPolicy(5, 10, 1000, 50, TimeUnit.MICROSECONDS, true);
+    assertEquals(5, policy.getMaxRetries());
+    assertEquals(10, policy.getInitialBackoff(TimeUnit.MICROSECONDS));
+    assertEquals(1, policy.getMaxBackoff(TimeUnit.MILLISECONDS));
+    assertEquals(50_000, policy.getTimeout(TimeUnit.NANOSECONDS));
+    assertTrue(policy.isFailover());
+
+    policy = new QatRetryPolicy(3, 1, 8, TimeUnit.MILLISECONDS);
+    assertEquals(0, policy.getTimeout(TimeUnit.NANOSECONDS));
+    assertFalse(policy.isFailover());
+  }
+
+  @Test
+  public void testInvalidArguments() {
+    assertThrows(
+        IllegalArgumentException.class, () -> new QatRetryPolicy(-1, 1, 8, TimeUnit.MILLISECONDS));
+    assertThrows(
+        IllegalArgumentException.class, () -> new QatRetryPolicy(3, -1, 8, TimeUnit.MILLISECONDS));
+    assertThrows(
+        IllegalArgumentException.class, () -> new QatRetryPolicy(3, 8, 1, TimeUnit.MILLISECONDS));
+    assertThrows(
+        IllegalArgumentException.class,
+        () -> new QatRetryPolicy(3, 1, 8, -1, TimeUnit.MILLISECONDS, false));
+    assertThrows(NullPointerException.class, () -> new QatRetryPolicy(3, 1, 8, null));
+  }
+
+  @Test
+  public void testBackoff() {
+    QatRetryPolicy policy = new QatRetryPolicy(10, 100, 1000, TimeUnit.NANOSECONDS);
+    for (int i = 0; i < 100; i++) {
+      // The jittered delay lies between half and all of the exponential delay.
+      long first = policy.backoffNanos(0);
+      assertTrue(first >= 50 && first <= 100, "first: " + first);
+      long third = policy.backoffNanos(2);
+      assertTrue(third >= 200 && third <= 400, "third: " + third);
+      long capped = policy.backoffNanos(9);
+      assertTrue(capped >= 500 && capped <= 1000, "capped: " + capped);
+    }
+  }
+
+  @Test
+  public void testNoBackoff() {
+    QatRetryPolicy policy = new QatRetryPolicy(3, 0, 0, TimeUnit.NANOSECONDS);
+    assertEquals(0, policy.backoffNanos(0));
+    assertEquals(0, policy.backoffNanos(2));
+    assertTrue(policy.await(0, policy.deadline()));
+  }
+
+  @Test
+  public void testDeadline() {
+    QatRetryPolicy policy = new QatRetryPolicy(100, 1, 1, 1, TimeUnit.MILLISECONDS, false);
+    long deadline = policy.deadline();
+    long start = System.nanoTime();
+    int attempts = 0;
+    while (policy.await(attempts, deadline)) attempts++;
+
+    // Waiting stops once the timeout has passed, without sleeping past it for long.
+    long elapsed = System.nanoTime() - start;
+    assertTrue(elapsed >= TimeUnit.MILLISECONDS.toNanos(1));
+    assertTrue(elapsed < TimeUnit.SECONDS.toNanos(1));
+  }
+
+  @Test
+  public void testZipper() {
+    QatZipper qzip = new QatZipper(Algorithm.DEFLATE, Mode.AUTO);
+    try {
+      assertNull(qzip.getRetryPolicy());
+      QatRetryPolicy policy = new QatRetryPolicy(4, 10, 1000, 1, TimeUnit.MICROSECONDS, true);
+      qzip.setRetryPolicy(policy);
+      assertSame(policy, qzip.getRetryPolicy());
+
+      byte[] src = "retry retry retry retry retry".getBytes(StandardCharsets.UTF_8);
+      byte[] compressed = new byte[qzip.maxCompressedLength(src.length)];
+      int compressedSize = qzip.compress(src, compressed);
+      byte[] dec = new byte[src.length];
+      assertEquals(src.length, qzip.decompress(compressed, 0, compressedSize, dec, 0, dec.length));
+      assertTrue(Arrays.equals(src, dec));
+
+      qzip.setRetryPolicy(null);
+      assertNull(qzip.getRetryPolicy());
+    } finally {
+      qzip.end();
+    }
+  }
+
+  @Test
+  public void testBatchWithPolicy() {
+    QatZipper qzip = new QatZipper(Algorithm.DEFLATE, Mode.AUTO);
+    try {
+      qzip.setRetryPolicy(new QatRetryPolicy(4, 10, 1000, 1, TimeUnit.MICROSECONDS, true));
+      byte[] src = "batch batch batch batch batch".getBytes(StandardCharsets.UTF_8);
+      ByteBuffer[] srcs = {ByteBuffer.wrap(src), ByteBuffer.allocateDirect(src.length)};
+      srcs[1].put(src).flip();
+      ByteBuffer[] dsts = new ByteBuffer[2];
+      for (int i = 0; i < 2; i++)
+        dsts[i] = ByteBuffer.allocateDirect(qzip.maxCompressedLength(src.length));
+      int[] outLens = new int[2];
+      qzip.compressBatch(srcs, dsts, outLens);
+
+      for (int i = 0; i < 2; i++) {
+        assertEquals(outLens[i], dsts[i].position());
+        dsts[i].flip();
+        ByteBuffer dec = ByteBuffer.allocate(src.length);
+        qzip.decompress(dsts[i], dec);
+        assertTrue(Arrays.equals(src, dec.array()));
+      }
+    } finally {
+      qzip.end();
+    }
+  }
+}
@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
+import static org.junit.jupiter.api.Assertions.assertArrayEquals;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+
+import java.io.ByteArrayInputStream;
+import java.io.IOException;
+import java.io.OutputStream;
+import java.nio.ByteBuffer;
+import java.nio.channels.NonWritableChannelException;
+import java.nio.channels.SeekableByteChannel;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.Arrays;
+import java.util.Random;
+import java.util.stream.Stream;
+import org.junit.jupiter.api.Test;
+import org.junit.jupiter.api.io.TempDir;
+import org.junit.jupiter.params.ParameterizedTest;
+import org.junit.jupiter.params.provider.Arguments;
+import org.junit.jupiter.params.provider.MethodSource;
+
+public class QatSeekableChannelTests {
+  private static final String SAMPLE_TEXT_PATH = "src/test/resources/sample.txt";
+  private static final int BLOCK_SIZE = 512;
+
+  @TempDir Path tempDir;
+
+  public static Stream<Arguments> provideModeAlgorithmParams() {
+    return QatTestSuite.FORCE_HARDWARE
+        ? Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE),
+            Arguments.of(Mode.AUTO, Algorithm.LZ4),
+            Arguments.of(Mode.HARDWARE, Algorithm.DEFLATE),
+            Arguments.of(Mode.HARDWARE, Algorithm.LZ4))
+        : Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE), Arguments.of(Mode.AUTO, Algorithm.LZ4));
+  }
+
+  private Path container(Algorithm algo, Mode mode, byte[] src) throws IOException {
+    QatParallelZipper pzip =
+        new QatParallelZipper(
+            algo,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            mode,
+            PollingMode.BUSY,
+            BLOCK_SIZE,
+            4,
+            QatZipper.AsyncExecutor.INSTANCE);
+    Path file = tempDir.resolve("container");
+    try (OutputStream out = Files.newOutputStream(file)) {
+      long written = pzip.compressSeekable(new ByteArrayInputStream(src), out);
+      assertEquals(written, Files.size(file));
+    }
+    return file;
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testReadAll(Mode mode, Algorithm algo) throws IOException {
+    byte[] src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+    Path file = container(algo, mode, src);
+    try (QatSeekableChannel channel =
+        new QatSeekableChannel(Files.newByteChannel(file), algo, mode, PollingMode.BUSY)) {
+      assertEquals(src.length, channel.size());
+      assertEquals((src.length + BLOCK_SIZE - 1) / BLOCK_SIZE, channel.getIndex().size());
+
+      ByteBuffer dst = ByteBuffer.allocate(src.length);
+      while (dst.hasRemaining()) assertTrue(channel.read(dst) > 0);
+      assertArrayEquals(src, dst.array());
+      assertEquals(-1, channel.read(ByteBuffer.allocate(1)));
+    }
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testRandomRanges(Mode mode, Algorithm algo) throws IOException {
+    byte[] src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+    Path file = container(algo, mode, src);
+    Random rnd = new Random(7);
+    try (QatSeekableChannel channel =
+        new QatSeekableChannel(Files.newByteChannel(file), algo, mode, PollingMode.BUSY)) {
+      for (int i = 0; i < 50; i++) {
+        int offset = rnd.nextInt(src.length);
+        int len = Math.min(src.length - offset, 1 + rnd.nextInt(3 * BLOCK_SIZE));
+        ByteBuffer dst = ByteBuffer.allocateDirect(len);
+        channel.position(offset);
+        assertEquals(len, channel.read(dst));
+        assertEquals(offset + len, channel.position());
+        dst.flip();
+        assertEquals(ByteBuffer.wrap(src, offset, len), dst);
+      }
+    }
+  }
+
+  @Test
+  public void testPositionPastEnd() throws IOException {
+    byte[] src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+    Path file = container(Algorithm.DEFLATE, Mode.AUTO, src);
+    try (QatSeekableChannel channel =
+        new QatSeekableChannel(
+            Files.newByteChannel(file), Algorithm.DEFLATE, Mode.AUTO, PollingMode.BUSY)) {
+      channel.position(src.length + 10);
+      assertEquals(-1, channel.read(ByteBuffer.allocate(1)));
+      assertThrows(IllegalArgumentException.class, () -> channel.position(-1));
+    }
+  }
+
+  @Test
+  public void testReadOnly() throws IOException {
+    Path file = container(Algorithm.DEFLATE, Mode.AUTO, new byte[] {1, 2, 3});
+    try (QatSeekableChannel channel =
+        new QatSeekableChannel(
+            Files.newByteChannel(file), Algorithm.DEFLATE, Mode.AUTO, PollingMode.BUSY)) {
+      assertThrows(NonWritableChannelException.class, () -> channel.write(ByteBuffer.allocate(1)));
+      assertThrows(NonWritableChannelException.class, () -> channel.truncate(0));
+    }
+  }
+
+  @Test
+  public void testNotAContainer() throws IOException {
+    Path file = tempDir.resolve("plain");
+    Files.write(file, Arrays.copyOf("not a container".getBytes(), 64));
+    try (SeekableByteChannel source = Files.newByteChannel(file)) {
+      assertThrows(
+          IOException.class,
+          () -> new QatSeekableChannel(source, Algorithm.DEFLATE, Mode.AUTO, PollingMode.BUSY));
+    }
+  }
+}
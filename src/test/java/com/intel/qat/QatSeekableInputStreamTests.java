@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
+import static org.junit.jupiter.api.Assertions.assertArrayEquals;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+
+import java.io.ByteArrayInputStream;
+import java.io.IOException;
+import java.io.OutputStream;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.Arrays;
+import org.junit.jupiter.api.BeforeEach;
+import org.junit.jupiter.api.Test;
+import org.junit.jupiter.api.io.TempDir;
+import org.junit.jupiter.params.ParameterizedTest;
+import org.junit.jupiter.params.provider.EnumSource;
+
+public class QatSeekableInputStreamTests {
+  private static final String SAMPLE_TEXT_PATH = "src/test/resources/sample.txt";
+  private static final int BLOCK_SIZE = 512;
+
+  @TempDir Path tempDir;
+
+  private byte[] src;
+
+  @BeforeEach
+  public void setup() throws IOException {
+    src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+  }
+
+  private QatSeekableInputStream open(Algorithm algo) throws IOException {
+    QatParallelZipper pzip =
+        new QatParallelZipper(
+            algo,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            Mode.AUTO,
+            PollingMode.BUSY,
+            BLOCK_SIZE,
+            4,
+            QatZipper.AsyncExecutor.INSTANCE);
+    Path file = tempDir.resolve("container");
+    try (OutputStream out = Files.newOutputStream(file)) {
+      pzip.compressSeekable(new ByteArrayInputStream(src), out);
+    }
+    return new QatSeekableInputStream(
+        Files.newByteChannel(file), algo, Mode.AUTO, PollingMode.BUSY);
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Algorithm.class, names = {"DEFLATE", "LZ4"})
+  public void testReadAll(Algorithm algo) throws IOException {
+    try (QatSeekableInputStream in = open(algo)) {
+      assertEquals(src.length, in.length());
+      assertArrayEquals(src, in.readAllBytes());
+      assertEquals(-1, in.read());
+      assertEquals(0, in.available());
+    }
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Algorithm.class, names = {"DEFLATE", "LZ4"})
+  public void testSeek(Algorithm algo) throws IOException {
+    try (QatSeekableInputStream in = open(algo)) {
+      int offset = src.length - BLOCK_SIZE - 17;
+      in.seek(offset);
+      assertEquals(offset, in.getPosition());
+      assertEquals(Byte.toUnsignedInt(src[offset]), in.read());
+
+      byte[] dst = new byte[100];
+      in.seek(10);
+      assertEquals(dst.length, in.read(dst));
+      assertArrayEquals(Arrays.copyOfRange(src, 10, 110), dst);
+    }
+  }
+
+  @Test
+  public void testSkip() throws IOException {
+    try (QatSeekableInputStream in = open(Algorithm.DEFLATE)) {
+      assertEquals(3 * BLOCK_SIZE, in.skip(3 * BLOCK_SIZE));
+      assertEquals(Byte.toUnsignedInt(src[3 * BLOCK_SIZE]), in.read());
+      assertEquals(0, in.skip(-1));
+      assertEquals(src.length - 3 * BLOCK_SIZE - 1, in.skip(Long.MAX_VALUE));
+      assertEquals(-1, in.read());
+    }
+  }
+
+  @Test
+  public void testMarkReset() throws IOException {
+    try (QatSeekableInputStream in = open(Algorithm.DEFLATE)) {
+      assertTrue(in.markSupported());
+      in.skip(BLOCK_SIZE + 5);
+      in.mark(0);
+      byte[] first = in.readNBytes(2 * BLOCK_SIZE);
+      in.reset();
+      byte[] second = in.readNBytes(2 * BLOCK_SIZE);
+      assertArrayEquals(first, second);
+      assertArrayEquals(Arrays.copyOfRange(src, BLOCK_SIZE + 5, 3 * BLOCK_SIZE + 5), first);
+    }
+  }
+
+  @Test
+  public void testClosed() throws IOException {
+    QatSeekableInputStream in = open(Algorithm.DEFLATE);
+    in.close();
+    assertThrows(IOException.class, () -> in.read());
+    assertThrows(IOException.class, () -> in.seek(0));
+  }
+}
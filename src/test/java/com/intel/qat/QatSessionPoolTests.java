@@ -0,0 +1,150 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+import static org.junit.jupiter.api.Assertions.fail;
+
+import java.io.IOException;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.Arrays;
+import java.util.concurrent.TimeUnit;
+import java.util.stream.Stream;
+import org.junit.jupiter.api.AfterEach;
+import org.junit.jupiter.api.BeforeEach;
+import org.junit.jupiter.api.Test;
+import org.junit.jupiter.params.ParameterizedTest;
+import org.junit.jupiter.params.provider.Arguments;
+import org.junit.jupiter.params.provider.MethodSource;
+
+public class QatSessionPoolTests {
+  private static final String SAMPLE_TEXT_PATH = "src/test/resources/sample.txt";
+
+  public static Stream<Arguments> provideModeAlgorithmParams() {
+    return QatTestSuite.FORCE_HARDWARE
+        ? Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE),
+            Arguments.of(Mode.AUTO, Algorithm.LZ4),
+            Arguments.of(Mode.HARDWARE, Algorithm.DEFLATE),
+            Arguments.of(Mode.HARDWARE, Algorithm.LZ4))
+        : Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE), Arguments.of(Mode.AUTO, Algorithm.LZ4));
+  }
+
+  private static QatSessionPool.Key key(Algorithm algo, Mode mode) {
+    return new QatSessionPool.Key(
+        algo, QatZipper.DEFAULT_COMPRESS_LEVEL, mode, QatZipper.DEFAULT_POLLING_MODE);
+  }
+
+  private static QatZipper borrow(Algorithm algo, Mode mode) {
+    return QatZipper.fromPool(
+        algo, QatZipper.DEFAULT_COMPRESS_LEVEL, mode, QatZipper.DEFAULT_POLLING_MODE);
+  }
+
+  @BeforeEach
+  public void resetPool() {
+    QatSessionPool.configure(
+        QatSessionPool.DEFAULT_MIN_SIZE,
+        QatSessionPool.DEFAULT_MAX_SIZE,
+        QatSessionPool.DEFAULT_IDLE_TIMEOUT_MILLIS,
+        TimeUnit.MILLISECONDS);
+    QatSessionPool.clear();
+  }
+
+  @AfterEach
+  public void cleanupPool() {
+    resetPool();
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testPooledCompressDecompress(Mode mode, Algorithm algo) {
+    try {
+      byte[] src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+      for (int i = 0; i < 3; i++) {
+        QatZipper qzip = borrow(algo, mode);
+        byte[] dst = new byte[qzip.maxCompressedLength(src.length)];
+        byte[] dec = new byte[src.length];
+
+        int compressedSize = qzip.compress(src, dst);
+        int decompressedSize = qzip.decompress(dst, 0, compressedSize, dec, 0, dec.length);
+        qzip.end();
+
+        assertEquals(src.length, decompressedSize);
+        assertTrue(Arrays.equals(src, dec));
+      }
+    } catch (QatException | IOException e) {
+      fail(e.getMessage());
+    }
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testEndReturnsSession(Mode mode, Algorithm algo) {
+    QatZipper qzip = borrow(algo, mode);
+    assertEquals(0, QatSessionPool.idleCount(key(algo, mode)));
+    qzip.end();
+    assertEquals(1, QatSessionPool.idleCount(key(algo, mode)));
+
+    qzip = borrow(algo, mode);
+    assertEquals(0, QatSessionPool.idleCount(key(algo, mode)));
+    qzip.end();
+  }
+
+  @Test
+  public void testDuplicateEnd() {
+    QatZipper qzip = borrow(Algorithm.DEFLATE, Mode.AUTO);
+    qzip.end();
+    assertThrows(IllegalStateException.class, () -> qzip.end());
+    assertEquals(1, QatSessionPool.idleCount(key(Algorithm.DEFLATE, Mode.AUTO)));
+  }
+
+  @Test
+  public void testMaxSize() {
+    QatSessionPool.configure(0, 1, 0, TimeUnit.MILLISECONDS);
+    QatZipper first = borrow(Algorithm.DEFLATE, Mode.AUTO);
+    QatZipper second = borrow(Algorithm.DEFLATE, Mode.AUTO);
+    first.end();
+    second.end();
+    assertEquals(1, QatSessionPool.idleCount(key(Algorithm.DEFLATE, Mode.AUTO)));
+  }
+
+  @Test
+  public void testIdleEviction() throws InterruptedException {
+    QatSessionPool.configure(1, 4, 50, TimeUnit.MILLISECONDS);
+    QatZipper[] zippers = new QatZipper[3];
+    for (int i = 0; i < zippers.length; i++) zippers[i] = borrow(Algorithm.DEFLATE, Mode.AUTO);
+    for (QatZipper qzip : zippers) qzip.end();
+    assertEquals(3, QatSessionPool.idleCount(key(Algorithm.DEFLATE, Mode.AUTO)));
+
+    Thread.sleep(500);
+    assertEquals(1, QatSessionPool.idleCount(key(Algorithm.DEFLATE, Mode.AUTO)));
+  }
+
+  @Test
+  public void testInvalidConfiguration() {
+    assertThrows(
+        IllegalArgumentException.class,
+        () -> QatSessionPool.configure(2, 1, 0, TimeUnit.MILLISECONDS));
+    assertThrows(
+        IllegalArgumentException.class,
+        () -> QatSessionPool.configure(-1, 1, 0, TimeUnit.MILLISECONDS));
+  }
+
+  @Test
+  public void testInvalidCompressionLevel() {
+    assertThrows(
+        QatException.class,
+        () -> QatZipper.fromPool(Algorithm.DEFLATE, 15, Mode.AUTO, PollingMode.BUSY));
+  }
+}
@@ -0,0 +1,145 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertFalse;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+
+import java.io.IOException;
+import java.lang.management.ManagementFactory;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.Arrays;
+import java.util.stream.Stream;
+import javax.management.ObjectName;
+import org.junit.jupiter.api.AfterEach;
+import org.junit.jupiter.api.BeforeAll;
+import org.junit.jupiter.api.BeforeEach;
+import org.junit.jupiter.api.Test;
+import org.junit.jupiter.params.ParameterizedTest;
+import org.junit.jupiter.params.provider.Arguments;
+import org.junit.jupiter.params.provider.MethodSource;
+
+public class QatStatsTests {
+  private static final String SAMPLE_TEXT_PATH = "src/test/resources/sample.txt";
+  private static byte[] src;
+
+  private QatZipper qzip;
+
+  @BeforeAll
+  public static void setup() throws IOException {
+    src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+  }
+
+  public static Stream<Arguments> provideModeAlgorithmParams() {
+    return QatTestSuite.FORCE_HARDWARE
+        ? Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE),
+            Arguments.of(Mode.AUTO, Algorithm.LZ4),
+            Arguments.of(Mode.HARDWARE, Algorithm.DEFLATE),
+            Arguments.of(Mode.HARDWARE, Algorithm.LZ4))
+        : Stream.of(
+            Arguments.of(Mode.AUTO, Algorithm.DEFLATE), Arguments.of(Mode.AUTO, Algorithm.LZ4));
+  }
+
+  @BeforeEach
+  public void enableStats() {
+    QatStats.setEnabled(true);
+  }
+
+  @AfterEach
+  public void cleanup() {
+    QatStats.setEnabled(false);
+    if (qzip != null) qzip.end();
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testSessionCounters(Mode mode, Algorithm algo) {
+    qzip = new QatZipper(algo, mode);
+    byte[] compressed = new byte[qzip.maxCompressedLength(src.length)];
+    byte[] decompressed = new byte[src.length];
+    int compressedSize = qzip.compress(src, compressed);
+    qzip.decompress(compressed, 0, compressedSize, decompressed, 0, decompressed.length);
+
+    QatStats stats = qzip.getStats();
+    assertEquals(1, stats.getCompressCalls());
+    assertEquals(src.length, stats.getCompressBytesIn());
+    assertEquals(compressedSize, stats.getCompressBytesOut());
+    assertEquals(1, stats.getDecompressCalls());
+    assertEquals(compressedSize, stats.getDecompressBytesIn());
+    assertEquals(src.length, stats.getDecompressBytesOut());
+    assertEquals(2, stats.getHardwareCalls() + stats.getSoftwareCalls());
+    assertEquals(0, stats.getErrors());
+    assertTrue(stats.getErrorCounts().isEmpty());
+    assertEquals(2, Arrays.stream(stats.getLatencyHistogram()).sum());
+    assertTrue(stats.getLatencyPercentile(50) > 0);
+    assertTrue(stats.getLatencyPercentile(100) >= stats.getLatencyPercentile(50));
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testGlobalCounters(Mode mode, Algorithm algo) {
+    QatStats before = QatStats.global();
+    qzip = new QatZipper(algo, mode);
+    byte[] compressed = new byte[qzip.maxCompressedLength(src.length)];
+    qzip.compress(src, compressed);
+
+    QatStats after = QatStats.global();
+    assertTrue(after.getCompressCalls() >= before.getCompressCalls() + 1);
+    assertTrue(after.getCompressBytesIn() >= before.getCompressBytesIn() + src.length);
+  }
+
+  @Test
+  public void testDisabled() {
+    QatStats.setEnabled(false);
+    assertFalse(QatStats.isEnabled());
+
+    qzip = new QatZipper(Mode.AUTO);
+    qzip.compress(src, new byte[qzip.maxCompressedLength(src.length)]);
+    assertEquals(0, qzip.getStats().getCompressCalls());
+  }
+
+  @Test
+  public void testFailedCallCounted() {
+    qzip = new QatZipper(Mode.AUTO);
+    try {
+      qzip.compress(src, new byte[1]);
+    } catch (QatException e) {
+      QatStats stats = qzip.getStats();
+      assertEquals(1, stats.getCompressCalls());
+      assertEquals(1, stats.getErrors());
+      assertEquals(0, stats.getCompressBytesIn());
+    }
+  }
+
+  @Test
+  public void testStatsAfterEnd() {
+    QatZipper qzip = new QatZipper(Mode.AUTO);
+    qzip.end();
+    assertThrows(IllegalStateException.class, () -> qzip.getStats());
+  }
+
+  @Test
+  public void testInvalidPercentile() {
+    assertThrows(IllegalArgumentException.class, () -> QatStats.global().getLatencyPercentile(101));
+  }
+
+  @Test
+  public void testRegisterMBean() throws Exception {
+    QatStats.registerMBean();
+    QatStats.registerMBean();
+
+    ObjectName name = new ObjectName(QatStats.MBEAN_NAME);
+    assertTrue(ManagementFactory.getPlatformMBeanServer().isRegistered(name));
+    assertEquals(true, ManagementFactory.getPlatformMBeanServer().getAttribute(name, "Enabled"));
+  }
+}
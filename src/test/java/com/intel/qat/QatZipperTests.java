@@ -7,7 +7,9 @@
 package com.intel.qat;
 
 import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Format;
 import static com.intel.qat.QatZipper.Mode;
+import static com.intel.qat.QatZipper.PollingMode;
 import static org.junit.jupiter.api.Assertions.assertEquals;
 import static org.junit.jupiter.api.Assertions.assertNotNull;
 import static org.junit.jupiter.api.Assertions.assertTrue;
@@ -15,6 +17,7 @@ import static org.junit.jupiter.api.Assertions.fail;
 import static org.junit.jupiter.api.Assumptions.assumeFalse;
 import static org.junit.jupiter.api.Assumptions.assumeTrue;
 
+import java.io.ByteArrayInputStream;
 import java.io.IOException;
 import java.lang.ref.Cleaner;
 import java.nio.ByteBuffer;
@@ -22,15 +25,25 @@ import java.nio.ReadOnlyBufferException;
 import java.nio.charset.StandardCharsets;
 import java.nio.file.Files;
 import java.nio.file.Path;
+import java.util.ArrayList;
 import java.util.Arrays;
+import java.util.List;
 import java.util.Random;
+import java.util.concurrent.CompletableFuture;
+import java.util.concurrent.CompletionException;
+import java.util.concurrent.TimeUnit;
 import java.util.stream.Stream;
+import java.util.zip.CRC32;
+import java.util.zip.DataFormatException;
+import java.util.zip.GZIPInputStream;
+import java.util.zip.Inflater;
 import org.junit.jupiter.api.AfterEach;
 import org.junit.jupiter.api.Test;
 import org.junit.jupiter.params.ParameterizedTest;
 import org.junit.jupiter.params.provider.Arguments;
 import org.junit.jupiter.params.provider.EnumSource;
 import org.junit.jupiter.params.provider.MethodSource;
+import org.junit.jupiter.params.provider.ValueSource;
 
 public class QatZipperTests {
   private final String SAMPLE_TEXT_PATH = "src/test/resources/sample.txt";
@@ -206,6 +219,7 @@ public class QatZipperTests {
   @EnumSource(Algorithm.class)
   public void testSingleArgConstructorAlgo(Algorithm algo) {
     assumeTrue(QatTestSuite.FORCE_HARDWARE);
+    assumeTrue(QatZipper.isSupported(algo));
     try {
       qzip = new QatZipper(algo);
     } catch (IllegalArgumentException | QatException e) {
@@ -227,6 +241,7 @@ public class QatZipperTests {
   @EnumSource(Algorithm.class)
   public void testTwoArgConstructorAlgoAndLevel(Algorithm algo) {
     assumeTrue(QatTestSuite.FORCE_HARDWARE);
+    assumeTrue(QatZipper.isSupported(algo));
     try {
       qzip = new QatZipper(algo, 9);
     } catch (IllegalArgumentException | QatException e) {
@@ -1191,4 +1206,676 @@ public class QatZipperTests {
       assertTrue(true);
     }
   }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testCompressDecompressAsync(Mode mode, Algorithm algo) {
+    try {
+      qzip = new QatZipper(algo, mode);
+
+      final int n = 32;
+      byte[] src = readAllBytes(SAMPLE_TEXT_PATH);
+      List<ByteBuffer> dsts = new ArrayList<>();
+      List<CompletableFuture<Integer>> futures = new ArrayList<>();
+      for (int i = 0; i < n; i++) {
+        ByteBuffer dst = ByteBuffer.allocateDirect(qzip.maxCompressedLength(src.length));
+        dsts.add(dst);
+        futures.add(qzip.compressAsync(ByteBuffer.wrap(src), dst));
+      }
+      CompletableFuture.allOf(futures.toArray(new CompletableFuture[0])).join();
+
+      futures.clear();
+      List<ByteBuffer> decs = new ArrayList<>();
+      for (ByteBuffer dst : dsts) {
+        dst.flip();
+        ByteBuffer dec = ByteBuffer.allocate(src.length);
+        decs.add(dec);
+        futures.add(qzip.decompressAsync(dst, dec));
+      }
+
+      for (int i = 0; i < n; i++) {
+        assertEquals(src.length, futures.get(i).join());
+        assertTrue(Arrays.equals(src, decs.get(i).array()));
+      }
+    } catch (QatException | IOException e) {
+      fail(e.getMessage());
+    }
+  }
+
+  @Test
+  public void testCompressAsyncFailure() {
+    qzip = new QatZipper(Mode.AUTO);
+    CompletableFuture<Integer> future =
+        qzip.compressAsync(ByteBuffer.allocate(16), ByteBuffer.allocate(16).asReadOnlyBuffer());
+    try {
+      future.join();
+      fail();
+    } catch (CompletionException e) {
+      assertTrue(e.getCause() instanceof ReadOnlyBufferException);
+    }
+  }
+
+  @Test
+  public void testCompressAsyncAdaptive() {
+    qzip = new QatZipper(Format.GZIP, 6, Mode.AUTO);
+    qzip.setAdaptive(true);
+    byte[] src = getRandomBytes(64 * 1024);
+    ByteBuffer dst = ByteBuffer.allocate(qzip.maxCompressedLength(src.length));
+    // Incompressible data is stored, as it is by the QatZipper itself.
+    int compressedSize = qzip.compressAsync(ByteBuffer.wrap(src), dst).join();
+    assertEquals(QatAdaptive.storedLength(Format.GZIP, src.length), compressedSize);
+  }
+
+  @Test
+  public void testCompressAsyncPostTearDown() {
+    QatZipper qzip = new QatZipper(Mode.AUTO);
+    qzip.end();
+    try {
+      qzip.compressAsync(ByteBuffer.allocate(16), ByteBuffer.allocate(16));
+      fail();
+    } catch (IllegalStateException e) {
+      assertTrue(true);
+    }
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testCompressDecompressBatch(Mode mode, Algorithm algo) {
+    try {
+      qzip = new QatZipper(algo, mode);
+
+      final int n = 16;
+      ByteBuffer[] srcs = new ByteBuffer[n];
+      ByteBuffer[] dsts = new ByteBuffer[n];
+      ByteBuffer[] decs = new ByteBuffer[n];
+      int[] lens = new int[n];
+      for (int i = 0; i < n; i++) {
+        byte[] src = getRandomBytes(1024 * (i + 1));
+        int maxLen = qzip.maxCompressedLength(src.length);
+        srcs[i] = i % 2 == 0 ? ByteBuffer.wrap(src) : ByteBuffer.allocateDirect(src.length);
+        if (srcs[i].isDirect()) {
+          srcs[i].put(src);
+          srcs[i].flip();
+        }
+        dsts[i] = i % 3 == 0 ? ByteBuffer.allocate(maxLen) : ByteBuffer.allocateDirect(maxLen);
+        decs[i] = ByteBuffer.allocate(src.length);
+      }
+
+      qzip.compressBatch(srcs, dsts, lens);
+      for (int i = 0; i < n; i++) {
+        assertEquals(0, srcs[i].remaining());
+        assertEquals(lens[i], dsts[i].position());
+        dsts[i].flip();
+      }
+
+      qzip.decompressBatch(dsts, decs, lens);
+      for (int i = 0; i < n; i++) {
+        srcs[i].flip();
+        decs[i].flip();
+        assertEquals(srcs[i].remaining(), lens[i]);
+        assertTrue(srcs[i].equals(decs[i]));
+      }
+    } catch (QatException e) {
+      fail(e.getMessage());
+    }
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmParams")
+  public void testCompressBatchReadOnlySource(Mode mode, Algorithm algo) {
+    try {
+      qzip = new QatZipper(algo, mode);
+
+      byte[] src = readAllBytes(SAMPLE_TEXT_PATH);
+      ByteBuffer[] srcs = {ByteBuffer.wrap(src).asReadOnlyBuffer(), ByteBuffer.wrap(src)};
+      ByteBuffer[] dsts = {
+        ByteBuffer.allocate(qzip.maxCompressedLength(src.length)),
+        ByteBuffer.allocate(qzip.maxCompressedLength(src.length))
+      };
+      int[] lens = new int[2];
+
+      qzip.compressBatch(srcs, dsts, lens);
+      assertEquals(2 * src.length, qzip.getBytesRead());
+      assertEquals(lens[0] + lens[1], qzip.getBytesWritten());
+
+      byte[] dec = new byte[src.length];
+      qzip.decompress(dsts[0].array(), 0, lens[0], dec, 0, dec.length);
+      assertTrue(Arrays.equals(src, dec));
+    } catch (QatException | IOException e) {
+      fail(e.getMessage());
+    }
+  }
+
+  @Test
+  public void testCompressBatchMismatchedArrays() {
+    qzip = new QatZipper(Mode.AUTO);
+    try {
+      qzip.compressBatch(new ByteBuffer[2], new ByteBuffer[1], new int[2]);
+      fail();
+    } catch (IllegalArgumentException e) {
+      assertTrue(true);
+    }
+  }
+
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmLengthParams")
+  public void testReadOnlySlicedSourceDirectDestination(Mode mode, Algorithm algo, int len) {
+    try {
+      qzip = new QatZipper(algo, mode);
+
+      byte[] src = getRandomBytes(len);
+      byte[] padded = new byte[src.length + 64];
+      System.arraycopy(src, 0, padded, 17, src.length);
+
+      // A read-only view with a non-zero array offset and position.
+      ByteBuffer srcBuf = ByteBuffer.wrap(padded, 10, src.length + 7).slice().asReadOnlyBuffer();
+      srcBuf.position(7);
+      ByteBuffer dstBuf = ByteBuffer.allocateDirect(qzip.maxCompressedLength(src.length));
+      ByteBuffer decBuf = ByteBuffer.allocateDirect(src.length);
+
+      int compressedSize = qzip.compress(srcBuf, dstBuf);
+      assertEquals(srcBuf.limit(), srcBuf.position());
+      assertEquals(compressedSize, dstBuf.position());
+
+      dstBuf.flip();
+      ByteBuffer compressed = ByteBuffer.allocate(dstBuf.remaining());
+      compressed.put(dstBuf).flip();
+      int decompressedSize = qzip.decompress(compressed.asReadOnlyBuffer(), decBuf);
+      assertEquals(src.length, decompressedSize);
+
+      byte[] dec = new byte[src.length];
+      decBuf.flip().get(dec);
+      assertTrue(Arrays.equals(src, dec));
+    } catch (QatException | IllegalArgumentException e) {
+      fail(e.getMessage());
+    }
+  }
+
+  private static QatZipper softwareThresholdZipper(Algorithm algo, int threshold) {
+    return new QatZipper(
+        algo,
+        QatZipper.DEFAULT_COMPRESS_LEVEL,
+        Mode.AUTO,
+        QatZipper.DEFAULT_RETRY_COUNT,
+        QatZipper.DEFAULT_POLLING_MODE,
+        threshold,
+        null);
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Algorithm.class, names = {"DEFLATE", "LZ4"})
+  public void testSoftwareThreshold(Algorithm algo) {
+    qzip = softwareThresholdZipper(algo, 4096);
+    assertEquals(4096, qzip.getSoftwareThreshold());
+
+    // Output compressed in software below the threshold decompresses with any session.
+    QatZipper other = new QatZipper(algo, Mode.AUTO);
+    try {
+      byte[] sample = readAllBytes(SAMPLE_TEXT_PATH);
+      for (int len : new int[] {200, 4095, 4096, 65536}) {
+        byte[] src = Arrays.copyOf(sample, len);
+        byte[] compressed = new byte[qzip.maxCompressedLength(len)];
+        int compressedSize = qzip.compress(src, compressed);
+
+        byte[] dec = new byte[len];
+        int decompressedSize = other.decompress(compressed, 0, compressedSize, dec, 0, len);
+        assertEquals(len, decompressedSize);
+        assertTrue(Arrays.equals(src, dec));
+      }
+    } catch (IOException | QatException e) {
+      fail(e.getMessage());
+    } finally {
+      other.end();
+    }
+  }
+
+  @Test
+  public void testInvalidSoftwareThreshold() {
+    for (int threshold :
+        new int[] {0, QatZipper.MIN_SOFTWARE_THRESHOLD - 1, QatZipper.MAX_SOFTWARE_THRESHOLD + 1}) {
+      try {
+        softwareThresholdZipper(Algorithm.DEFLATE, threshold).end();
+        fail();
+      } catch (IllegalArgumentException e) {
+        assertTrue(true);
+      }
+    }
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Algorithm.class, names = {"DEFLATE", "LZ4"})
+  public void testAutoSoftwareThreshold(Algorithm algo) {
+    qzip = softwareThresholdZipper(algo, QatZipper.AUTO_SOFTWARE_THRESHOLD);
+    int threshold = qzip.getSoftwareThreshold();
+    assertTrue(threshold >= QatZipper.MIN_SOFTWARE_THRESHOLD);
+    assertTrue(threshold <= QatZipper.MAX_SOFTWARE_THRESHOLD);
+
+    // The calibration runs once per algorithm and level.
+    QatZipper again = softwareThresholdZipper(algo, QatZipper.AUTO_SOFTWARE_THRESHOLD);
+    assertEquals(threshold, again.getSoftwareThreshold());
+    again.end();
+  }
+
+  @ParameterizedTest
+  @MethodSource("provideModeAlgorithmLengthParams")
+  public void testChecksum(Mode mode, Algorithm algo, int len) {
+    try {
+      qzip = new QatZipper(algo, mode);
+      qzip.setChecksumEnabled(true);
+
+      byte[] src = getRandomBytes(len);
+      CRC32 crc = new CRC32();
+      crc.update(src);
+
+      byte[] compressed = new byte[qzip.maxCompressedLength(len)];
+      int compressedSize = qzip.compress(src, compressed);
+      assertEquals(crc.getValue(), qzip.getChecksum());
+
+      byte[] dec = new byte[len];
+      qzip.decompress(compressed, 0, compressedSize, dec, 0, len);
+      assertEquals(crc.getValue(), qzip.getChecksum());
+    } catch (QatException | IllegalArgumentException e) {
+      fail(e.getMessage());
+    }
+  }
+
+  @Test
+  public void testChecksumNotEnabled() {
+    qzip = new QatZipper(Mode.AUTO);
+    try {
+      qzip.getChecksum();
+      fail();
+    } catch (IllegalStateException e) {
+      assertTrue(true);
+    }
+  }
+
+  @ParameterizedTest
+  @ValueSource(ints = {100, 65536, 1 << 20})
+  public void testZstdRoundTrip(int len) {
+    assumeTrue(QatZipper.isSupported(Algorithm.ZSTD));
+    try {
+      qzip = new QatZipper(Algorithm.ZSTD, Mode.AUTO);
+      byte[] src = Arrays.copyOf(readAllBytes(SAMPLE_TEXT_PATH), len);
+      byte[] compressed = new byte[qzip.maxCompressedLength(len)];
+      int compressedSize = qzip.compress(src, compressed);
+      assertEquals(len, qzip.getBytesRead());
+
+      // A Zstandard frame starts with the magic number 0xFD2FB528.
+      assertEquals(0x28, compressed[0] & 0xFF);
+      assertEquals(0xFD, compressed[3] & 0xFF);
+
+      ByteBuffer srcBuf = ByteBuffer.wrap(compressed, 0, compressedSize);
+      ByteBuffer decBuf = ByteBuffer.allocateDirect(len);
+      assertEquals(len, qzip.decompress(srcBuf, decBuf));
+      assertEquals(compressedSize, srcBuf.position());
+
+      byte[] dec = new byte[len];
+      decBuf.flip().get(dec);
+      assertTrue(Arrays.equals(src, dec));
+    } catch (IOException | QatException | IllegalArgumentException e) {
+      fail(e.getMessage());
+    }
+  }
+
+  @Test
+  public void testZstdFrames() {
+    assumeTrue(QatZipper.isSupported(Algorithm.ZSTD));
+    qzip = new QatZipper(Algorithm.ZSTD, Mode.AUTO);
+    byte[] a = "first frame, first frame, first frame".getBytes(StandardCharsets.UTF_8);
+    byte[] b = "second frame, second frame".getBytes(StandardCharsets.UTF_8);
+
+    byte[] compressed = new byte[qzip.maxCompressedLength(a.length + b.length) * 2];
+    int sizeA = qzip.compress(a, 0, a.length, compressed, 0, compressed.length);
+    int sizeB = qzip.compress(b, 0, b.length, compressed, sizeA, compressed.length - sizeA);
+
+    // Both frames are decompressed by one call.
+    byte[] dec = new byte[a.length + b.length];
+    assertEquals(dec.length, qzip.decompress(compressed, 0, sizeA + sizeB, dec, 0, dec.length));
+    assertEquals(sizeA + sizeB, qzip.getBytesRead());
+
+    // An incomplete second frame is left unread.
+    assertEquals(a.length, qzip.decompress(compressed, 0, sizeA + sizeB - 1, dec, 0, dec.length));
+    assertEquals(sizeA, qzip.getBytesRead());
+  }
+
+  @Test
+  public void testZstdDictionary() {
+    try {
+      new QatZipper(
+          Algorithm.ZSTD,
+          QatZipper.DEFAULT_COMPRESS_LEVEL,
+          Mode.AUTO,
+          new QatDictionary(new byte[] {1, 2, 3}));
+      fail();
+    } catch (IllegalArgumentException e) {
+      assertTrue(true);
+    }
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Format.class, names = {"GZIP", "ZLIB", "RAW"})
+  public void testFormatInterop(Format format) {
+    try {
+      qzip = new QatZipper(format, QatZipper.DEFAULT_COMPRESS_LEVEL, Mode.AUTO);
+      assertEquals(format, qzip.getFormat());
+      byte[] src = readAllBytes(SAMPLE_TEXT_PATH);
+      byte[] compressed = new byte[qzip.maxCompressedLength(src.length)];
+      int compressedSize = qzip.compress(src, compressed);
+
+      // The JDK decoders read each format as is.
+      byte[] dec = new byte[src.length];
+      if (format == Format.GZIP) {
+        GZIPInputStream in =
+            new GZIPInputStream(new ByteArrayInputStream(compressed, 0, compressedSize));
+        assertEquals(src.length, in.readNBytes(dec, 0, dec.length));
+        assertEquals(-1, in.read());
+      } else {
+        Inflater inflater = new Inflater(format == Format.RAW);
+        inflater.setInput(compressed, 0, compressedSize);
+        assertEquals(src.length, inflater.inflate(dec));
+        assertTrue(inflater.finished());
+        inflater.end();
+      }
+      assertTrue(Arrays.equals(src, dec));
+
+      dec = new byte[src.length];
+      assertEquals(src.length, qzip.decompress(compressed, 0, compressedSize, dec, 0, dec.length));
+      assertEquals(compressedSize, qzip.getBytesRead());
+      assertTrue(Arrays.equals(src, dec));
+    } catch (IOException | QatException | DataFormatException e) {
+      fail(e.getMessage());
+    }
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Format.class, names = {"ZLIB", "RAW"})
+  public void testFormatWholeStreams(Format format) {
+    qzip = new QatZipper(format, QatZipper.DEFAULT_COMPRESS_LEVEL, Mode.AUTO);
+    byte[] a = "first stream, first stream, first stream".getBytes(StandardCharsets.UTF_8);
+    byte[] b = "second stream, second stream".getBytes(StandardCharsets.UTF_8);
+
+    byte[] compressed = new byte[qzip.maxCompressedLength(a.length + b.length) * 2];
+    int sizeA = qzip.compress(a, 0, a.length, compressed, 0, compressed.length);
+    int sizeB = qzip.compress(b, 0, b.length, compressed, sizeA, compressed.length - sizeA);
+
+    // Both streams are decompressed by one call.
+    byte[] dec = new byte[a.length + b.length];
+    assertEquals(dec.length, qzip.decompress(compressed, 0, sizeA + sizeB, dec, 0, dec.length));
+    assertEquals(sizeA + sizeB, qzip.getBytesRead());
+
+    // An incomplete second stream is left unread.
+    assertEquals(a.length, qzip.decompress(compressed, 0, sizeA + sizeB - 1, dec, 0, dec.length));
+    assertEquals(sizeA, qzip.getBytesRead());
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Format.class, names = {"GZIP", "ZLIB", "RAW"})
+  public void testFormatChecksum(Format format) {
+    qzip = new QatZipper(format, QatZipper.DEFAULT_COMPRESS_LEVEL, Mode.AUTO);
+    qzip.setChecksumEnabled(true);
+    byte[] src = getRandomBytes(4096);
+    CRC32 crc = new CRC32();
+    crc.update(src);
+
+    byte[] compressed = new byte[qzip.maxCompressedLength(src.length)];
+    int compressedSize = qzip.compress(src, compressed);
+    assertEquals(crc.getValue(), qzip.getChecksum());
+
+    byte[] dec = new byte[src.length];
+    qzip.decompress(compressed, 0, compressedSize, dec, 0, dec.length);
+    assertEquals(crc.getValue(), qzip.getChecksum());
+  }
+
+  @Test
+  public void testFormatRequiresDeflate() {
+    try {
+      new QatZipper(
+          Algorithm.LZ4,
+          QatZipper.DEFAULT_COMPRESS_LEVEL,
+          Mode.AUTO,
+          QatZipper.DEFAULT_RETRY_COUNT,
+          QatZipper.DEFAULT_POLLING_MODE,
+          QatZipper.DEFAULT_SOFTWARE_THRESHOLD,
+          Format.ZLIB,
+          null);
+      fail();
+    } catch (IllegalArgumentException e) {
+      assertTrue(true);
+    }
+  }
+
+  @Test
+  public void testErrorCode() {
+    try {
+      new QatZipper(Algorithm.DEFLATE, 100, Mode.AUTO);
+      fail();
+    } catch (QatException e) {
+      // QZ_PARAMS
+      assertEquals(-1, e.getErrorCode());
+    }
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Algorithm.class, names = {"DEFLATE", "LZ4"})
+  public void testAdaptivePolling(Algorithm algo) throws IOException {
+    qzip =
+        new QatZipper(
+            algo,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            Mode.AUTO,
+            QatZipper.DEFAULT_RETRY_COUNT,
+            PollingMode.ADAPTIVE);
+    assertEquals(QatZipper.DEFAULT_SPIN_BUDGET_NANOS, qzip.getSpinBudget(TimeUnit.NANOSECONDS));
+
+    // Small sources are busy polled and large ones polled periodically.
+    byte[] sample = readAllBytes(SAMPLE_TEXT_PATH);
+    for (byte[] src : new byte[][] {Arrays.copyOf(sample, 512), getRandomBytes(1 << 20), sample}) {
+      byte[] compressed = new byte[qzip.maxCompressedLength(src.length)];
+      int compressedSize = qzip.compress(src, 0, src.length, compressed, 0, compressed.length);
+      byte[] dec = new byte[src.length];
+      int decompressedSize = qzip.decompress(compressed, 0, compressedSize, dec, 0, dec.length);
+      assertEquals(src.length, decompressedSize);
+      assertTrue(Arrays.equals(src, dec));
+    }
+
+    qzip.setSpinBudget(0, TimeUnit.MICROSECONDS);
+    assertEquals(0, qzip.getSpinBudget(TimeUnit.NANOSECONDS));
+    byte[] compressed = new byte[qzip.maxCompressedLength(sample.length)];
+    int compressedSize = qzip.compress(sample, 0, sample.length, compressed, 0, compressed.length);
+    byte[] dec = new byte[sample.length];
+    qzip.decompress(compressed, 0, compressedSize, dec, 0, dec.length);
+    assertTrue(Arrays.equals(sample, dec));
+  }
+
+  @Test
+  public void testSpinBudget() {
+    qzip =
+        new QatZipper(
+            Algorithm.DEFLATE,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            Mode.AUTO,
+            QatZipper.DEFAULT_RETRY_COUNT,
+            PollingMode.ADAPTIVE);
+    qzip.setSpinBudget(2, TimeUnit.MILLISECONDS);
+    assertEquals(2000, qzip.getSpinBudget(TimeUnit.MICROSECONDS));
+    try {
+      qzip.setSpinBudget(-1, TimeUnit.MICROSECONDS);
+      fail();
+    } catch (IllegalArgumentException e) {
+      assertTrue(true);
+    }
+  }
+
+  @Test
+  public void testSpinBudgetRequiresAdaptive() {
+    qzip = new QatZipper(Algorithm.DEFLATE, Mode.AUTO);
+    try {
+      qzip.setSpinBudget(10, TimeUnit.MICROSECONDS);
+      fail();
+    } catch (IllegalStateException e) {
+      assertTrue(true);
+    }
+  }
+
+  @Test
+  public void testCompressAll() throws IOException {
+    byte[] src = readAllBytes(SAMPLE_TEXT_PATH);
+    QatZipper lz4 = new QatZipper(Algorithm.LZ4, Mode.AUTO);
+    QatZipper deflate = new QatZipper(Algorithm.DEFLATE, 9, Mode.AUTO);
+    try {
+      QatZipper[] zippers = {lz4, deflate};
+      byte[][] dsts = {
+        new byte[lz4.maxCompressedLength(src.length)],
+        new byte[deflate.maxCompressedLength(src.length)]
+      };
+      int[] sizes = QatZipper.compressAll(zippers, src, dsts);
+      for (int i = 0; i < zippers.length; i++) {
+        assertEquals(src.length, zippers[i].getBytesRead());
+        assertEquals(sizes[i], zippers[i].getBytesWritten());
+        byte[] dec = new byte[src.length];
+        assertEquals(src.length, zippers[i].decompress(dsts[i], 0, sizes[i], dec, 0, dec.length));
+        assertTrue(Arrays.equals(src, dec));
+      }
+    } finally {
+      lz4.end();
+      deflate.end();
+    }
+  }
+
+  @Test
+  public void testCompressAllByteBuffers() throws IOException {
+    byte[] bytes = readAllBytes(SAMPLE_TEXT_PATH);
+    QatZipper lz4 = new QatZipper(Algorithm.LZ4, Mode.AUTO);
+    QatZipper deflate = new QatZipper(Algorithm.DEFLATE, 1, Mode.AUTO);
+    try {
+      // A read-only heap source, a direct and a heap destination.
+      ByteBuffer src = ByteBuffer.wrap(bytes).asReadOnlyBuffer();
+      ByteBuffer[] dsts = {
+        ByteBuffer.allocateDirect(lz4.maxCompressedLength(bytes.length)),
+        ByteBuffer.allocate(deflate.maxCompressedLength(bytes.length))
+      };
+      int[] sizes = QatZipper.compressAll(new QatZipper[] {lz4, deflate}, src, dsts);
+      assertEquals(src.limit(), src.position());
+      assertEquals(sizes[0], dsts[0].position());
+      assertEquals(sizes[1], dsts[1].position());
+
+      dsts[0].flip();
+      ByteBuffer dec = ByteBuffer.allocate(bytes.length);
+      lz4.decompress(dsts[0], dec);
+      assertTrue(Arrays.equals(bytes, dec.array()));
+    } finally {
+      lz4.end();
+      deflate.end();
+    }
+  }
+
+  @Test
+  public void testCompressAllSameZipperTwice() {
+    qzip = new QatZipper(Algorithm.DEFLATE, Mode.AUTO);
+    byte[] src = new byte[] {1, 2, 3};
+    byte[][] dsts = {new byte[64], new byte[64]};
+    try {
+      QatZipper.compressAll(new QatZipper[] {qzip, qzip}, src, dsts);
+      fail();
+    } catch (IllegalArgumentException e) {
+      assertTrue(true);
+    }
+  }
+
+  @ParameterizedTest
+  @EnumSource(Format.class)
+  public void testAdaptiveIncompressible(Format format) {
+    qzip = new QatZipper(format, 6, Mode.AUTO);
+    qzip.setAdaptive(true);
+    assertTrue(qzip.isAdaptive());
+
+    byte[] src = getRandomBytes(200 * 1024);
+    byte[] dst = new byte[qzip.maxCompressedLength(src.length)];
+    byte[] dec = new byte[src.length];
+    // Enough requests to reach the ones stored without compressing them, and a probe.
+    for (int i = 0; i < 2 * QatAdaptive.PROBE_INTERVAL; i++) {
+      int compressedSize = qzip.compress(src, 0, src.length, dst, 0, dst.length);
+      assertEquals(src.length, qzip.getBytesRead());
+      assertTrue(compressedSize <= QatAdaptive.storedLength(format, src.length));
+
+      assertEquals(src.length, qzip.decompress(dst, 0, compressedSize, dec, 0, dec.length));
+      assertTrue(Arrays.equals(src, dec));
+    }
+  }
+
+  @Test
+  public void testAdaptiveCompressible() throws IOException {
+    qzip = new QatZipper(Algorithm.DEFLATE, 9, Mode.AUTO);
+    qzip.setAdaptive(true);
+
+    byte[] bytes = readAllBytes(SAMPLE_TEXT_PATH);
+    ByteBuffer src = ByteBuffer.allocateDirect(bytes.length);
+    src.put(bytes).flip();
+    ByteBuffer dst = ByteBuffer.allocateDirect(qzip.maxCompressedLength(bytes.length));
+    int compressedSize = qzip.compress(src, dst);
+    assertTrue(compressedSize < bytes.length);
+    assertEquals(compressedSize, dst.position());
+
+    dst.flip();
+    ByteBuffer dec = ByteBuffer.allocateDirect(bytes.length);
+    qzip.decompress(dst, dec);
+    dec.flip();
+    byte[] result = new byte[bytes.length];
+    dec.get(result);
+    assertTrue(Arrays.equals(bytes, result));
+  }
+
+  @Test
+  public void testAdaptiveResumesCompression() throws IOException {
+    qzip = new QatZipper(Algorithm.DEFLATE, Mode.AUTO);
+    qzip.setAdaptive(true);
+
+    byte[] random = getRandomBytes(64 * 1024);
+    byte[] dst = new byte[qzip.maxCompressedLength(random.length)];
+    for (int i = 0; i < 2 * QatAdaptive.INCOMPRESSIBLE_RUN; i++) qzip.compress(random, dst);
+
+    // Compressible data is compressed again by the next probe at the latest.
+    byte[] text = readAllBytes(SAMPLE_TEXT_PATH);
+    int compressedSize = 0;
+    for (int i = 0; i < QatAdaptive.PROBE_INTERVAL + 1; i++) {
+      compressedSize = qzip.compress(text, 0, text.length, dst, 0, dst.length);
+    }
+    assertTrue(compressedSize < text.length);
+
+    byte[] dec = new byte[text.length];
+    assertEquals(text.length, qzip.decompress(dst, 0, compressedSize, dec, 0, dec.length));
+    assertTrue(Arrays.equals(text, dec));
+  }
+
+  @Test
+  public void testAdaptiveSpinBudget() {
+    qzip = new QatZipper(Format.GZIP_EXT, 6, Mode.AUTO, PollingMode.ADAPTIVE);
+    qzip.setAdaptive(true);
+    qzip.setSpinBudget(0, TimeUnit.NANOSECONDS);
+
+    // Seven bits of entropy per byte: poorly compressible, so compressed at the fast level.
+    byte[] src = getRandomBytes(64 * 1024);
+    for (int i = 0; i < src.length; i++) src[i] &= 0x7f;
+    byte[] dst = new byte[qzip.maxCompressedLength(src.length)];
+    int compressedSize = qzip.compress(src, 0, src.length, dst, 0, dst.length);
+    assertEquals(src.length, qzip.getBytesRead());
+
+    byte[] dec = new byte[src.length];
+    assertEquals(src.length, qzip.decompress(dst, 0, compressedSize, dec, 0, dec.length));
+    assertTrue(Arrays.equals(src, dec));
+    assertEquals(0, qzip.getSpinBudget(TimeUnit.NANOSECONDS));
+  }
+
+  @Test
+  public void testAdaptiveRequiresDeflate() {
+    qzip = new QatZipper(Algorithm.LZ4, Mode.AUTO);
+    try {
+      qzip.setAdaptive(true);
+      fail();
+    } catch (IllegalStateException e) {
+      assertTrue(true);
+    }
+  }
 }
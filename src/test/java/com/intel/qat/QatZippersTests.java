@@ -0,0 +1,241 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static org.junit.jupiter.api.Assertions.assertArrayEquals;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertFalse;
+import static org.junit.jupiter.api.Assertions.assertNotNull;
+import static org.junit.jupiter.api.Assertions.assertNotSame;
+import static org.junit.jupiter.api.Assertions.assertNull;
+import static org.junit.jupiter.api.Assertions.assertSame;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+
+import java.io.IOException;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.TimeoutException;
+import java.util.concurrent.atomic.AtomicInteger;
+import org.junit.jupiter.api.AfterEach;
+import org.junit.jupiter.api.Test;
+import org.junit.jupiter.params.ParameterizedTest;
+import org.junit.jupiter.params.provider.EnumSource;
+
+public class QatZippersTests {
+  private static final String SAMPLE_TEXT_PATH = "src/test/resources/sample.txt";
+
+  @AfterEach
+  public void cleanup() {
+    QatZippers.setMaxSize(QatZippers.DEFAULT_MAX_SIZE);
+    QatZippers.clear();
+  }
+
+  private static QatZipper acquire() {
+    return QatZippers.acquire(
+        Algorithm.DEFLATE,
+        QatZipper.DEFAULT_COMPRESS_LEVEL,
+        Mode.AUTO,
+        QatZipper.DEFAULT_POLLING_MODE);
+  }
+
+  private static QatSessionPool.Key key() {
+    return new QatSessionPool.Key(
+        Algorithm.DEFLATE,
+        QatZipper.DEFAULT_COMPRESS_LEVEL,
+        Mode.AUTO,
+        QatZipper.DEFAULT_POLLING_MODE);
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Algorithm.class, names = {"DEFLATE", "LZ4"})
+  public void testWithZipper(Algorithm algo) throws IOException {
+    byte[] src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+    byte[] compressed =
+        QatZippers.withZipper(
+            algo,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            Mode.AUTO,
+            qzip -> {
+              byte[] dst = new byte[qzip.maxCompressedLength(src.length)];
+              int size = qzip.compress(src, dst);
+              byte[] out = new byte[size];
+              System.arraycopy(dst, 0, out, 0, size);
+              return out;
+            });
+    byte[] dec =
+        QatZippers.withZipper(
+            algo,
+            QatZipper.DEFAULT_COMPRESS_LEVEL,
+            Mode.AUTO,
+            qzip -> {
+              byte[] dst = new byte[src.length];
+              assertEquals(src.length, qzip.decompress(compressed, dst));
+              return dst;
+            });
+    assertArrayEquals(src, dec);
+  }
+
+  @Test
+  public void testReuse() {
+    QatZipper first = acquire();
+    QatZippers.release(first);
+    QatZipper second = acquire();
+    try {
+      assertSame(first, second);
+      assertEquals(1, QatZippers.size(key()));
+    } finally {
+      QatZippers.release(second);
+    }
+  }
+
+  @Test
+  public void testReset() {
+    QatZipper qzip = acquire();
+    qzip.setChecksumEnabled(true);
+    qzip.setRetryPolicy(new QatRetryPolicy(3, 1, 8, TimeUnit.MILLISECONDS));
+    QatZippers.release(qzip);
+
+    qzip = acquire();
+    try {
+      assertFalse(qzip.isChecksumEnabled());
+      assertNull(qzip.getRetryPolicy());
+    } finally {
+      QatZippers.release(qzip);
+    }
+  }
+
+  @Test
+  public void testReleaseTwice() {
+    QatZipper qzip = acquire();
+    QatZippers.release(qzip);
+    assertThrows(IllegalArgumentException.class, () -> QatZippers.release(qzip));
+  }
+
+  @Test
+  public void testReleaseNotAcquired() {
+    QatZipper qzip = new QatZipper(Algorithm.DEFLATE, Mode.AUTO);
+    try {
+      assertThrows(IllegalArgumentException.class, () -> QatZippers.release(qzip));
+    } finally {
+      qzip.end();
+    }
+  }
+
+  @Test
+  public void testReleaseEnded() {
+    QatZipper qzip = acquire();
+    qzip.end();
+    QatZippers.release(qzip);
+    assertEquals(0, QatZippers.size(key()));
+
+    QatZipper other = acquire();
+    try {
+      assertNotSame(qzip, other);
+    } finally {
+      QatZippers.release(other);
+    }
+  }
+
+  @Test
+  public void testWaitsAtMaxSize() throws Exception {
+    QatZippers.setMaxSize(1);
+    QatZipper qzip = acquire();
+    ExecutorService executor = Executors.newSingleThreadExecutor();
+    try {
+      CountDownLatch started = new CountDownLatch(1);
+      Future<QatZipper> waiter =
+          executor.submit(
+              () -> {
+                started.countDown();
+                return acquire();
+              });
+      started.await();
+      Thread.sleep(50);
+      assertFalse(waiter.isDone());
+
+      QatZippers.release(qzip);
+      QatZipper other = waiter.get(10, TimeUnit.SECONDS);
+      assertSame(qzip, other);
+      QatZippers.release(other);
+    } finally {
+      executor.shutdownNow();
+    }
+  }
+
+  @Test
+  public void testBoundedByMaxSize() throws Exception {
+    QatZippers.setMaxSize(2);
+    int threads = 16;
+    ExecutorService executor = Executors.newFixedThreadPool(threads);
+    AtomicInteger inUse = new AtomicInteger();
+    AtomicInteger maxInUse = new AtomicInteger();
+    try {
+      List<Future<?>> futures = new ArrayList<>();
+      for (int t = 0; t < threads; t++) {
+        futures.add(
+            executor.submit(
+                () -> {
+                  for (int i = 0; i < 50; i++) {
+                    QatZipper qzip = acquire();
+                    maxInUse.accumulateAndGet(inUse.incrementAndGet(), Math::max);
+                    inUse.decrementAndGet();
+                    QatZippers.release(qzip);
+                  }
+                }));
+      }
+      for (Future<?> f : futures) f.get(60, TimeUnit.SECONDS);
+    } finally {
+      executor.shutdownNow();
+    }
+    assertTrue(maxInUse.get() <= 2, "in use: " + maxInUse.get());
+    assertTrue(QatZippers.size(key()) <= 2);
+  }
+
+  @Test
+  public void testLeakedZipperIsReclaimed() throws Exception {
+    QatZippers.setMaxSize(1);
+    leak();
+    ExecutorService executor = Executors.newSingleThreadExecutor();
+    try {
+      Future<QatZipper> waiter = executor.submit(QatZippersTests::acquire);
+      QatZipper qzip = null;
+      for (int i = 0; i < 100 && qzip == null; i++) {
+        System.gc();
+        try {
+          qzip = waiter.get(100, TimeUnit.MILLISECONDS);
+        } catch (TimeoutException e) {
+          // Not collected yet.
+        }
+      }
+      assertNotNull(qzip);
+      QatZippers.release(qzip);
+      assertEquals(1, QatZippers.size(key()));
+    } finally {
+      executor.shutdownNow();
+    }
+  }
+
+  // Acquires a zipper and drops it without releasing it.
+  private static void leak() {
+    acquire();
+  }
+
+  @Test
+  public void testInvalidMaxSize() {
+    assertThrows(IllegalArgumentException.class, () -> QatZippers.setMaxSize(0));
+  }
+}
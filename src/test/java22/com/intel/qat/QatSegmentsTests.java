@@ -0,0 +1,130 @@
+/*******************************************************************************
+ * Copyright (C) 2023 Intel Corporation
+ *
+ * SPDX-License-Identifier: BSD
+ ******************************************************************************/
+
+package com.intel.qat;
+
+import static com.intel.qat.QatZipper.Algorithm;
+import static com.intel.qat.QatZipper.Mode;
+import static org.junit.jupiter.api.Assertions.assertArrayEquals;
+import static org.junit.jupiter.api.Assertions.assertEquals;
+import static org.junit.jupiter.api.Assertions.assertThrows;
+import static org.junit.jupiter.api.Assertions.assertTrue;
+
+import java.io.IOException;
+import java.lang.foreign.Arena;
+import java.lang.foreign.MemorySegment;
+import java.lang.foreign.ValueLayout;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.Arrays;
+import java.util.Random;
+import org.junit.jupiter.api.AfterEach;
+import org.junit.jupiter.api.Test;
+import org.junit.jupiter.params.ParameterizedTest;
+import org.junit.jupiter.params.provider.EnumSource;
+
+public class QatSegmentsTests {
+  private static final String SAMPLE_TEXT_PATH = "src/test/resources/sample.txt";
+
+  private QatZipper qzip;
+
+  @AfterEach
+  public void cleanupSession() {
+    if (qzip != null) qzip.end();
+  }
+
+  @Test
+  public void testAvailable() {
+    assertTrue(QatSegments.isAvailable());
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Algorithm.class, names = {"DEFLATE", "LZ4"})
+  public void testNativeSegments(Algorithm algo) throws IOException {
+    qzip = new QatZipper(algo, Mode.AUTO);
+    byte[] src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+    try (Arena arena = Arena.ofConfined()) {
+      MemorySegment in = arena.allocate(src.length);
+      in.copyFrom(MemorySegment.ofArray(src));
+      MemorySegment compressed = arena.allocate(qzip.maxCompressedLength(src.length));
+      int compressedSize = QatSegments.compress(qzip, in, compressed);
+      assertEquals(src.length, qzip.getBytesRead());
+      assertEquals(compressedSize, qzip.getBytesWritten());
+
+      MemorySegment dec = arena.allocate(src.length);
+      int decompressedSize =
+          QatSegments.decompress(qzip, compressed.asSlice(0, compressedSize), dec);
+      assertEquals(src.length, decompressedSize);
+      assertEquals(compressedSize, qzip.getBytesRead());
+      assertArrayEquals(src, dec.toArray(ValueLayout.JAVA_BYTE));
+    }
+  }
+
+  @ParameterizedTest
+  @EnumSource(value = Algorithm.class, names = {"DEFLATE", "LZ4"})
+  public void testHeapSegments(Algorithm algo) throws IOException {
+    qzip = new QatZipper(algo, Mode.AUTO);
+    byte[] src = Files.readAllBytes(Paths.get(SAMPLE_TEXT_PATH));
+    byte[] compressed = new byte[qzip.maxCompressedLength(src.length)];
+    int compressedSize =
+        QatSegments.compress(qzip, MemorySegment.ofArray(src), MemorySegment.ofArray(compressed));
+
+    byte[] dec = new byte[src.length];
+    int decompressedSize =
+        QatSegments.decompress(
+            qzip,
+            MemorySegment.ofArray(compressed).asSlice(0, compressedSize),
+            MemorySegment.ofArray(dec));
+    assertEquals(src.length, decompressedSize);
+    assertArrayEquals(src, dec);
+  }
+
+  @Test
+  public void testLargerThanScratch() {
+    qzip = new QatZipper(Algorithm.DEFLATE, Mode.AUTO);
+    byte[] src = new byte[(int) QatForeign.MAX_SCRATCH_SIZE];
+    new Random(7).nextBytes(src);
+    Arrays.fill(src, 0, src.length / 2, (byte) 'a');
+    byte[] compressed = new byte[qzip.maxCompressedLength(src.length)];
+    int compressedSize =
+        QatSegments.compress(qzip, MemorySegment.ofArray(src), MemorySegment.ofArray(compressed));
+
+    byte[] dec = new byte[src.length];
+    QatSegments.decompress(
+        qzip,
+        MemorySegment.ofArray(compressed).asSlice(0, compressedSize),
+        MemorySegment.ofArray(dec));
+    assertArrayEquals(src, dec);
+  }
+
+  @Test
+  public void testReadOnlyDestination() {
+    qzip = new QatZipper(Algorithm.DEFLATE, Mode.AUTO);
+    MemorySegment src = MemorySegment.ofArray(new byte[1024]);
+    MemorySegment dst = MemorySegment.ofArray(new byte[4096]).asReadOnly();
+    assertThrows(IllegalArgumentException.class, () -> QatSegments.compress(qzip, src, dst));
+    assertThrows(IllegalArgumentException.class, () -> QatSegments.decompress(qzip, src, dst));
+  }
+
+  @Test
+  public void testEmptySegment() {
+    qzip = new QatZipper(Algorithm.DEFLATE, Mode.AUTO);
+    MemorySegment src = MemorySegment.ofArray(new byte[0]);
+    MemorySegment dst = MemorySegment.ofArray(new byte[4096]);
+    assertThrows(IllegalArgumentException.class, () -> QatSegments.compress(qzip, src, dst));
+  }
+
+  @Test
+  public void testLargerThan2GB() {
+    qzip = new QatZipper(Algorithm.DEFLATE, Mode.AUTO);
+    // The size is checked before the segment is read, so it needs no backing memory.
+    MemorySegment huge = MemorySegment.NULL.reinterpret(Integer.MAX_VALUE + 1L);
+    MemorySegment small = MemorySegment.ofArray(new byte[4096]);
+    assertThrows(IllegalArgumentException.class, () -> QatSegments.compress(qzip, huge, small));
+    assertThrows(IllegalArgumentException.class, () -> QatSegments.compress(qzip, small, huge));
+    assertThrows(IllegalArgumentException.class, () -> QatSegments.decompress(qzip, huge, small));
+  }
+}